@@ -0,0 +1,186 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef DATASKETCHES_BENCHMARK_HPP_
+#define DATASKETCHES_BENCHMARK_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace datasketches {
+namespace benchmarks {
+
+/**
+ * Minimal timing harness.
+ * Each benchmark is run once to warm up and then a given number of times.
+ * The fastest run is reported since it is the least affected by noise from the rest of the system.
+ * Inputs are generated from fixed seeds so that results are comparable between builds.
+ */
+class runner {
+public:
+  runner(const std::string& filter, unsigned repetitions):
+  filter_(filter), repetitions_(repetitions), sink_(0)
+  {
+    std::cout << std::left << std::setw(56) << "benchmark" << std::right
+        << std::setw(14) << "ns/op" << std::setw(14) << "Mops/s" << std::setw(14) << "MB/s" << std::endl;
+  }
+
+  /**
+   * @param name of a benchmark
+   * @return true if the name contains the filter given on the command line
+   */
+  bool enabled(const std::string& name) const {
+    return name.find(filter_) != std::string::npos;
+  }
+
+  /**
+   * @param names of benchmarks
+   * @return true if any of the names contains the filter given on the command line
+   */
+  bool enabled(std::initializer_list<std::string> names) const {
+    return std::any_of(names.begin(), names.end(), [this](const std::string& name) { return enabled(name); });
+  }
+
+  /**
+   * Times a benchmark.
+   * @param name of the benchmark
+   * @param num_ops number of operations performed by one run, used to report ns/op
+   * @param num_bytes number of bytes processed by one run, used to report MB/s (0 if not applicable)
+   * @param run function that performs one run and returns a value derived from its result
+   */
+  template<typename Run>
+  void run(const std::string& name, uint64_t num_ops, uint64_t num_bytes, Run&& run) {
+    if (!enabled(name)) return;
+    consume(run());
+    double best_ns = 0;
+    for (unsigned i = 0; i < repetitions_; ++i) {
+      const auto start = std::chrono::steady_clock::now();
+      consume(run());
+      const auto finish = std::chrono::steady_clock::now();
+      const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count());
+      best_ns = (i == 0) ? ns : std::min(best_ns, ns);
+    }
+    std::cout << std::left << std::setw(56) << name << std::right << std::fixed << std::setprecision(2)
+        << std::setw(14) << best_ns / num_ops
+        << std::setw(14) << num_ops * 1e3 / best_ns;
+    if (num_bytes > 0) {
+      std::cout << std::setw(14) << num_bytes * 1e3 / best_ns;
+    } else {
+      std::cout << std::setw(14) << "-";
+    }
+    std::cout << std::endl;
+  }
+
+private:
+  std::string filter_;
+  unsigned repetitions_;
+  volatile double sink_;
+
+  // keeps the compiler from discarding the work of a run
+  void consume(double value) { sink_ = sink_ + value; }
+};
+
+/**
+ * Input data generated on first use.
+ * Benchmarks that are not selected by the filter never call get(), so they do not pay for generating it.
+ */
+template<typename T>
+class lazy_input {
+public:
+  explicit lazy_input(std::function<T()> make): make_(std::move(make)), made_(false) {}
+
+  const T& get() {
+    if (!made_) {
+      value_ = make_();
+      made_ = true;
+    }
+    return value_;
+  }
+
+private:
+  std::function<T()> make_;
+  T value_;
+  bool made_;
+};
+
+static const uint64_t INPUT_SEED = 12345;
+
+/**
+ * @param num_items number of items
+ * @param seed for the generator
+ * @return uniformly distributed 64-bit keys
+ */
+inline std::vector<uint64_t> random_keys(size_t num_items, uint64_t seed = INPUT_SEED) {
+  std::mt19937_64 gen(seed);
+  std::vector<uint64_t> keys(num_items);
+  for (auto& key: keys) key = gen();
+  return keys;
+}
+
+/**
+ * @param num_items number of items
+ * @param seed for the generator
+ * @return normally distributed values
+ */
+inline std::vector<double> random_values(size_t num_items, uint64_t seed = INPUT_SEED) {
+  std::mt19937_64 gen(seed);
+  std::normal_distribution<double> dist(0, 1);
+  std::vector<double> values(num_items);
+  for (auto& value: values) value = dist(gen);
+  return values;
+}
+
+// number of items per update benchmark
+static const size_t NUM_UPDATES = 1 << 20;
+// number of sketches per merge benchmark
+static const size_t NUM_SKETCHES = 64;
+// number of items in each sketch to merge
+static const size_t ITEMS_PER_SKETCH = 1 << 14;
+// number of round trips per serialization benchmark
+static const size_t NUM_ROUND_TRIPS = 100;
+// number of queries per query benchmark
+static const size_t NUM_QUERIES = 10000;
+
+void run_theta_benchmarks(runner& r);
+void run_tuple_benchmarks(runner& r);
+void run_hll_benchmarks(runner& r);
+void run_cpc_benchmarks(runner& r);
+void run_kll_benchmarks(runner& r);
+void run_quantiles_benchmarks(runner& r);
+void run_req_benchmarks(runner& r);
+void run_tdigest_benchmarks(runner& r);
+void run_fi_benchmarks(runner& r);
+void run_var_opt_benchmarks(runner& r);
+void run_ebpps_benchmarks(runner& r);
+void run_bloom_filter_benchmarks(runner& r);
+void run_count_min_benchmarks(runner& r);
+
+} /* namespace benchmarks */
+} /* namespace datasketches */
+
+#endif
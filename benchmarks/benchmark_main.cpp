@@ -0,0 +1,61 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <string>
+
+#include "benchmark.hpp"
+
+using namespace datasketches::benchmarks;
+
+/*
+ * Usage: datasketches_benchmarks [filter] [repetitions]
+ * Only benchmarks with names containing the filter are run (all by default).
+ * Each benchmark is timed the given number of times (5 by default) and the fastest run is reported.
+ */
+int main(int argc, char** argv) {
+  const std::string filter = argc > 1 ? argv[1] : "";
+  long repetitions = 5;
+  if (argc > 2) {
+    char* end = nullptr;
+    errno = 0;
+    repetitions = std::strtol(argv[2], &end, 10);
+    if (end == argv[2] || *end != '\0' || errno == ERANGE || repetitions <= 0 || static_cast<unsigned long>(repetitions) > UINT_MAX) {
+      std::cerr << "repetitions must be a positive integer: " << argv[2] << std::endl;
+      return 1;
+    }
+  }
+  runner r(filter, static_cast<unsigned>(repetitions));
+  run_theta_benchmarks(r);
+  run_tuple_benchmarks(r);
+  run_hll_benchmarks(r);
+  run_cpc_benchmarks(r);
+  run_kll_benchmarks(r);
+  run_quantiles_benchmarks(r);
+  run_req_benchmarks(r);
+  run_tdigest_benchmarks(r);
+  run_fi_benchmarks(r);
+  run_var_opt_benchmarks(r);
+  run_ebpps_benchmarks(r);
+  run_bloom_filter_benchmarks(r);
+  run_count_min_benchmarks(r);
+  return 0;
+}
@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <bloom_filter.hpp>
+
+#include "benchmark.hpp"
+
+namespace datasketches {
+namespace benchmarks {
+
+static const uint64_t BLOOM_FILTER_SEED = 42;
+
+void run_bloom_filter_benchmarks(runner& r) {
+  lazy_input<std::vector<uint64_t>> lazy_keys([]() { return random_keys(NUM_UPDATES); });
+
+  for (double fpp: {0.01, 0.001, 0.1}) {
+    const std::string name = "fpp=" + std::to_string(fpp).substr(0, 5);
+    r.run("bloom_filter update " + name, NUM_UPDATES, 0, [&]() {
+      const auto& keys = lazy_keys.get();
+      auto filter = bloom_filter::builder::create_by_accuracy(NUM_UPDATES, fpp, BLOOM_FILTER_SEED);
+      for (auto key: keys) filter.update(key);
+      return static_cast<double>(filter.get_bits_used());
+    });
+  }
+
+  const double fpp = 0.01;
+  const std::string name = "fpp=" + std::to_string(fpp).substr(0, 5);
+  if (!r.enabled({"bloom_filter union_with " + name, "bloom_filter serialize " + name, "bloom_filter deserialize " + name,
+      "bloom_filter wrap " + name, "bloom_filter query " + name})) return;
+  std::vector<bloom_filter> filters;
+  const auto merge_keys = random_keys(NUM_SKETCHES * ITEMS_PER_SKETCH);
+  for (size_t i = 0; i < NUM_SKETCHES; ++i) {
+    auto filter = bloom_filter::builder::create_by_accuracy(NUM_SKETCHES * ITEMS_PER_SKETCH, fpp, BLOOM_FILTER_SEED);
+    for (size_t j = 0; j < ITEMS_PER_SKETCH; ++j) filter.update(merge_keys[i * ITEMS_PER_SKETCH + j]);
+    filters.push_back(filter);
+  }
+  r.run("bloom_filter union_with " + name, NUM_SKETCHES, 0, [&]() {
+    auto merged = bloom_filter::builder::create_by_accuracy(NUM_SKETCHES * ITEMS_PER_SKETCH, fpp, BLOOM_FILTER_SEED);
+    for (const auto& filter: filters) merged.union_with(filter);
+    return static_cast<double>(merged.get_bits_used());
+  });
+
+  const auto& filter = filters.front();
+  const auto bytes = filter.serialize();
+  r.run("bloom_filter serialize " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    size_t size = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) size += filter.serialize().size();
+    return static_cast<double>(size);
+  });
+  r.run("bloom_filter deserialize " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    double sum = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) sum += bloom_filter::deserialize(bytes.data(), bytes.size()).get_capacity();
+    return sum;
+  });
+  r.run("bloom_filter wrap " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    double sum = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) sum += bloom_filter::wrap(bytes.data(), bytes.size()).get_capacity();
+    return sum;
+  });
+
+  r.run("bloom_filter query " + name, NUM_QUERIES, 0, [&]() {
+    const auto& keys = lazy_keys.get();
+    double sum = 0;
+    for (size_t i = 0; i < NUM_QUERIES; ++i) sum += filter.query(keys[i]);
+    return sum;
+  });
+}
+
+} /* namespace benchmarks */
+} /* namespace datasketches */
@@ -0,0 +1,83 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <count_min.hpp>
+
+#include "benchmark.hpp"
+
+namespace datasketches {
+namespace benchmarks {
+
+using count_min = count_min_sketch<uint64_t>;
+
+void run_count_min_benchmarks(runner& r) {
+  lazy_input<std::vector<uint64_t>> lazy_keys([]() { return random_keys(NUM_UPDATES); });
+
+  for (double relative_error: {0.001, 0.0001, 0.01}) {
+    const uint32_t num_buckets = count_min::suggest_num_buckets(relative_error);
+    const uint8_t num_hashes = count_min::suggest_num_hashes(0.95);
+    r.run("count_min update buckets=" + std::to_string(num_buckets), NUM_UPDATES, 0, [&]() {
+      const auto& keys = lazy_keys.get();
+      count_min sketch(num_hashes, num_buckets);
+      for (auto key: keys) sketch.update(key);
+      return static_cast<double>(sketch.get_total_weight());
+    });
+  }
+
+  const uint32_t num_buckets = count_min::suggest_num_buckets(0.001);
+  const uint8_t num_hashes = count_min::suggest_num_hashes(0.95);
+  const std::string name = "buckets=" + std::to_string(num_buckets);
+  if (!r.enabled({"count_min merge " + name, "count_min serialize " + name, "count_min deserialize " + name,
+      "count_min get_estimate " + name})) return;
+  std::vector<count_min> sketches;
+  const auto merge_keys = random_keys(NUM_SKETCHES * ITEMS_PER_SKETCH);
+  for (size_t i = 0; i < NUM_SKETCHES; ++i) {
+    count_min sketch(num_hashes, num_buckets);
+    for (size_t j = 0; j < ITEMS_PER_SKETCH; ++j) sketch.update(merge_keys[i * ITEMS_PER_SKETCH + j]);
+    sketches.push_back(sketch);
+  }
+  r.run("count_min merge " + name, NUM_SKETCHES, 0, [&]() {
+    count_min merged(num_hashes, num_buckets);
+    for (const auto& sketch: sketches) merged.merge(sketch);
+    return static_cast<double>(merged.get_total_weight());
+  });
+
+  const auto& sketch = sketches.front();
+  const auto bytes = sketch.serialize();
+  r.run("count_min serialize " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    size_t size = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) size += sketch.serialize().size();
+    return static_cast<double>(size);
+  });
+  r.run("count_min deserialize " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    double sum = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) sum += count_min::deserialize(bytes.data(), bytes.size()).get_total_weight();
+    return sum;
+  });
+
+  r.run("count_min get_estimate " + name, NUM_QUERIES, 0, [&]() {
+    const auto& keys = lazy_keys.get();
+    double sum = 0;
+    for (size_t i = 0; i < NUM_QUERIES; ++i) sum += sketch.get_estimate(keys[i]);
+    return sum;
+  });
+}
+
+} /* namespace benchmarks */
+} /* namespace datasketches */
@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cpc_sketch.hpp>
+#include <cpc_union.hpp>
+
+#include "benchmark.hpp"
+
+namespace datasketches {
+namespace benchmarks {
+
+void run_cpc_benchmarks(runner& r) {
+  lazy_input<std::vector<uint64_t>> lazy_keys([]() { return random_keys(NUM_UPDATES); });
+
+  for (uint8_t lg_k: {10, 12, 16}) {
+    const std::string k = "lg_k=" + std::to_string(lg_k);
+    r.run("cpc update " + k, NUM_UPDATES, 0, [&]() {
+      const auto& keys = lazy_keys.get();
+      cpc_sketch sketch(lg_k);
+      for (auto key: keys) sketch.update(key);
+      return sketch.get_estimate();
+    });
+    r.run("cpc update_batch " + k, NUM_UPDATES, 0, [&]() {
+      const auto& keys = lazy_keys.get();
+      cpc_sketch sketch(lg_k);
+      sketch.update_batch(keys.data(), keys.size());
+      return sketch.get_estimate();
+    });
+  }
+
+  const uint8_t lg_k = 12;
+  const std::string name = "lg_k=" + std::to_string(lg_k);
+  if (!r.enabled({"cpc union " + name, "cpc serialize " + name, "cpc deserialize " + name,
+      "cpc get_estimate and bounds " + name})) return;
+  std::vector<cpc_sketch> sketches;
+  const auto merge_keys = random_keys(NUM_SKETCHES * ITEMS_PER_SKETCH);
+  for (size_t i = 0; i < NUM_SKETCHES; ++i) {
+    cpc_sketch sketch(lg_k);
+    sketch.update_batch(merge_keys.data() + i * ITEMS_PER_SKETCH, ITEMS_PER_SKETCH);
+    sketches.push_back(sketch);
+  }
+  r.run("cpc union " + name, NUM_SKETCHES, 0, [&]() {
+    cpc_union u(lg_k);
+    for (const auto& sketch: sketches) u.update(sketch);
+    return u.get_result().get_estimate();
+  });
+
+  const auto& sketch = sketches.front();
+  const auto bytes = sketch.serialize();
+  r.run("cpc serialize " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    size_t size = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) size += sketch.serialize().size();
+    return static_cast<double>(size);
+  });
+  r.run("cpc deserialize " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    double sum = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) sum += cpc_sketch::deserialize(bytes.data(), bytes.size()).get_estimate();
+    return sum;
+  });
+  r.run("cpc get_estimate and bounds " + name, NUM_QUERIES, 0, [&]() {
+    double sum = 0;
+    for (size_t i = 0; i < NUM_QUERIES; ++i) {
+      sum += sketch.get_estimate() + sketch.get_lower_bound(2) + sketch.get_upper_bound(2);
+    }
+    return sum;
+  });
+}
+
+} /* namespace benchmarks */
+} /* namespace datasketches */
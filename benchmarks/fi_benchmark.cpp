@@ -0,0 +1,90 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <frequent_items_sketch.hpp>
+
+#include "benchmark.hpp"
+
+namespace datasketches {
+namespace benchmarks {
+
+using fi_sketch = frequent_items_sketch<uint64_t>;
+
+// roughly geometric distribution so that there are heavy hitters
+static std::vector<uint64_t> skewed_items(size_t num_items, uint64_t seed = INPUT_SEED) {
+  auto items = random_keys(num_items, seed);
+  for (auto& item: items) item >>= item & 63;
+  return items;
+}
+
+void run_fi_benchmarks(runner& r) {
+  lazy_input<std::vector<uint64_t>> lazy_items([]() { return skewed_items(NUM_UPDATES); });
+
+  for (uint8_t lg_max_map_size: {10, 12, 16}) {
+    r.run("fi update lg_max_map_size=" + std::to_string(lg_max_map_size), NUM_UPDATES, 0, [&]() {
+      const auto& items = lazy_items.get();
+      fi_sketch sketch(lg_max_map_size);
+      for (auto item: items) sketch.update(item);
+      return static_cast<double>(sketch.get_total_weight());
+    });
+  }
+
+  const uint8_t lg_max_map_size = 12;
+  const std::string name = "lg_max_map_size=" + std::to_string(lg_max_map_size);
+  if (!r.enabled({"fi merge " + name, "fi serialize " + name, "fi deserialize " + name,
+      "fi get_estimate " + name, "fi get_frequent_items " + name})) return;
+  std::vector<fi_sketch> sketches;
+  const auto merge_items = skewed_items(NUM_SKETCHES * ITEMS_PER_SKETCH);
+  for (size_t i = 0; i < NUM_SKETCHES; ++i) {
+    fi_sketch sketch(lg_max_map_size);
+    for (size_t j = 0; j < ITEMS_PER_SKETCH; ++j) sketch.update(merge_items[i * ITEMS_PER_SKETCH + j]);
+    sketches.push_back(sketch);
+  }
+  r.run("fi merge " + name, NUM_SKETCHES, 0, [&]() {
+    fi_sketch merged(lg_max_map_size);
+    for (const auto& sketch: sketches) merged.merge(sketch);
+    return static_cast<double>(merged.get_total_weight());
+  });
+
+  const auto& sketch = sketches.front();
+  const auto bytes = sketch.serialize();
+  r.run("fi serialize " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    size_t size = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) size += sketch.serialize().size();
+    return static_cast<double>(size);
+  });
+  r.run("fi deserialize " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    double sum = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) sum += fi_sketch::deserialize(bytes.data(), bytes.size()).get_total_weight();
+    return sum;
+  });
+
+  r.run("fi get_estimate " + name, NUM_QUERIES, 0, [&]() {
+    const auto& items = lazy_items.get();
+    double sum = 0;
+    for (size_t i = 0; i < NUM_QUERIES; ++i) sum += sketch.get_estimate(items[i]);
+    return sum;
+  });
+  r.run("fi get_frequent_items " + name, 1, 0, [&]() {
+    return static_cast<double>(sketch.get_frequent_items(frequent_items_error_type::NO_FALSE_POSITIVES).size());
+  });
+}
+
+} /* namespace benchmarks */
+} /* namespace datasketches */
@@ -0,0 +1,102 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <hll.hpp>
+
+#include "benchmark.hpp"
+
+namespace datasketches {
+namespace benchmarks {
+
+static const char* hll_type_name(target_hll_type type) {
+  switch (type) {
+    case HLL_4: return "HLL_4";
+    case HLL_6: return "HLL_6";
+    default: return "HLL_8";
+  }
+}
+
+void run_hll_benchmarks(runner& r) {
+  lazy_input<std::vector<uint64_t>> lazy_keys([]() { return random_keys(NUM_UPDATES); });
+
+  for (auto type: {HLL_4, HLL_6, HLL_8}) {
+    for (uint8_t lg_k: {10, 12, 16}) {
+      const std::string name = std::string(hll_type_name(type)) + " lg_k=" + std::to_string(lg_k);
+      r.run("hll update " + name, NUM_UPDATES, 0, [&]() {
+        const auto& keys = lazy_keys.get();
+        hll_sketch sketch(lg_k, type);
+        for (auto key: keys) sketch.update(key);
+        return sketch.get_estimate();
+      });
+      r.run("hll update_batch " + name, NUM_UPDATES, 0, [&]() {
+        const auto& keys = lazy_keys.get();
+        hll_sketch sketch(lg_k, type);
+        sketch.update_batch(keys.data(), keys.size());
+        return sketch.get_estimate();
+      });
+    }
+  }
+
+  const uint8_t lg_k = 12;
+  const std::string name_k = " lg_k=" + std::to_string(lg_k);
+  bool enabled = r.enabled("hll union HLL_8" + name_k);
+  for (auto type: {HLL_4, HLL_6, HLL_8}) {
+    const std::string name = std::string(hll_type_name(type)) + name_k;
+    enabled = enabled || r.enabled({"hll serialize " + name, "hll deserialize " + name, "hll get_estimate and bounds " + name});
+  }
+  if (!enabled) return;
+  std::vector<hll_sketch> sketches;
+  const auto merge_keys = random_keys(NUM_SKETCHES * ITEMS_PER_SKETCH);
+  for (size_t i = 0; i < NUM_SKETCHES; ++i) {
+    hll_sketch sketch(lg_k, HLL_8);
+    sketch.update_batch(merge_keys.data() + i * ITEMS_PER_SKETCH, ITEMS_PER_SKETCH);
+    sketches.push_back(sketch);
+  }
+  r.run("hll union HLL_8" + name_k, NUM_SKETCHES, 0, [&]() {
+    hll_union u(lg_k);
+    for (const auto& sketch: sketches) u.update(sketch);
+    return u.get_result(HLL_8).get_estimate();
+  });
+
+  for (auto type: {HLL_4, HLL_6, HLL_8}) {
+    const hll_sketch sketch(sketches.front(), type);
+    const std::string name = std::string(hll_type_name(type)) + name_k;
+    const auto bytes = sketch.serialize_compact();
+    r.run("hll serialize " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+      size_t size = 0;
+      for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) size += sketch.serialize_compact().size();
+      return static_cast<double>(size);
+    });
+    r.run("hll deserialize " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+      double sum = 0;
+      for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) sum += hll_sketch::deserialize(bytes.data(), bytes.size()).get_estimate();
+      return sum;
+    });
+    r.run("hll get_estimate and bounds " + name, NUM_QUERIES, 0, [&]() {
+      double sum = 0;
+      for (size_t i = 0; i < NUM_QUERIES; ++i) {
+        sum += sketch.get_estimate() + sketch.get_lower_bound(2) + sketch.get_upper_bound(2);
+      }
+      return sum;
+    });
+  }
+}
+
+} /* namespace benchmarks */
+} /* namespace datasketches */
@@ -0,0 +1,96 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef QUANTILE_SKETCH_BENCHMARK_HPP_
+#define QUANTILE_SKETCH_BENCHMARK_HPP_
+
+#include <initializer_list>
+
+#include "benchmark.hpp"
+
+namespace datasketches {
+namespace benchmarks {
+
+/**
+ * Benchmarks shared by the quantile sketches with the common API (kll, quantiles, req).
+ * @param r runner
+ * @param family name of the sketch family
+ * @param ks values of k to benchmark updates with, the first one is used for the rest
+ */
+template<typename Sketch>
+void run_quantile_sketch_benchmarks(runner& r, const std::string& family, std::initializer_list<uint16_t> ks) {
+  lazy_input<std::vector<double>> lazy_values([]() { return random_values(NUM_UPDATES); });
+
+  for (uint16_t k: ks) {
+    r.run(family + " update k=" + std::to_string(k), NUM_UPDATES, 0, [&]() {
+      const auto& values = lazy_values.get();
+      Sketch sketch(k);
+      for (auto value: values) sketch.update(value);
+      return sketch.get_quantile(0.5);
+    });
+  }
+
+  const uint16_t k = *ks.begin();
+  const std::string name_k = " k=" + std::to_string(k);
+  if (!r.enabled({family + " merge" + name_k, family + " serialize" + name_k, family + " deserialize" + name_k,
+      family + " get_quantile" + name_k, family + " get_rank" + name_k})) return;
+  std::vector<Sketch> sketches;
+  const auto merge_values = random_values(NUM_SKETCHES * ITEMS_PER_SKETCH);
+  for (size_t i = 0; i < NUM_SKETCHES; ++i) {
+    Sketch sketch(k);
+    for (size_t j = 0; j < ITEMS_PER_SKETCH; ++j) sketch.update(merge_values[i * ITEMS_PER_SKETCH + j]);
+    sketches.push_back(sketch);
+  }
+  r.run(family + " merge" + name_k, NUM_SKETCHES, 0, [&]() {
+    Sketch merged(k);
+    for (const auto& sketch: sketches) merged.merge(sketch);
+    return merged.get_quantile(0.5);
+  });
+
+  const auto& sketch = sketches.front();
+  const auto bytes = sketch.serialize();
+  r.run(family + " serialize" + name_k, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    size_t size = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) size += sketch.serialize().size();
+    return static_cast<double>(size);
+  });
+  r.run(family + " deserialize" + name_k, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    double sum = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) sum += Sketch::deserialize(bytes.data(), bytes.size()).get_n();
+    return sum;
+  });
+
+  // the first query builds the sorted view, which is then reused
+  r.run(family + " get_quantile" + name_k, NUM_QUERIES, 0, [&]() {
+    double sum = 0;
+    for (size_t i = 0; i < NUM_QUERIES; ++i) sum += sketch.get_quantile(static_cast<double>(i) / NUM_QUERIES);
+    return sum;
+  });
+  r.run(family + " get_rank" + name_k, NUM_QUERIES, 0, [&]() {
+    const auto& values = lazy_values.get();
+    double sum = 0;
+    for (size_t i = 0; i < NUM_QUERIES; ++i) sum += sketch.get_rank(values[i]);
+    return sum;
+  });
+}
+
+} /* namespace benchmarks */
+} /* namespace datasketches */
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <tdigest.hpp>
+
+#include "benchmark.hpp"
+
+namespace datasketches {
+namespace benchmarks {
+
+void run_tdigest_benchmarks(runner& r) {
+  lazy_input<std::vector<double>> lazy_values([]() { return random_values(NUM_UPDATES); });
+
+  for (uint16_t k: {100, 50, 200}) {
+    r.run("tdigest update k=" + std::to_string(k), NUM_UPDATES, 0, [&]() {
+      const auto& values = lazy_values.get();
+      tdigest_double td(k);
+      for (auto value: values) td.update(value);
+      return td.get_quantile(0.5);
+    });
+  }
+
+  const uint16_t k = 100;
+  const std::string name = "k=" + std::to_string(k);
+  if (!r.enabled({"tdigest merge " + name, "tdigest serialize " + name, "tdigest deserialize " + name, "tdigest get_quantile " + name,
+      "tdigest get_rank " + name})) return;
+  std::vector<tdigest_double> digests;
+  const auto merge_values = random_values(NUM_SKETCHES * ITEMS_PER_SKETCH);
+  for (size_t i = 0; i < NUM_SKETCHES; ++i) {
+    tdigest_double td(k);
+    for (size_t j = 0; j < ITEMS_PER_SKETCH; ++j) td.update(merge_values[i * ITEMS_PER_SKETCH + j]);
+    td.compress();
+    digests.push_back(td);
+  }
+  r.run("tdigest merge " + name, NUM_SKETCHES, 0, [&]() {
+    tdigest_double merged(k);
+    for (const auto& td: digests) merged.merge(td);
+    return merged.get_quantile(0.5);
+  });
+
+  const auto& td = digests.front();
+  const auto bytes = td.serialize();
+  r.run("tdigest serialize " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    size_t size = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) size += td.serialize().size();
+    return static_cast<double>(size);
+  });
+  r.run("tdigest deserialize " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    double sum = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) sum += tdigest_double::deserialize(bytes.data(), bytes.size()).get_total_weight();
+    return sum;
+  });
+
+  r.run("tdigest get_quantile " + name, NUM_QUERIES, 0, [&]() {
+    double sum = 0;
+    for (size_t i = 0; i < NUM_QUERIES; ++i) sum += td.get_quantile(static_cast<double>(i) / NUM_QUERIES);
+    return sum;
+  });
+  r.run("tdigest get_rank " + name, NUM_QUERIES, 0, [&]() {
+    const auto& values = lazy_values.get();
+    double sum = 0;
+    for (size_t i = 0; i < NUM_QUERIES; ++i) sum += td.get_rank(values[i]);
+    return sum;
+  });
+}
+
+} /* namespace benchmarks */
+} /* namespace datasketches */
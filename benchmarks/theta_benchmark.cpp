@@ -0,0 +1,124 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <sstream>
+
+#include <theta_sketch.hpp>
+#include <theta_union.hpp>
+#include <theta_intersection.hpp>
+#include <theta_jaccard_similarity.hpp>
+
+#include "benchmark.hpp"
+
+namespace datasketches {
+namespace benchmarks {
+
+// sketches share half of their items, so that intersections and similarities are not trivially empty
+static std::vector<compact_theta_sketch> make_theta_sketches(uint8_t lg_k) {
+  std::vector<compact_theta_sketch> sketches;
+  const size_t num_common = ITEMS_PER_SKETCH / 2;
+  const size_t num_distinct = ITEMS_PER_SKETCH - num_common;
+  const auto keys = random_keys(num_common + NUM_SKETCHES * num_distinct);
+  for (size_t i = 0; i < NUM_SKETCHES; ++i) {
+    auto sketch = update_theta_sketch::builder().set_lg_k(lg_k).build();
+    sketch.update_batch(keys.data(), num_common);
+    sketch.update_batch(keys.data() + num_common + i * num_distinct, num_distinct);
+    sketches.push_back(sketch.compact());
+  }
+  return sketches;
+}
+
+void run_theta_benchmarks(runner& r) {
+  lazy_input<std::vector<uint64_t>> lazy_keys([]() { return random_keys(NUM_UPDATES); });
+
+  for (uint8_t lg_k: {10, 12, 16}) {
+    const std::string k = "lg_k=" + std::to_string(lg_k);
+    r.run("theta update " + k, NUM_UPDATES, 0, [&]() {
+      const auto& keys = lazy_keys.get();
+      auto sketch = update_theta_sketch::builder().set_lg_k(lg_k).build();
+      for (auto key: keys) sketch.update(key);
+      return sketch.get_estimate();
+    });
+    r.run("theta update_batch " + k, NUM_UPDATES, 0, [&]() {
+      const auto& keys = lazy_keys.get();
+      auto sketch = update_theta_sketch::builder().set_lg_k(lg_k).build();
+      sketch.update_batch(keys.data(), keys.size());
+      return sketch.get_estimate();
+    });
+  }
+
+  const uint8_t lg_k = 12;
+  const std::string name = "lg_k=" + std::to_string(lg_k);
+  if (!r.enabled({"theta union " + name, "theta intersection " + name, "theta serialize " + name, "theta deserialize " + name,
+      "theta serialize_compressed " + name, "theta deserialize compressed " + name, "theta get_estimate and bounds " + name,
+      "theta jaccard " + name})) return;
+  const auto sketches = make_theta_sketches(lg_k);
+  r.run("theta union " + name, NUM_SKETCHES, 0, [&]() {
+    auto u = theta_union::builder().set_lg_k(lg_k).build();
+    for (const auto& sketch: sketches) u.update(sketch);
+    return u.get_result().get_estimate();
+  });
+  r.run("theta intersection " + name, NUM_SKETCHES, 0, [&]() {
+    theta_intersection intersection;
+    for (const auto& sketch: sketches) intersection.update(sketch);
+    return intersection.get_result().get_estimate();
+  });
+
+  const auto& sketch = sketches.front();
+  const auto bytes = sketch.serialize();
+  const auto compressed_bytes = sketch.serialize_compressed();
+  r.run("theta serialize " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    size_t size = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) size += sketch.serialize().size();
+    return static_cast<double>(size);
+  });
+  r.run("theta deserialize " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    double sum = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) sum += compact_theta_sketch::deserialize(bytes.data(), bytes.size()).get_estimate();
+    return sum;
+  });
+  r.run("theta serialize_compressed " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * compressed_bytes.size(), [&]() {
+    size_t size = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) size += sketch.serialize_compressed().size();
+    return static_cast<double>(size);
+  });
+  r.run("theta deserialize compressed " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * compressed_bytes.size(), [&]() {
+    double sum = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) {
+      sum += compact_theta_sketch::deserialize(compressed_bytes.data(), compressed_bytes.size()).get_estimate();
+    }
+    return sum;
+  });
+
+  r.run("theta get_estimate and bounds " + name, NUM_QUERIES, 0, [&]() {
+    double sum = 0;
+    for (size_t i = 0; i < NUM_QUERIES; ++i) {
+      sum += sketch.get_estimate() + sketch.get_lower_bound(2) + sketch.get_upper_bound(2);
+    }
+    return sum;
+  });
+  r.run("theta jaccard " + name, NUM_SKETCHES - 1, 0, [&]() {
+    double sum = 0;
+    for (size_t i = 1; i < NUM_SKETCHES; ++i) sum += theta_jaccard_similarity::jaccard(sketches[0], sketches[i])[1];
+    return sum;
+  });
+}
+
+} /* namespace benchmarks */
+} /* namespace datasketches */
@@ -0,0 +1,97 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <tuple_sketch.hpp>
+#include <tuple_union.hpp>
+#include <array_of_doubles_sketch.hpp>
+
+#include "benchmark.hpp"
+
+namespace datasketches {
+namespace benchmarks {
+
+void run_tuple_benchmarks(runner& r) {
+  lazy_input<std::vector<uint64_t>> lazy_keys([]() { return random_keys(NUM_UPDATES); });
+  lazy_input<std::vector<double>> lazy_values([]() { return random_values(NUM_UPDATES); });
+
+  for (uint8_t lg_k: {10, 12, 16}) {
+    const std::string k = "lg_k=" + std::to_string(lg_k);
+    r.run("tuple update double " + k, NUM_UPDATES, 0, [&]() {
+      const auto& keys = lazy_keys.get();
+      const auto& values = lazy_values.get();
+      auto sketch = update_tuple_sketch<double>::builder().set_lg_k(lg_k).build();
+      for (size_t i = 0; i < keys.size(); ++i) sketch.update(keys[i], values[i]);
+      return sketch.get_estimate();
+    });
+    r.run("tuple update array_of_doubles(3) " + k, NUM_UPDATES, 0, [&]() {
+      const auto& keys = lazy_keys.get();
+      const auto& values = lazy_values.get();
+      auto sketch = update_array_of_doubles_sketch::builder(3).set_lg_k(lg_k).build();
+      std::vector<double> update(3);
+      for (size_t i = 0; i < keys.size(); ++i) {
+        update[0] = update[1] = update[2] = values[i];
+        sketch.update(keys[i], update);
+      }
+      return sketch.get_estimate();
+    });
+  }
+
+  const uint8_t lg_k = 12;
+  const std::string name = "lg_k=" + std::to_string(lg_k);
+  if (!r.enabled({"tuple union " + name, "tuple serialize " + name, "tuple deserialize " + name,
+      "tuple get_estimate and bounds " + name})) return;
+  std::vector<compact_tuple_sketch<double>> sketches;
+  const auto merge_keys = random_keys(NUM_SKETCHES * ITEMS_PER_SKETCH);
+  for (size_t i = 0; i < NUM_SKETCHES; ++i) {
+    auto sketch = update_tuple_sketch<double>::builder().set_lg_k(lg_k).build();
+    for (size_t j = 0; j < ITEMS_PER_SKETCH; ++j) sketch.update(merge_keys[i * ITEMS_PER_SKETCH + j], 1.0);
+    sketches.push_back(sketch.compact());
+  }
+  r.run("tuple union " + name, NUM_SKETCHES, 0, [&]() {
+    auto u = tuple_union<double>::builder().set_lg_k(lg_k).build();
+    for (const auto& sketch: sketches) u.update(sketch);
+    return u.get_result().get_estimate();
+  });
+
+  const auto& sketch = sketches.front();
+  const auto bytes = sketch.serialize();
+  r.run("tuple serialize " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    size_t size = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) size += sketch.serialize().size();
+    return static_cast<double>(size);
+  });
+  r.run("tuple deserialize " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    double sum = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) {
+      sum += compact_tuple_sketch<double>::deserialize(bytes.data(), bytes.size()).get_estimate();
+    }
+    return sum;
+  });
+
+  r.run("tuple get_estimate and bounds " + name, NUM_QUERIES, 0, [&]() {
+    double sum = 0;
+    for (size_t i = 0; i < NUM_QUERIES; ++i) {
+      sum += sketch.get_estimate() + sketch.get_lower_bound(2) + sketch.get_upper_bound(2);
+    }
+    return sum;
+  });
+}
+
+} /* namespace benchmarks */
+} /* namespace datasketches */
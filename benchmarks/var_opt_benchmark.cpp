@@ -0,0 +1,87 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cmath>
+
+#include <var_opt_sketch.hpp>
+#include <var_opt_union.hpp>
+
+#include "benchmark.hpp"
+
+namespace datasketches {
+namespace benchmarks {
+
+using var_opt = var_opt_sketch<uint64_t>;
+
+void run_var_opt_benchmarks(runner& r) {
+  lazy_input<std::vector<uint64_t>> lazy_items([]() { return random_keys(NUM_UPDATES); });
+  lazy_input<std::vector<double>> lazy_weights([]() { return random_values(NUM_UPDATES); });
+
+  for (uint32_t k: {1024, 256, 4096}) {
+    r.run("var_opt update k=" + std::to_string(k), NUM_UPDATES, 0, [&]() {
+      const auto& items = lazy_items.get();
+      const auto& weights = lazy_weights.get();
+      var_opt sketch(k);
+      for (size_t i = 0; i < items.size(); ++i) sketch.update(items[i], 1 + std::fabs(weights[i]));
+      return static_cast<double>(sketch.get_num_samples());
+    });
+  }
+
+  const uint32_t k = 1024;
+  const std::string name = "k=" + std::to_string(k);
+  if (!r.enabled({"var_opt union " + name, "var_opt serialize " + name, "var_opt deserialize " + name,
+      "var_opt estimate_subset_sum " + name})) return;
+  std::vector<var_opt> sketches;
+  const auto merge_items = random_keys(NUM_SKETCHES * ITEMS_PER_SKETCH);
+  const auto& weights = lazy_weights.get();
+  for (size_t i = 0; i < NUM_SKETCHES; ++i) {
+    var_opt sketch(k);
+    for (size_t j = 0; j < ITEMS_PER_SKETCH; ++j) sketch.update(merge_items[i * ITEMS_PER_SKETCH + j], 1 + std::fabs(weights[j]));
+    sketches.push_back(sketch);
+  }
+  r.run("var_opt union " + name, NUM_SKETCHES, 0, [&]() {
+    var_opt_union<uint64_t> u(k);
+    for (const auto& sketch: sketches) u.update(sketch);
+    return static_cast<double>(u.get_result().get_num_samples());
+  });
+
+  const auto& sketch = sketches.front();
+  const auto bytes = sketch.serialize();
+  r.run("var_opt serialize " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    size_t size = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) size += sketch.serialize().size();
+    return static_cast<double>(size);
+  });
+  r.run("var_opt deserialize " + name, NUM_ROUND_TRIPS, NUM_ROUND_TRIPS * bytes.size(), [&]() {
+    double sum = 0;
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) sum += var_opt::deserialize(bytes.data(), bytes.size()).get_num_samples();
+    return sum;
+  });
+
+  r.run("var_opt estimate_subset_sum " + name, NUM_QUERIES / 100, 0, [&]() {
+    double sum = 0;
+    for (size_t i = 0; i < NUM_QUERIES / 100; ++i) {
+      sum += sketch.estimate_subset_sum([i](const uint64_t& item) { return item % 100 == i; }).estimate;
+    }
+    return sum;
+  });
+}
+
+} /* namespace benchmarks */
+} /* namespace datasketches */
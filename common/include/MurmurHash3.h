@@ -166,6 +166,46 @@ MURMUR3_FORCE_INLINE void MurmurHash3_x64_128(const void* key, size_t lenBytes,
   out.h2 += out.h1;
 }
 
+//-----------------------------------------------------------------------------
+// Specialization for a single 8-byte key, such as a 64-bit integer.
+// Produces the same result as MurmurHash3_x64_128(key, 8, seed, out):
+// there is no 16-byte block, the key is the tail and only goes into h1.
+
+MURMUR3_FORCE_INLINE void MurmurHash3_x64_128_8(const void* key, uint64_t seed, HashState& out) {
+  static const uint64_t c1 = MURMUR3_BIG_CONSTANT(0x87c37b91114253d5);
+  static const uint64_t c2 = MURMUR3_BIG_CONSTANT(0x4cf5ad432745937f);
+
+  const uint8_t* tail = (const uint8_t*)key;
+  uint64_t k1 =
+      ((uint64_t)tail[7]) << 56 | ((uint64_t)tail[6]) << 48 | ((uint64_t)tail[5]) << 40 | ((uint64_t)tail[4]) << 32 |
+      ((uint64_t)tail[3]) << 24 | ((uint64_t)tail[2]) << 16 | ((uint64_t)tail[1]) << 8 | ((uint64_t)tail[0]);
+  k1 *= c1; k1  = MURMUR3_ROTL64(k1,31); k1 *= c2;
+
+  out.h1 = (seed ^ k1) ^ sizeof(uint64_t);
+  out.h2 = seed ^ sizeof(uint64_t);
+
+  out.h1 += out.h2;
+  out.h2 += out.h1;
+
+  out.h1 = fmix64(out.h1);
+  out.h2 = fmix64(out.h2);
+
+  out.h1 += out.h2;
+  out.h2 += out.h1;
+}
+
+//-----------------------------------------------------------------------------
+// Hashes an array of 8-byte keys, same as calling MurmurHash3_x64_128(&keys[i], 8, seed, out[i]) for each key.
+// The length dispatch and the block loop are gone and the keys are independent of each other,
+// so the compiler can interleave or vectorize the multiply chains of consecutive keys.
+
+MURMUR3_FORCE_INLINE void MurmurHash3_x64_128_batch(const uint64_t* keys, size_t num_keys,
+                                                    uint64_t seed, HashState* out) {
+  for (size_t i = 0; i < num_keys; ++i) {
+    MurmurHash3_x64_128_8(&keys[i], seed, out[i]);
+  }
+}
+
 //-----------------------------------------------------------------------------
 
 MURMUR3_FORCE_INLINE uint16_t compute_seed_hash(uint64_t seed) {
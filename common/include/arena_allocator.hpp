@@ -0,0 +1,178 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ARENA_ALLOCATOR_HPP_
+#define ARENA_ALLOCATOR_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+
+namespace datasketches {
+
+/**
+ * Monotonic memory arena.
+ * Memory is handed out by bumping a pointer in large chunks obtained from the global operator new.
+ * Individual deallocations are ignored. All memory is returned at once by release() or by the destructor.
+ * This suits building and discarding many short-lived sketches: there is one system allocation per chunk
+ * instead of one per internal buffer, and nothing to free one by one.
+ * Memory released by growing containers is not reused until release(), so the arena should be sized
+ * for the whole lifetime of the sketches that use it.
+ * Not thread-safe. The intended use is one arena per thread or per query.
+ * The arena must outlive all allocators and sketches that use it.
+ */
+class memory_arena {
+public:
+  static const size_t DEFAULT_CHUNK_SIZE = 1 << 16;
+
+  /**
+   * Constructor
+   * @param chunk_size size in bytes of the chunks requested from the system
+   */
+  explicit memory_arena(size_t chunk_size = DEFAULT_CHUNK_SIZE):
+  chunk_size_(chunk_size), chunks_(nullptr), current_(nullptr), end_(nullptr), bytes_allocated_(0)
+  {
+    if (chunk_size == 0) throw std::invalid_argument("chunk size must be positive");
+  }
+
+  memory_arena(const memory_arena&) = delete;
+  memory_arena& operator=(const memory_arena&) = delete;
+
+  ~memory_arena() { release(); }
+
+  /**
+   * Allocates a block of memory
+   * @param size in bytes
+   * @param alignment of the block (must be a power of 2)
+   * @return pointer to the block
+   */
+  void* allocate(size_t size, size_t alignment) {
+    uintptr_t ptr = align(reinterpret_cast<uintptr_t>(current_), alignment);
+    const uintptr_t end = reinterpret_cast<uintptr_t>(end_);
+    if (current_ == nullptr || ptr > end || size > static_cast<size_t>(end - ptr)) {
+      if (size > static_cast<size_t>(-1) - alignment) throw std::bad_alloc();
+      add_chunk(size + alignment);
+      ptr = align(reinterpret_cast<uintptr_t>(current_), alignment);
+    }
+    current_ = reinterpret_cast<char*>(ptr + size);
+    bytes_allocated_ += size;
+    return reinterpret_cast<void*>(ptr);
+  }
+
+  /**
+   * Returns all memory to the system.
+   * Everything allocated from this arena becomes invalid.
+   */
+  void release() {
+    while (chunks_ != nullptr) {
+      chunk_header* next = chunks_->next;
+      ::operator delete(chunks_);
+      chunks_ = next;
+    }
+    current_ = nullptr;
+    end_ = nullptr;
+    bytes_allocated_ = 0;
+  }
+
+  /**
+   * @return number of bytes handed out since construction or the last release()
+   */
+  size_t get_bytes_allocated() const { return bytes_allocated_; }
+
+private:
+  struct chunk_header {
+    chunk_header* next;
+    alignas(std::max_align_t) char data[1];
+  };
+
+  size_t chunk_size_;
+  chunk_header* chunks_;
+  char* current_;
+  char* end_;
+  size_t bytes_allocated_;
+
+  static uintptr_t align(uintptr_t ptr, size_t alignment) {
+    return (ptr + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+  }
+
+  // requests that are larger than the chunk size get a chunk of their own
+  void add_chunk(size_t min_size) {
+    const size_t size = min_size > chunk_size_ ? min_size : chunk_size_;
+    if (size > static_cast<size_t>(-1) - offsetof(chunk_header, data)) throw std::bad_alloc();
+    chunk_header* chunk = static_cast<chunk_header*>(::operator new(offsetof(chunk_header, data) + size));
+    chunk->next = chunks_;
+    chunks_ = chunk;
+    current_ = chunk->data;
+    end_ = chunk->data + size;
+  }
+};
+
+/**
+ * Allocator that takes memory from a memory_arena.
+ * It can be used as the Allocator parameter of any sketch.
+ * An instance must be passed explicitly since there is no default constructor.
+ * Copies and rebound copies share the arena and compare equal.
+ */
+template<typename T>
+class arena_allocator {
+public:
+  using value_type = T;
+
+  template<typename U>
+  struct rebind { using other = arena_allocator<U>; };
+
+  /**
+   * Constructor
+   * @param arena to take memory from
+   */
+  explicit arena_allocator(memory_arena& arena) noexcept: arena_(&arena) {}
+
+  template<typename U>
+  arena_allocator(const arena_allocator<U>& other) noexcept: arena_(other.get_arena()) {}
+
+  T* allocate(size_t n) {
+    if (n > static_cast<size_t>(-1) / sizeof(T)) throw std::bad_alloc();
+    return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T*, size_t) noexcept {}
+
+  /**
+   * @return pointer to the arena
+   */
+  memory_arena* get_arena() const noexcept { return arena_; }
+
+private:
+  memory_arena* arena_;
+};
+
+template<typename T, typename U>
+inline bool operator==(const arena_allocator<T>& a, const arena_allocator<U>& b) {
+  return a.get_arena() == b.get_arena();
+}
+
+template<typename T, typename U>
+inline bool operator!=(const arena_allocator<T>& a, const arena_allocator<U>& b) {
+  return a.get_arena() != b.get_arena();
+}
+
+} /* namespace datasketches */
+
+#endif
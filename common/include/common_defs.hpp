@@ -21,6 +21,7 @@
 #define _COMMON_DEFS_HPP_
 
 #include <cstdint>
+#include <cmath>
 #include <string>
 #include <memory>
 #include <iostream>
@@ -28,6 +29,10 @@
 #include <chrono>
 #include <thread>
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
 /// DataSketches namespace
 namespace datasketches {
 
@@ -61,6 +66,35 @@ template<typename T> void unused(T&&...) {}
 // common helping functions
 // TODO: find a better place for them
 
+// hint to bring the cache line holding the given address closer to the CPU
+// does nothing on platforms without a known prefetch instruction
+static inline void prefetch_memory(const void* ptr) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(ptr);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  _mm_prefetch(static_cast<const char*>(ptr), _MM_HINT_T0);
+#else
+  unused(ptr);
+#endif
+}
+
+// double value canonicalization for compatibility with Java
+static inline int64_t canonical_double(double value) {
+  union {
+    int64_t long_value;
+    double double_value;
+  } long_double_union;
+
+  if (value == 0.0) {
+    long_double_union.double_value = 0.0; // canonicalize -0.0 to 0.0
+  } else if (std::isnan(value)) {
+    long_double_union.long_value = 0x7ff8000000000000L; // canonicalize NaN using value from Java's Double.doubleToLongBits()
+  } else {
+    long_double_union.double_value = value;
+  }
+  return long_double_union.long_value;
+}
+
 constexpr uint8_t log2(uint32_t n) {
   return (n > 1) ? 1 + log2(n >> 1) : 0;
 }
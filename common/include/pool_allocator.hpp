@@ -0,0 +1,199 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef POOL_ALLOCATOR_HPP_
+#define POOL_ALLOCATOR_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+namespace datasketches {
+
+/**
+ * Memory pool with power-of-2 size classes.
+ * Blocks of each size class are carved from large chunks obtained from the global operator new
+ * and are kept on a free list of their class when deallocated, so that they can be reused
+ * by the next sketch without going through the system allocator.
+ * Requests larger than the largest size class go directly to the global operator new.
+ * Chunks are returned to the system only by the destructor.
+ * Not thread-safe. The intended use is one pool per thread.
+ * The pool must outlive all allocators and sketches that use it.
+ */
+class memory_pool {
+public:
+  static const uint8_t MIN_LG_BLOCK_SIZE = 4;
+  static const uint8_t MAX_LG_BLOCK_SIZE = 16;
+  static const size_t DEFAULT_CHUNK_SIZE = 1 << 18;
+
+  /**
+   * Constructor
+   * @param chunk_size size in bytes of the chunks requested from the system,
+   * must not be less than the largest block size
+   */
+  explicit memory_pool(size_t chunk_size = DEFAULT_CHUNK_SIZE):
+  chunk_size_(chunk_size), chunks_(nullptr)
+  {
+    if (chunk_size < (1 << MAX_LG_BLOCK_SIZE)) {
+      throw std::invalid_argument("chunk size must not be less than " + std::to_string(1 << MAX_LG_BLOCK_SIZE));
+    }
+    for (auto& list: free_lists_) list = nullptr;
+  }
+
+  memory_pool(const memory_pool&) = delete;
+  memory_pool& operator=(const memory_pool&) = delete;
+
+  ~memory_pool() {
+    while (chunks_ != nullptr) {
+      chunk_header* next = chunks_->next;
+      ::operator delete(chunks_);
+      chunks_ = next;
+    }
+  }
+
+  /**
+   * Allocates a block of memory aligned to the largest power of 2 not greater than its size class
+   * or alignof(std::max_align_t), whichever is smaller.
+   * @param size in bytes
+   * @return pointer to the block
+   */
+  void* allocate(size_t size) {
+    if (size > (1 << MAX_LG_BLOCK_SIZE)) return ::operator new(size);
+    const uint8_t size_class = get_size_class(size);
+    free_block* block = free_lists_[size_class];
+    if (block == nullptr) {
+      refill(size_class);
+      block = free_lists_[size_class];
+    }
+    free_lists_[size_class] = block->next;
+    return block;
+  }
+
+  /**
+   * Returns a block to the pool
+   * @param ptr pointer to the block
+   * @param size in bytes, the same as in the call to allocate()
+   */
+  void deallocate(void* ptr, size_t size) noexcept {
+    if (ptr == nullptr) return;
+    if (size > (1 << MAX_LG_BLOCK_SIZE)) {
+      ::operator delete(ptr);
+      return;
+    }
+    const uint8_t size_class = get_size_class(size);
+    free_block* block = static_cast<free_block*>(ptr);
+    block->next = free_lists_[size_class];
+    free_lists_[size_class] = block;
+  }
+
+private:
+  static const uint8_t NUM_SIZE_CLASSES = MAX_LG_BLOCK_SIZE - MIN_LG_BLOCK_SIZE + 1;
+
+  struct free_block {
+    free_block* next;
+  };
+
+  struct chunk_header {
+    chunk_header* next;
+    alignas(std::max_align_t) char data[1];
+  };
+
+  size_t chunk_size_;
+  chunk_header* chunks_;
+  free_block* free_lists_[NUM_SIZE_CLASSES];
+
+  static uint8_t get_size_class(size_t size) {
+    uint8_t lg_size = MIN_LG_BLOCK_SIZE;
+    while ((static_cast<size_t>(1) << lg_size) < size) ++lg_size;
+    return lg_size - MIN_LG_BLOCK_SIZE;
+  }
+
+  // carves a new chunk into blocks of the given size class
+  void refill(uint8_t size_class) {
+    const size_t block_size = static_cast<size_t>(1) << (size_class + MIN_LG_BLOCK_SIZE);
+    chunk_header* chunk = static_cast<chunk_header*>(::operator new(offsetof(chunk_header, data) + chunk_size_));
+    chunk->next = chunks_;
+    chunks_ = chunk;
+    const size_t num_blocks = chunk_size_ / block_size;
+    for (size_t i = num_blocks; i > 0; --i) {
+      free_block* block = reinterpret_cast<free_block*>(chunk->data + (i - 1) * block_size);
+      block->next = free_lists_[size_class];
+      free_lists_[size_class] = block;
+    }
+  }
+};
+
+/**
+ * Allocator that takes memory from a memory_pool.
+ * It can be used as the Allocator parameter of any sketch.
+ * Types aligned stricter than std::max_align_t are rejected at compile time.
+ * An instance must be passed explicitly since there is no default constructor.
+ * Copies and rebound copies share the pool and compare equal.
+ */
+template<typename T>
+class pool_allocator {
+  static_assert(alignof(T) <= alignof(std::max_align_t), "pool_allocator does not support over-aligned types");
+public:
+  using value_type = T;
+
+  template<typename U>
+  struct rebind { using other = pool_allocator<U>; };
+
+  /**
+   * Constructor
+   * @param pool to take memory from
+   */
+  explicit pool_allocator(memory_pool& pool) noexcept: pool_(&pool) {}
+
+  template<typename U>
+  pool_allocator(const pool_allocator<U>& other) noexcept: pool_(other.get_pool()) {}
+
+  T* allocate(size_t n) {
+    if (n > static_cast<size_t>(-1) / sizeof(T)) throw std::bad_alloc();
+    return static_cast<T*>(pool_->allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T* ptr, size_t n) noexcept {
+    pool_->deallocate(ptr, n * sizeof(T));
+  }
+
+  /**
+   * @return pointer to the pool
+   */
+  memory_pool* get_pool() const noexcept { return pool_; }
+
+private:
+  memory_pool* pool_;
+};
+
+template<typename T, typename U>
+inline bool operator==(const pool_allocator<T>& a, const pool_allocator<U>& b) {
+  return a.get_pool() == b.get_pool();
+}
+
+template<typename T, typename U>
+inline bool operator!=(const pool_allocator<T>& a, const pool_allocator<U>& b) {
+  return a.get_pool() != b.get_pool();
+}
+
+} /* namespace datasketches */
+
+#endif
@@ -26,6 +26,7 @@
 #include <string>
 #include <exception>
 
+#include "common_defs.hpp"
 #include "memory_operations.hpp"
 
 namespace datasketches {
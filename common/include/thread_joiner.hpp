@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef THREAD_JOINER_HPP_
+#define THREAD_JOINER_HPP_
+
+#include <exception>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace datasketches {
+
+// Joins the started threads on destruction, so that the threads already running
+// are not destroyed while joinable if starting another one throws
+
+class thread_joiner {
+public:
+  explicit thread_joiner(std::vector<std::thread>& threads): threads_(threads) {}
+  thread_joiner(const thread_joiner&) = delete;
+  thread_joiner& operator=(const thread_joiner&) = delete;
+  ~thread_joiner() { join(); }
+
+  void join() {
+    for (auto& thread: threads_) {
+      if (thread.joinable()) thread.join();
+    }
+  }
+
+private:
+  std::vector<std::thread>& threads_;
+};
+
+// Runs task(t) for each t in [0, num_threads) on its own thread and waits for all of them.
+// If no more threads can be started, the remaining tasks run on the calling thread.
+// The first exception thrown by a task is rethrown after all threads are joined.
+
+template<typename Task>
+void run_on_threads(unsigned num_threads, const Task& task) {
+  std::vector<std::exception_ptr> errors(num_threads);
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  thread_joiner joiner(threads);
+  for (unsigned t = 0; t < num_threads; ++t) {
+    try {
+      threads.emplace_back([&task, &errors, t]() {
+        try {
+          task(t);
+        } catch (...) {
+          errors[t] = std::current_exception();
+        }
+      });
+    } catch (const std::system_error&) {
+      for (unsigned rest = t; rest < num_threads; ++rest) task(rest);
+      break;
+    }
+  }
+  joiner.join();
+  for (auto& error: errors) {
+    if (error) std::rethrow_exception(error);
+  }
+}
+
+} /* namespace datasketches */
+
+#endif
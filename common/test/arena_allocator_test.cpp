@@ -0,0 +1,72 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "arena_allocator.hpp"
+
+namespace datasketches {
+
+TEST_CASE("arena allocator: alignment and chunks", "[arena_allocator]") {
+  memory_arena arena(64);
+  arena_allocator<char> char_alloc(arena);
+  arena_allocator<uint64_t> u64_alloc(char_alloc);
+  REQUIRE(char_alloc == u64_alloc);
+
+  char* c = char_alloc.allocate(3);
+  uint64_t* u = u64_alloc.allocate(4);
+  REQUIRE(reinterpret_cast<uintptr_t>(u) % alignof(uint64_t) == 0);
+  REQUIRE(reinterpret_cast<char*>(u) >= c + 3);
+  for (int i = 0; i < 4; ++i) u[i] = i;
+
+  // larger than a chunk
+  uint64_t* big = u64_alloc.allocate(100);
+  for (int i = 0; i < 100; ++i) big[i] = i;
+  REQUIRE(u[3] == 3);
+  REQUIRE(arena.get_bytes_allocated() == 3 + 4 * sizeof(uint64_t) + 100 * sizeof(uint64_t));
+
+  arena.release();
+  REQUIRE(arena.get_bytes_allocated() == 0);
+
+  memory_arena other_arena;
+  REQUIRE(arena_allocator<char>(other_arena) != char_alloc);
+  REQUIRE_THROWS_AS(memory_arena(0), std::invalid_argument);
+  REQUIRE_THROWS_AS(arena.allocate(static_cast<size_t>(-1) - 4, 8), std::bad_alloc);
+}
+
+TEST_CASE("arena allocator: containers", "[arena_allocator]") {
+  memory_arena arena;
+  {
+    std::vector<int, arena_allocator<int>> v((arena_allocator<int>(arena)));
+    for (int i = 0; i < 10000; ++i) v.push_back(i);
+    REQUIRE(v[9999] == 9999);
+
+    using map_alloc = arena_allocator<std::pair<const int, int>>;
+    std::map<int, int, std::less<int>, map_alloc> m((std::less<int>()), map_alloc(arena));
+    for (int i = 0; i < 1000; ++i) m[i] = i * 2;
+    REQUIRE(m[500] == 1000);
+  }
+  REQUIRE(arena.get_bytes_allocated() > 10000 * sizeof(int));
+}
+
+} /* namespace datasketches */
@@ -37,6 +37,8 @@
 #include "tuple_union.hpp"
 #include "tuple_intersection.hpp"
 #include "tuple_a_not_b.hpp"
+#include "arena_allocator.hpp"
+#include "pool_allocator.hpp"
 
 namespace datasketches {
 
@@ -80,4 +82,56 @@ TEST_CASE("integration: declare all sketches", "[integration]") {
   tuple_a_not_b<float> tuple_anb;
 }
 
+// builds, merges and serializes sketches of several families with a given allocator
+template<template<typename> class Alloc>
+void use_sketches(const Alloc<char>& alloc) {
+  using theta_alloc = Alloc<uint64_t>;
+  auto theta = typename update_theta_sketch_alloc<theta_alloc>::builder(theta_alloc(alloc)).build();
+  for (int i = 0; i < 10000; ++i) theta.update(i);
+  auto theta_u = typename theta_union_alloc<theta_alloc>::builder(theta_alloc(alloc)).build();
+  theta_u.update(theta);
+  auto theta_bytes = theta_u.get_result().serialize();
+  auto theta_compact = compact_theta_sketch_alloc<theta_alloc>::deserialize(theta_bytes.data(), theta_bytes.size(),
+      DEFAULT_SEED, theta_alloc(alloc));
+  REQUIRE(theta_compact.get_estimate() == theta_u.get_result().get_estimate());
+
+  using kll_alloc = Alloc<double>;
+  kll_sketch<double, std::less<double>, kll_alloc> kll(200, std::less<double>(), kll_alloc(alloc));
+  for (int i = 0; i < 10000; ++i) kll.update(i);
+  kll_sketch<double, std::less<double>, kll_alloc> kll2(200, std::less<double>(), kll_alloc(alloc));
+  kll2.merge(kll);
+  REQUIRE(kll2.get_n() == 10000);
+  REQUIRE(kll2.get_quantile(0.5) == Approx(5000).margin(500));
+
+  using hll_alloc = Alloc<uint8_t>;
+  hll_sketch_alloc<hll_alloc> hll(12, HLL_8, false, hll_alloc(alloc));
+  for (int i = 0; i < 10000; ++i) hll.update(i);
+  hll_union_alloc<hll_alloc> hll_u(12, hll_alloc(alloc));
+  hll_u.update(hll);
+  REQUIRE(hll_u.get_result().get_estimate() == Approx(10000).margin(500));
+
+  cpc_sketch_alloc<hll_alloc> cpc(11, DEFAULT_SEED, hll_alloc(alloc));
+  for (int i = 0; i < 10000; ++i) cpc.update(i);
+  auto cpc_bytes = cpc.serialize();
+  auto cpc2 = cpc_sketch_alloc<hll_alloc>::deserialize(cpc_bytes.data(), cpc_bytes.size(), DEFAULT_SEED, hll_alloc(alloc));
+  REQUIRE(cpc2.get_estimate() == cpc.get_estimate());
+
+  using tuple_alloc = Alloc<float>;
+  using tuple_policy = default_tuple_update_policy<float, float>;
+  auto tuple = typename update_tuple_sketch<float, float, tuple_policy, tuple_alloc>::builder(
+      tuple_policy(), tuple_alloc(alloc)).build();
+  for (int i = 0; i < 10000; ++i) tuple.update(i, 1.0f);
+  REQUIRE(tuple.compact().get_estimate() == tuple.get_estimate());
+}
+
+TEST_CASE("integration: arena allocator", "[integration]") {
+  memory_arena arena;
+  use_sketches<arena_allocator>(arena_allocator<char>(arena));
+}
+
+TEST_CASE("integration: pool allocator", "[integration]") {
+  memory_pool pool;
+  use_sketches<pool_allocator>(pool_allocator<char>(pool));
+}
+
 } /* namespace datasketches */
@@ -0,0 +1,70 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "pool_allocator.hpp"
+
+namespace datasketches {
+
+TEST_CASE("pool allocator: reuse of blocks", "[pool_allocator]") {
+  memory_pool pool;
+  pool_allocator<uint64_t> alloc(pool);
+  pool_allocator<char> char_alloc(alloc);
+  REQUIRE(char_alloc == alloc);
+
+  uint64_t* a = alloc.allocate(3); // 32-byte class
+  REQUIRE(reinterpret_cast<uintptr_t>(a) % alignof(uint64_t) == 0);
+  alloc.deallocate(a, 3);
+  uint64_t* b = alloc.allocate(4); // same size class
+  REQUIRE(b == a);
+  uint64_t* c = alloc.allocate(4);
+  REQUIRE(c != b);
+  alloc.deallocate(b, 4);
+  alloc.deallocate(c, 4);
+
+  // larger than the largest size class
+  uint64_t* big = alloc.allocate(1 << 14);
+  for (int i = 0; i < (1 << 14); ++i) big[i] = i;
+  alloc.deallocate(big, 1 << 14);
+
+  memory_pool other_pool;
+  REQUIRE(pool_allocator<char>(other_pool) != char_alloc);
+  REQUIRE_THROWS_AS(memory_pool(1024), std::invalid_argument);
+}
+
+TEST_CASE("pool allocator: containers", "[pool_allocator]") {
+  memory_pool pool;
+  for (int n = 0; n < 3; ++n) {
+    std::vector<int, pool_allocator<int>> v((pool_allocator<int>(pool)));
+    for (int i = 0; i < 10000; ++i) v.push_back(i);
+    REQUIRE(v[9999] == 9999);
+
+    using map_alloc = pool_allocator<std::pair<const int, int>>;
+    std::map<int, int, std::less<int>, map_alloc> m((std::less<int>()), map_alloc(pool));
+    for (int i = 0; i < 1000; ++i) m[i] = i * 2;
+    REQUIRE(m[500] == 1000);
+  }
+}
+
+} /* namespace datasketches */
@@ -194,6 +194,31 @@ public:
    */
   void update(const void* value, size_t size);
 
+  /**
+   * Update this sketch with a batch of unsigned 64-bit integers.
+   * The result is the same as calling update(uint64_t) for each item,
+   * but the items are hashed in blocks by a specialized 8-byte kernel.
+   * @param values pointer to the array of items
+   * @param num_values number of items in the array
+   */
+  void update_batch(const uint64_t* values, size_t num_values);
+
+  /**
+   * Update this sketch with a batch of signed 64-bit integers.
+   * The result is the same as calling update(int64_t) for each item.
+   * @param values pointer to the array of items
+   * @param num_values number of items in the array
+   */
+  void update_batch(const int64_t* values, size_t num_values);
+
+  /**
+   * Update this sketch with a batch of double-precision floating point values.
+   * The result is the same as calling update(double) for each item.
+   * @param values pointer to the array of items
+   * @param num_values number of items in the array
+   */
+  void update_batch(const double* values, size_t num_values);
+
   /**
    * Returns a human-readable summary of this sketch
    * @return a human-readable summary of this sketch
@@ -256,6 +281,7 @@ public:
 private:
   static const uint8_t SERIAL_VERSION = 1;
   static const uint8_t FAMILY = 16;
+  static const uint8_t HASH_BATCH_SIZE = 16;
 
   enum flags { IS_BIG_ENDIAN, IS_COMPRESSED, HAS_HIP, HAS_TABLE, HAS_WINDOW };
 
@@ -288,6 +314,7 @@ private:
       vector_bytes&& window, bool has_hip, double kxp, double hip_est_accum, uint64_t seed);
 
   inline void row_col_update(uint32_t row_col);
+  void update_batch_keys(const uint64_t* keys, size_t num_keys);
   inline void update_sparse(uint32_t row_col);
   inline void update_windowed(uint32_t row_col);
   inline void update_hip(uint32_t row_col);
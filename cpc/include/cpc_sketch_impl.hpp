@@ -153,18 +153,8 @@ void cpc_sketch_alloc<A>::update(int8_t value) {
 
 template<typename A>
 void cpc_sketch_alloc<A>::update(double value) {
-  union {
-    int64_t long_value;
-    double double_value;
-  } ldu;
-  if (value == 0.0) {
-    ldu.double_value = 0.0; // canonicalize -0.0 to 0.0
-  } else if (std::isnan(value)) {
-    ldu.long_value = 0x7ff8000000000000L; // canonicalize NaN using value from Java's Double.doubleToLongBits()
-  } else {
-    ldu.double_value = value;
-  }
-  update(&ldu, sizeof(ldu));
+  const int64_t key = canonical_double(value);
+  update(&key, sizeof(key));
 }
 
 template<typename A>
@@ -192,6 +182,42 @@ void cpc_sketch_alloc<A>::update(const void* value, size_t size) {
   row_col_update(row_col_from_two_hashes(hashes.h1, hashes.h2, lg_k));
 }
 
+template<typename A>
+void cpc_sketch_alloc<A>::update_batch(const uint64_t* values, size_t num_values) {
+  update_batch_keys(values, num_values);
+}
+
+template<typename A>
+void cpc_sketch_alloc<A>::update_batch(const int64_t* values, size_t num_values) {
+  update_batch_keys(reinterpret_cast<const uint64_t*>(values), num_values);
+}
+
+template<typename A>
+void cpc_sketch_alloc<A>::update_batch(const double* values, size_t num_values) {
+  uint64_t keys[HASH_BATCH_SIZE];
+  while (num_values > 0) {
+    const uint8_t block_size = static_cast<uint8_t>(num_values < HASH_BATCH_SIZE ? num_values : HASH_BATCH_SIZE);
+    for (uint8_t i = 0; i < block_size; ++i) keys[i] = static_cast<uint64_t>(canonical_double(values[i]));
+    update_batch_keys(keys, block_size);
+    values += block_size;
+    num_values -= block_size;
+  }
+}
+
+template<typename A>
+void cpc_sketch_alloc<A>::update_batch_keys(const uint64_t* keys, size_t num_keys) {
+  HashState hashes[HASH_BATCH_SIZE];
+  while (num_keys > 0) {
+    const uint8_t block_size = static_cast<uint8_t>(num_keys < HASH_BATCH_SIZE ? num_keys : HASH_BATCH_SIZE);
+    MurmurHash3_x64_128_batch(keys, block_size, seed, hashes);
+    for (uint8_t i = 0; i < block_size; ++i) {
+      row_col_update(row_col_from_two_hashes(hashes[i].h1, hashes[i].h2, lg_k));
+    }
+    keys += block_size;
+    num_keys -= block_size;
+  }
+}
+
 template<typename A>
 void cpc_sketch_alloc<A>::row_col_update(uint32_t row_col) {
   const uint8_t col = row_col & 63;
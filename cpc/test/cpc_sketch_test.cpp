@@ -22,6 +22,8 @@
 #include <sstream>
 #include <fstream>
 #include <stdexcept>
+#include <vector>
+#include <limits>
 
 #include <catch2/catch.hpp>
 
@@ -379,4 +381,31 @@ TEST_CASE("cpc sketch: max serialized size", "[cpc_sketch]") {
   REQUIRE(cpc_sketch::get_max_serialized_size_bytes(26) == static_cast<size_t>((0.6 * (1 << 26)) + 40));
 }
 
+TEST_CASE("cpc sketch: batch update", "[cpc_sketch]") {
+  const size_t n = 10001; // not a multiple of the batch size
+  std::vector<uint64_t> unsigned_values(n);
+  std::vector<int64_t> signed_values(n);
+  std::vector<double> double_values(n);
+  for (size_t i = 0; i < n; ++i) {
+    unsigned_values[i] = i;
+    signed_values[i] = -static_cast<int64_t>(i);
+    double_values[i] = static_cast<double>(i) / 3;
+  }
+  double_values[1] = -0.0;
+  double_values[2] = std::numeric_limits<double>::quiet_NaN();
+
+  cpc_sketch sketch1(11);
+  for (auto value: unsigned_values) sketch1.update(value);
+  for (auto value: signed_values) sketch1.update(value);
+  for (auto value: double_values) sketch1.update(value);
+
+  cpc_sketch sketch2(11);
+  sketch2.update_batch(unsigned_values.data(), n);
+  sketch2.update_batch(signed_values.data(), n);
+  sketch2.update_batch(double_values.data(), n);
+  sketch2.update_batch(double_values.data(), 0);
+
+  REQUIRE(sketch1.serialize() == sketch2.serialize());
+}
+
 } /* namespace datasketches */
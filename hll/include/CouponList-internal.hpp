@@ -294,24 +294,39 @@ double CouponList<A>::getCompositeEstimate() const { return getEstimate(); }
 
 template<typename A>
 double CouponList<A>::getEstimate() const {
-  const double est = CubicInterpolation<A>::usingXAndYTables(couponCount_);
-  return fmax(est, couponCount_);
+  return estimate(couponCount_);
 }
 
 template<typename A>
 double CouponList<A>::getLowerBound(uint8_t numStdDev) const {
+  return lowerBound(couponCount_, numStdDev);
+}
+
+template<typename A>
+double CouponList<A>::getUpperBound(uint8_t numStdDev) const {
+  return upperBound(couponCount_, numStdDev);
+}
+
+template<typename A>
+double CouponList<A>::estimate(uint32_t couponCount) {
+  const double est = CubicInterpolation<A>::usingXAndYTables(couponCount);
+  return fmax(est, couponCount);
+}
+
+template<typename A>
+double CouponList<A>::lowerBound(uint32_t couponCount, uint8_t numStdDev) {
   HllUtil<A>::checkNumStdDev(numStdDev);
-  const double est = CubicInterpolation<A>::usingXAndYTables(couponCount_);
+  const double est = CubicInterpolation<A>::usingXAndYTables(couponCount);
   const double tmp = est / (1.0 + (numStdDev * hll_constants::COUPON_RSE));
-  return fmax(tmp, couponCount_);
+  return fmax(tmp, couponCount);
 }
 
 template<typename A>
-double CouponList<A>::getUpperBound(uint8_t numStdDev) const {
+double CouponList<A>::upperBound(uint32_t couponCount, uint8_t numStdDev) {
   HllUtil<A>::checkNumStdDev(numStdDev);
-  const double est = CubicInterpolation<A>::usingXAndYTables(couponCount_);
+  const double est = CubicInterpolation<A>::usingXAndYTables(couponCount);
   const double tmp = est / (1.0 - (numStdDev * hll_constants::COUPON_RSE));
-  return fmax(tmp, couponCount_);
+  return fmax(tmp, couponCount);
 }
 
 template<typename A>
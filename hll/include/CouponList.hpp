@@ -59,6 +59,11 @@ class CouponList : public HllSketchImpl<A> {
     virtual bool isEmpty() const;
     virtual uint32_t getCouponCount() const;
 
+    // estimators computed from the coupon count only, also used by wrapped sketches
+    static double estimate(uint32_t couponCount);
+    static double lowerBound(uint32_t couponCount, uint8_t numStdDev);
+    static double upperBound(uint32_t couponCount, uint8_t numStdDev);
+
     coupon_iterator<A> begin(bool all = false) const;
     coupon_iterator<A> end() const;
 
@@ -21,6 +21,7 @@
 #define _HLL8ARRAY_INTERNAL_HPP_
 
 #include "Hll8Array.hpp"
+#include "HllMergeKernels.hpp"
 
 namespace datasketches {
 
@@ -113,89 +114,52 @@ void Hll8Array<A>::mergeList(const CouponList<A>& src) {
 
 template<typename A>
 void Hll8Array<A>::mergeHll(const HllArray<A>& src) {
-  // at this point src_k >= dst_k
-  // we can optimize further when the k values are equal
-  if (this->getLgConfigK() == src.getLgConfigK()) {
-    if (src.getTgtHllType() == target_hll_type::HLL_8) {
-      uint32_t i = 0;
-      for (const auto value: src.getHllArray()) {
-        this->hllByteArr_[i] = std::max(this->hllByteArr_[i], value);
-        ++i;
-      }
-    } else if (src.getTgtHllType() == target_hll_type::HLL_6) {
-      const uint32_t src_k = 1 << src.getLgConfigK();
-      uint32_t i = 0;
-      const uint8_t* ptr = src.getHllArray().data();
-      while (i < src_k) {
-        uint8_t value = *ptr & 0x3f;
-        this->hllByteArr_[i] = std::max(this->hllByteArr_[i], value);
-        ++i;
-        value = *ptr++ >> 6;
-        value |= (*ptr & 0x0f) << 2;
-        this->hllByteArr_[i] = std::max(this->hllByteArr_[i], value);
-        ++i;
-        value = *ptr++ >> 4;
-        value |= (*ptr & 3) << 4;
-        this->hllByteArr_[i] = std::max(this->hllByteArr_[i], value);
-        ++i;
-        value = *ptr++ >> 2;
-        this->hllByteArr_[i] = std::max(this->hllByteArr_[i], value);
-        ++i;
-      }
-    } else { // HLL_4
-      const auto& src4 = static_cast<const Hll4Array<A>&>(src);
-      uint32_t i = 0;
-      for (const auto byte: src.getHllArray()) {
-        this->hllByteArr_[i] = std::max(this->hllByteArr_[i], src4.adjustRawValue(i, byte & hll_constants::loNibbleMask));
-        ++i;
-        this->hllByteArr_[i] = std::max(this->hllByteArr_[i], src4.adjustRawValue(i, byte >> 4));
-        ++i;
-      }
-    }
-  } else {
-    // src_k > dst_k
-    const uint32_t dst_mask = (1 << this->getLgConfigK()) - 1;
-    // special treatment below to optimize performance
-    if (src.getTgtHllType() == target_hll_type::HLL_8) {
-      uint32_t i = 0;
-      for (const auto value: src.getHllArray()) {
-        processValue(i++, dst_mask, value);
-      }
-    } else if (src.getTgtHllType() == target_hll_type::HLL_6) {
-      const uint32_t src_k = 1 << src.getLgConfigK();
-      uint32_t i = 0;
-      const uint8_t* ptr = src.getHllArray().data();
-      while (i < src_k) {
-        uint8_t value = *ptr & 0x3f;
-        processValue(i++, dst_mask, value);
-        value = *ptr++ >> 6;
-        value |= (*ptr & 0x0f) << 2;
-        processValue(i++, dst_mask, value);
-        value = *ptr++ >> 4;
-        value |= (*ptr & 3) << 4;
-        processValue(i++, dst_mask, value);
-        value = *ptr++ >> 2;
-        processValue(i++, dst_mask, value);
-      }
-    } else { // HLL_4
-      const auto& src4 = static_cast<const Hll4Array<A>&>(src);
-      uint32_t i = 0;
-      for (const auto byte: src.getHllArray()) {
-        processValue(i, dst_mask, src4.adjustRawValue(i, byte & hll_constants::loNibbleMask));
-        ++i;
-        processValue(i, dst_mask, src4.adjustRawValue(i, byte >> 4));
-        ++i;
-      }
-    }
-  }
+  mergeHllSlots(src, 0, 1 << this->getLgConfigK());
   this->setRebuildKxqCurminFlag(true);
 }
 
+template<typename A>
+void Hll8Array<A>::mergeHllSlots(const HllArray<A>& src, uint32_t first_slot, uint32_t num_slots) {
+  // only called for HLL_4 exceptions
+  auto auxValue = [&src](uint32_t slot) {
+    return static_cast<const Hll4Array<A>&>(src).adjustRawValue(slot, hll_constants::AUX_TOKEN);
+  };
+  mergeRegisters(src.getTgtHllType(), src.getLgConfigK(), src.getHllArray().data(), src.getCurMin(), auxValue,
+      first_slot, num_slots);
+}
 
 template<typename A>
-void Hll8Array<A>::processValue(uint32_t slot, uint32_t mask, uint8_t new_val) {
-  const size_t index = slot & mask;
-  this->hllByteArr_[index] = std::max(this->hllByteArr_[index], new_val);
+void Hll8Array<A>::mergeHllBytes(target_hll_type srcType, uint8_t srcLgConfigK, const uint8_t* srcBytes, uint8_t srcCurMin) {
+  auto noValue = [](uint32_t) { return static_cast<uint8_t>(0); };
+  mergeRegisters(srcType, srcLgConfigK, srcBytes, srcCurMin, noValue, 0, 1 << this->getLgConfigK());
+}
+
+template<typename A>
+void Hll8Array<A>::mergeCoupon(uint32_t coupon) {
+  const uint32_t slot = HllUtil<A>::getLow26(coupon) & ((1 << this->getLgConfigK()) - 1);
+  this->hllByteArr_[slot] = std::max(this->hllByteArr_[slot], HllUtil<A>::getValue(coupon));
+}
+
+template<typename A>
+template<typename AuxValue>
+void Hll8Array<A>::mergeRegisters(target_hll_type srcType, uint8_t srcLgConfigK, const uint8_t* srcBytes, uint8_t srcCurMin,
+    const AuxValue& auxValue, uint32_t first_slot, uint32_t num_slots) {
+  // at this point src_k >= dst_k
+  // when src_k > dst_k, each consecutive block of dst_k source slots folds onto the whole destination
+  const uint32_t dst_k = 1 << this->getLgConfigK();
+  const uint32_t src_k = 1 << srcLgConfigK;
+  uint8_t* dst = this->hllByteArr_.data() + first_slot;
+  for (uint32_t offset = first_slot; offset < src_k; offset += dst_k) {
+    if (srcType == target_hll_type::HLL_8) {
+      hll_merge_max_8(dst, srcBytes + offset, num_slots);
+    } else if (srcType == target_hll_type::HLL_6) {
+      hll_merge_max_6(dst, srcBytes + offset / 4 * 3, num_slots);
+    } else { // HLL_4
+      hll_merge_max_4(dst, srcBytes + offset / 2, num_slots, srcCurMin, [&auxValue, offset](uint32_t slot) {
+        return auxValue(offset + slot);
+      });
+    }
+  }
 }
 
 }
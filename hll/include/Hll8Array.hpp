@@ -44,12 +44,22 @@ class Hll8Array final : public HllArray<A> {
     virtual HllSketchImpl<A>* couponUpdate(uint32_t coupon) final;
     void mergeList(const CouponList<A>& src);
     void mergeHll(const HllArray<A>& src);
+    // merges the source registers that map onto the given range of destination slots
+    // without flagging kxq and cur_min for a rebuild; num_slots must be a multiple of 8
+    void mergeHllSlots(const HllArray<A>& src, uint32_t first_slot, uint32_t num_slots);
+    // merges registers in serialized form without flagging kxq and cur_min for a rebuild;
+    // HLL_4 exceptions are skipped and must be merged separately with mergeCoupon()
+    void mergeHllBytes(target_hll_type srcType, uint8_t srcLgConfigK, const uint8_t* srcBytes, uint8_t srcCurMin);
+    // raises the register of the coupon slot (masked to this lg_k) to the coupon value
+    inline void mergeCoupon(uint32_t coupon);
 
     virtual uint32_t getHllByteArrBytes() const;
 
   private:
     inline void internalCouponUpdate(uint32_t coupon);
-    inline void processValue(uint32_t slot, uint32_t mask, uint8_t new_val);
+    template<typename AuxValue>
+    void mergeRegisters(target_hll_type srcType, uint8_t srcLgConfigK, const uint8_t* srcBytes, uint8_t srcCurMin,
+        const AuxValue& auxValue, uint32_t first_slot, uint32_t num_slots);
 };
 
 }
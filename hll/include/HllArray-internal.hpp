@@ -343,18 +343,29 @@ double HllArray<A>::getEstimate() const {
  */
 template<typename A>
 double HllArray<A>::getLowerBound(uint8_t numStdDev) const {
-  HllUtil<A>::checkNumStdDev(numStdDev);
-  const uint32_t configK = 1 << this->lgConfigK_;
-  const double numNonZeros = ((curMin_ == 0) ? (configK - numAtCurMin_) : configK);
-  const double relErr = HllUtil<A>::getRelErr(false, this->oooFlag_, this->lgConfigK_, numStdDev);
-  return fmax(getEstimate() / (1.0 + relErr), numNonZeros);
+  return lowerBound(this->lgConfigK_, this->oooFlag_, curMin_, numAtCurMin_, getEstimate(), numStdDev);
 }
 
 template<typename A>
 double HllArray<A>::getUpperBound(uint8_t numStdDev) const {
+  return upperBound(this->lgConfigK_, this->oooFlag_, getEstimate(), numStdDev);
+}
+
+template<typename A>
+double HllArray<A>::lowerBound(uint8_t lgConfigK, bool oooFlag, uint8_t curMin, uint32_t numAtCurMin,
+    double estimate, uint8_t numStdDev) {
   HllUtil<A>::checkNumStdDev(numStdDev);
-  const double relErr = HllUtil<A>::getRelErr(true, this->oooFlag_, this->lgConfigK_, numStdDev);
-  return getEstimate() / (1.0 + relErr);
+  const uint32_t configK = 1 << lgConfigK;
+  const double numNonZeros = ((curMin == 0) ? (configK - numAtCurMin) : configK);
+  const double relErr = HllUtil<A>::getRelErr(false, oooFlag, lgConfigK, numStdDev);
+  return fmax(estimate / (1.0 + relErr), numNonZeros);
+}
+
+template<typename A>
+double HllArray<A>::upperBound(uint8_t lgConfigK, bool oooFlag, double estimate, uint8_t numStdDev) {
+  HllUtil<A>::checkNumStdDev(numStdDev);
+  const double relErr = HllUtil<A>::getRelErr(true, oooFlag, lgConfigK, numStdDev);
+  return estimate / (1.0 + relErr);
 }
 
 /**
@@ -365,11 +376,16 @@ double HllArray<A>::getUpperBound(uint8_t numStdDev) const {
 // Original C: again-two-registers.c hhb_get_composite_estimate L1489
 template<typename A>
 double HllArray<A>::getCompositeEstimate() const {
-  const double rawEst = getHllRawEstimate();
+  return compositeEstimate(this->lgConfigK_, kxq0_ + kxq1_, curMin_, numAtCurMin_);
+}
 
-  const double* xArr = CompositeInterpolationXTable<A>::get_x_arr(this->lgConfigK_);
+template<typename A>
+double HllArray<A>::compositeEstimate(uint8_t lgConfigK, double kxq, uint8_t curMin, uint32_t numAtCurMin) {
+  const double rawEst = getHllRawEstimate(lgConfigK, kxq);
+
+  const double* xArr = CompositeInterpolationXTable<A>::get_x_arr(lgConfigK);
   const uint32_t xArrLen = CompositeInterpolationXTable<A>::get_x_arr_length();
-  const double yStride = CompositeInterpolationXTable<A>::get_y_stride(this->lgConfigK_);
+  const double yStride = CompositeInterpolationXTable<A>::get_y_stride(lgConfigK);
 
   if (rawEst < xArr[0]) {
     return 0;
@@ -388,9 +404,9 @@ double HllArray<A>::getCompositeEstimate() const {
   // We need to completely avoid the linear_counting estimator if it might have a crazy value.
   // Empirical evidence suggests that the threshold 3*k will keep us safe if 2^4 <= k <= 2^21.
 
-  if (adjEst > (3 << this->lgConfigK_)) { return adjEst; }
+  if (adjEst > (3 << lgConfigK)) { return adjEst; }
 
-  const double linEst = getHllBitMapEstimate();
+  const double linEst = getHllBitMapEstimate(lgConfigK, curMin, numAtCurMin);
 
   // Bias is created when the value of an estimator is compared with a threshold to decide whether
   // to use that estimator or a different one.
@@ -402,10 +418,10 @@ double HllArray<A>::getCompositeEstimate() const {
   // The following constants comes from empirical measurements of the crossover point
   // between the average error of the linear estimator and the adjusted hll estimator
   double crossOver = 0.64;
-  if (this->lgConfigK_ == 4)      { crossOver = 0.718; }
-  else if (this->lgConfigK_ == 5) { crossOver = 0.672; }
+  if (lgConfigK == 4)      { crossOver = 0.718; }
+  else if (lgConfigK == 5) { crossOver = 0.672; }
 
-  return (avgEst > (crossOver * (1 << this->lgConfigK_))) ? adjEst : linEst;
+  return (avgEst > (crossOver * (1 << lgConfigK))) ? adjEst : linEst;
 }
 
 template<typename A>
@@ -560,9 +576,9 @@ void HllArray<A>::hipAndKxQIncrementalUpdate(uint8_t oldValue, uint8_t newValue)
  */
 //In C: again-two-registers.c hhb_get_improved_linear_counting_estimate L1274
 template<typename A>
-double HllArray<A>::getHllBitMapEstimate() const {
-  const uint32_t configK = 1 << this->lgConfigK_;
-  const uint32_t numUnhitBuckets = curMin_ == 0 ? numAtCurMin_ : 0;
+double HllArray<A>::getHllBitMapEstimate(uint8_t lgConfigK, uint8_t curMin, uint32_t numAtCurMin) {
+  const uint32_t configK = 1 << lgConfigK;
+  const uint32_t numUnhitBuckets = curMin == 0 ? numAtCurMin : 0;
 
   //This will eventually go away.
   if (numUnhitBuckets == 0) {
@@ -575,14 +591,14 @@ double HllArray<A>::getHllBitMapEstimate() const {
 
 //In C: again-two-registers.c hhb_get_raw_estimate L1167
 template<typename A>
-double HllArray<A>::getHllRawEstimate() const {
-  const uint32_t configK = 1 << this->lgConfigK_;
+double HllArray<A>::getHllRawEstimate(uint8_t lgConfigK, double kxq) {
+  const uint32_t configK = 1 << lgConfigK;
   double correctionFactor;
-  if (this->lgConfigK_ == 4) { correctionFactor = 0.673; }
-  else if (this->lgConfigK_ == 5) { correctionFactor = 0.697; }
-  else if (this->lgConfigK_ == 6) { correctionFactor = 0.709; }
+  if (lgConfigK == 4) { correctionFactor = 0.673; }
+  else if (lgConfigK == 5) { correctionFactor = 0.697; }
+  else if (lgConfigK == 6) { correctionFactor = 0.709; }
   else { correctionFactor = 0.7213 / (1.0 + (1.079 / configK)); }
-  const double hyperEst = (correctionFactor * configK * configK) / (kxq0_ + kxq1_);
+  const double hyperEst = (correctionFactor * configK * configK) / kxq;
   return hyperEst;
 }
 
@@ -600,27 +616,44 @@ template<typename A>
 void HllArray<A>::check_rebuild_kxq_cur_min() {
   if (!rebuild_kxq_curmin_) { return; }
 
+  // count registers per value, then combine the counts with powers of 2
+  uint32_t histogram[256] = {};
+  if (this->tgtHllType_ == target_hll_type::HLL_8) {
+    // independent partial histograms avoid stalls on consecutive increments of the same counter
+    uint32_t partial[4][256] = {};
+    const uint8_t* ptr = hllByteArr_.data();
+    const uint32_t k = 1 << this->lgConfigK_; // multiple of 4
+    for (uint32_t i = 0; i < k; i += 4) {
+      ++partial[0][ptr[i]];
+      ++partial[1][ptr[i + 1]];
+      ++partial[2][ptr[i + 2]];
+      ++partial[3][ptr[i + 3]];
+    }
+    for (int v = 0; v < 256; ++v) histogram[v] = partial[0][v] + partial[1][v] + partial[2][v] + partial[3][v];
+  } else {
+    auto it = this->begin(true); // want all points to adjust cur_min
+    const auto end = this->end();
+    while (it != end) {
+      ++histogram[HllUtil<A>::getValue(*it)];
+      ++it;
+    }
+  }
+
   uint8_t cur_min = 64;
   uint32_t num_at_cur_min = 0;
+  // the same split as a register by register rebuild from kxq0 = k, since it ends up in the serialized form
   double kxq0 = 1 << this->lgConfigK_;
   double kxq1 = 0;
-
-  auto it = this->begin(true); // want all points to adjust cur_min
-  const auto end = this->end();
-  while (it != end) {
-    uint8_t v = HllUtil<A>::getValue(*it);
+  for (int v = 0; v < 256; ++v) {
+    if (histogram[v] == 0) continue;
+    if (num_at_cur_min == 0) {
+      cur_min = static_cast<uint8_t>(v);
+      num_at_cur_min = histogram[v];
+    }
     if (v > 0) {
-      if (v < 32) { kxq0 += INVERSE_POWERS_OF_2[v] - 1.0; }
-      else        { kxq1 += INVERSE_POWERS_OF_2[v] - 1.0; }
+      if (v < 32) { kxq0 += histogram[v] * (INVERSE_POWERS_OF_2[v] - 1.0); }
+      else        { kxq1 += histogram[v] * (INVERSE_POWERS_OF_2[v] - 1.0); }
     }
-    if (v > cur_min) { ++it; continue; }
-    if (v < cur_min) {
-      cur_min = v;
-      num_at_cur_min = 1;
-    } else {
-      ++num_at_cur_min;
-    }    
-    ++it;
   }
 
   kxq0_ = kxq0;
@@ -89,6 +89,12 @@ class HllArray : public HllSketchImpl<A> {
 
     virtual AuxHashMap<A>* getAuxHashMap() const;
 
+    // estimators computed from the summary state only, also used by wrapped sketches
+    static double compositeEstimate(uint8_t lgConfigK, double kxq, uint8_t curMin, uint32_t numAtCurMin);
+    static double lowerBound(uint8_t lgConfigK, bool oooFlag, uint8_t curMin, uint32_t numAtCurMin,
+        double estimate, uint8_t numStdDev);
+    static double upperBound(uint8_t lgConfigK, bool oooFlag, double estimate, uint8_t numStdDev);
+
     void setRebuildKxqCurminFlag(bool rebuild);
     bool isRebuildKxqCurminFlag() const;
     void check_rebuild_kxq_cur_min();
@@ -103,8 +109,8 @@ class HllArray : public HllSketchImpl<A> {
 
   protected:
     void hipAndKxQIncrementalUpdate(uint8_t oldValue, uint8_t newValue);
-    double getHllBitMapEstimate() const;
-    double getHllRawEstimate() const;
+    static double getHllBitMapEstimate(uint8_t lgConfigK, uint8_t curMin, uint32_t numAtCurMin);
+    static double getHllRawEstimate(uint8_t lgConfigK, double kxq);
 
     double hipAccum_;
     double kxq0_;
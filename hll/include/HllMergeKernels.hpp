@@ -0,0 +1,125 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _HLLMERGEKERNELS_HPP_
+#define _HLLMERGEKERNELS_HPP_
+
+#include <algorithm>
+#include <cstdint>
+
+#include "HllUtil.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HLL_MERGE_KERNELS_SSE2
+#endif
+
+namespace datasketches {
+
+// Kernels that merge a block of source registers into HLL_8 destination registers (one byte per slot)
+// by taking the maximum of each pair of registers.
+
+// source in HLL_8 layout
+static inline void hll_merge_max_8(uint8_t* dst, const uint8_t* src, uint32_t num_slots) {
+  uint32_t i = 0;
+#ifdef HLL_MERGE_KERNELS_SSE2
+  for (; i + 16 <= num_slots; i += 16) {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_max_epu8(a, b));
+  }
+#endif
+  for (; i < num_slots; ++i) dst[i] = std::max(dst[i], src[i]);
+}
+
+// unpacks 8 slots from 6 bytes of HLL_6 layout
+static inline void hll_unpack_6(uint8_t* values, const uint8_t* src) {
+  const uint64_t bits = static_cast<uint64_t>(src[0])
+      | static_cast<uint64_t>(src[1]) << 8
+      | static_cast<uint64_t>(src[2]) << 16
+      | static_cast<uint64_t>(src[3]) << 24
+      | static_cast<uint64_t>(src[4]) << 32
+      | static_cast<uint64_t>(src[5]) << 40;
+  for (int j = 0; j < 8; ++j) values[j] = static_cast<uint8_t>((bits >> (6 * j)) & 0x3f);
+}
+
+// source in HLL_6 layout: 4 slots in every 3 bytes, low bits first
+// num_slots must be a multiple of 8
+static inline void hll_merge_max_6(uint8_t* dst, const uint8_t* src, uint32_t num_slots) {
+  uint8_t values[16];
+  uint32_t i = 0;
+  // 16 slots in 12 bytes, merged with one vector max
+  for (; i + 16 <= num_slots; i += 16) {
+    hll_unpack_6(values, src);
+    hll_unpack_6(values + 8, src + 6);
+    src += 12;
+    hll_merge_max_8(dst + i, values, 16);
+  }
+  if (i < num_slots) {
+    hll_unpack_6(values, src);
+    for (uint32_t j = 0; j < 8; ++j) dst[i + j] = std::max(dst[i + j], values[j]);
+  }
+}
+
+// source in HLL_4 layout: 2 slots per byte, low nibble first, values relative to cur_min
+// slots with AUX_TOKEN are resolved with aux_value(slot) for slots relative to dst
+template<typename AuxValue>
+static inline void hll_merge_max_4(uint8_t* dst, const uint8_t* src, uint32_t num_slots, uint8_t cur_min,
+    const AuxValue& aux_value) {
+  uint32_t i = 0;
+#ifdef HLL_MERGE_KERNELS_SSE2
+  const __m128i nibble_mask = _mm_set1_epi8(hll_constants::loNibbleMask);
+  const __m128i aux_token = _mm_set1_epi8(hll_constants::AUX_TOKEN);
+  const __m128i offset = _mm_set1_epi8(static_cast<char>(cur_min));
+  for (; i + 32 <= num_slots; i += 32) {
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i / 2));
+    const __m128i lo = _mm_and_si128(bytes, nibble_mask);
+    const __m128i hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble_mask);
+    // interleave to restore the slot order
+    const __m128i raw0 = _mm_unpacklo_epi8(lo, hi);
+    const __m128i raw1 = _mm_unpackhi_epi8(lo, hi);
+    const __m128i is_aux0 = _mm_cmpeq_epi8(raw0, aux_token);
+    const __m128i is_aux1 = _mm_cmpeq_epi8(raw1, aux_token);
+    // exceptions contribute nothing here and are resolved below
+    const __m128i val0 = _mm_andnot_si128(is_aux0, _mm_add_epi8(raw0, offset));
+    const __m128i val1 = _mm_andnot_si128(is_aux1, _mm_add_epi8(raw1, offset));
+    __m128i* out = reinterpret_cast<__m128i*>(dst + i);
+    _mm_storeu_si128(out, _mm_max_epu8(_mm_loadu_si128(out), val0));
+    _mm_storeu_si128(out + 1, _mm_max_epu8(_mm_loadu_si128(out + 1), val1));
+    const uint32_t exceptions = static_cast<uint32_t>(_mm_movemask_epi8(is_aux0))
+        | static_cast<uint32_t>(_mm_movemask_epi8(is_aux1)) << 16;
+    if (exceptions != 0) {
+      for (uint32_t j = 0; j < 32; ++j) {
+        if (exceptions & (1U << j)) dst[i + j] = std::max(dst[i + j], aux_value(i + j));
+      }
+    }
+  }
+#endif
+  for (; i < num_slots; i += 2) {
+    const uint8_t byte = src[i / 2];
+    const uint8_t lo = byte & hll_constants::loNibbleMask;
+    const uint8_t hi = byte >> 4;
+    dst[i] = std::max(dst[i], lo == hll_constants::AUX_TOKEN ? aux_value(i) : static_cast<uint8_t>(lo + cur_min));
+    dst[i + 1] = std::max(dst[i + 1], hi == hll_constants::AUX_TOKEN ? aux_value(i + 1) : static_cast<uint8_t>(hi + cur_min));
+  }
+}
+
+}
+
+#endif // _HLLMERGEKERNELS_HPP_
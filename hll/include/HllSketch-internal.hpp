@@ -36,11 +36,6 @@
 
 namespace datasketches {
 
-typedef union {
-  int64_t longBytes;
-  double doubleBytes;
-} longDoubleUnion;
-
 template<typename A>
 hll_sketch_alloc<A>::hll_sketch_alloc(uint8_t lg_config_k, target_hll_type tgt_type, bool start_full_size, const A& allocator) {
   HllUtil<A>::checkLgK(lg_config_k);
@@ -177,30 +172,15 @@ void hll_sketch_alloc<A>::update(int8_t datum) {
 
 template<typename A>
 void hll_sketch_alloc<A>::update(double datum) {
-  longDoubleUnion d;
-  d.doubleBytes = static_cast<double>(datum);
-  if (datum == 0.0) {
-    d.doubleBytes = 0.0; // canonicalize -0.0 to 0.0
-  } else if (std::isnan(d.doubleBytes)) {
-    d.longBytes = 0x7ff8000000000000L; // canonicalize NaN using value from Java's Double.doubleToLongBits()
-  }
+  const int64_t val = canonical_double(datum);
   HashState hashResult;
-  HllUtil<A>::hash(&d, sizeof(double), DEFAULT_SEED, hashResult);
+  HllUtil<A>::hash(&val, sizeof(int64_t), DEFAULT_SEED, hashResult);
   coupon_update(HllUtil<A>::coupon(hashResult));
 }
 
 template<typename A>
 void hll_sketch_alloc<A>::update(float datum) {
-  longDoubleUnion d;
-  d.doubleBytes = static_cast<double>(datum);
-  if (datum == 0.0) {
-    d.doubleBytes = 0.0; // canonicalize -0.0 to 0.0
-  } else if (std::isnan(d.doubleBytes)) {
-    d.longBytes = 0x7ff8000000000000L; // canonicalize NaN using value from Java's Double.doubleToLongBits()
-  }
-  HashState hashResult;
-  HllUtil<A>::hash(&d, sizeof(double), DEFAULT_SEED, hashResult);
-  coupon_update(HllUtil<A>::coupon(hashResult));
+  update(static_cast<double>(datum));
 }
 
 template<typename A>
@@ -211,6 +191,40 @@ void hll_sketch_alloc<A>::update(const void* data, size_t lengthBytes) {
   coupon_update(HllUtil<A>::coupon(hashResult));
 }
 
+template<typename A>
+void hll_sketch_alloc<A>::update_batch(const uint64_t* data, size_t num_items) {
+  update_batch_keys(data, num_items);
+}
+
+template<typename A>
+void hll_sketch_alloc<A>::update_batch(const int64_t* data, size_t num_items) {
+  update_batch_keys(reinterpret_cast<const uint64_t*>(data), num_items);
+}
+
+template<typename A>
+void hll_sketch_alloc<A>::update_batch(const double* data, size_t num_items) {
+  uint64_t keys[HASH_BATCH_SIZE];
+  while (num_items > 0) {
+    const uint8_t block_size = static_cast<uint8_t>(num_items < HASH_BATCH_SIZE ? num_items : HASH_BATCH_SIZE);
+    for (uint8_t i = 0; i < block_size; ++i) keys[i] = canonical_double(data[i]);
+    update_batch_keys(keys, block_size);
+    data += block_size;
+    num_items -= block_size;
+  }
+}
+
+template<typename A>
+void hll_sketch_alloc<A>::update_batch_keys(const uint64_t* keys, size_t num_keys) {
+  HashState hashes[HASH_BATCH_SIZE];
+  while (num_keys > 0) {
+    const uint8_t block_size = static_cast<uint8_t>(num_keys < HASH_BATCH_SIZE ? num_keys : HASH_BATCH_SIZE);
+    MurmurHash3_x64_128_batch(keys, block_size, DEFAULT_SEED, hashes);
+    for (uint8_t i = 0; i < block_size; ++i) coupon_update(HllUtil<A>::coupon(hashes[i]));
+    keys += block_size;
+    num_keys -= block_size;
+  }
+}
+
 template<typename A>
 void hll_sketch_alloc<A>::coupon_update(uint32_t coupon) {
   if (coupon == hll_constants::EMPTY) { return; }
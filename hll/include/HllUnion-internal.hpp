@@ -23,11 +23,14 @@
 #include "hll.hpp"
 
 #include "HllSketchImpl.hpp"
+#include "HllSketchImplFactory.hpp"
 #include "HllArray.hpp"
 #include "HllUtil.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace datasketches {
 
@@ -59,6 +62,158 @@ void hll_union_alloc<A>::update(hll_sketch_alloc<A>&& sketch) {
   union_impl(sketch, lg_max_k_);
 }
 
+template<typename A>
+void hll_union_alloc<A>::update(const wrapped_hll_sketch_alloc<A>& sketch) {
+  if (sketch.is_empty()) return;
+  if (sketch.mode_ != HLL) {
+    if (gadget_.is_empty() && sketch.lg_config_k_ == gadget_.get_lg_config_k()) {
+      // same as the copy in union_impl() to keep the layout of a hash set, coupon modes are small
+      HllSketchImpl<A>* src_impl = HllSketchImplFactory<A>::deserialize(sketch.bytes_, sketch.size_,
+          gadget_.sketch_impl->getAllocator());
+      if (src_impl->getTgtHllType() != HLL_8) {
+        HllSketchImpl<A>* copy = nullptr;
+        try {
+          copy = src_impl->copyAs(HLL_8);
+        } catch (...) {
+          src_impl->get_deleter()(src_impl);
+          throw;
+        }
+        src_impl->get_deleter()(src_impl);
+        src_impl = copy;
+      }
+      gadget_.sketch_impl->get_deleter()(gadget_.sketch_impl); // gadget to be replaced
+      gadget_.sketch_impl = src_impl; // gadget replaced
+      return;
+    }
+    // a list is packed at the start of its array, a hash set has empty slots
+    const uint32_t num_coupons = sketch.mode_ == LIST ? sketch.coupon_count_ : sketch.num_coupon_slots_;
+    for (uint32_t i = 0; i < num_coupons; ++i) coupon_update(sketch.get_coupon(i));
+    return;
+  }
+  HllSketchImpl<A>* dst_impl = gadget_.sketch_impl;
+  if (dst_impl->getCurMode() == HLL && !dst_impl->isEmpty()) {
+    if (sketch.lg_config_k_ < dst_impl->getLgConfigK()) {
+      dst_impl = copy_or_downsample(dst_impl, sketch.lg_config_k_);
+      gadget_.sketch_impl->get_deleter()(gadget_.sketch_impl); // gadget to be replaced
+      gadget_.sketch_impl = dst_impl; // gadget replaced
+    }
+    Hll8Array<A>* dst = static_cast<Hll8Array<A>*>(dst_impl);
+    merge_wrapped(*dst, sketch);
+    dst->setRebuildKxqCurminFlag(true);
+    dst->putOutOfOrderFlag(true);
+    dst->putHipAccum(0);
+  } else {
+    // equivalent of copy_or_downsample() of the source into a new gadget
+    typedef typename std::allocator_traits<A>::template rebind_alloc<Hll8Array<A>> hll8Alloc;
+    const A allocator = dst_impl->getAllocator();
+    const bool downsample = sketch.lg_config_k_ > lg_max_k_;
+    const uint8_t lg_k = downsample ? lg_max_k_ : sketch.lg_config_k_;
+    Hll8Array<A>* dst = new (hll8Alloc(allocator).allocate(1))
+        Hll8Array<A>(lg_k, !downsample && sketch.start_full_size_, allocator);
+    merge_wrapped(*dst, sketch);
+    if (!downsample && sketch.tgt_type_ == HLL_8) {
+      // a plain copy, the header state is taken as is
+      dst->putKxQ0(sketch.kxq0_);
+      dst->putKxQ1(sketch.kxq1_);
+      dst->putCurMin(sketch.cur_min_);
+      dst->putNumAtCurMin(sketch.num_at_cur_min_);
+    } else {
+      dst->setRebuildKxqCurminFlag(true);
+      dst->check_rebuild_kxq_cur_min();
+      if (!downsample && dst->getCurMin() > 0) {
+        // conversion to HLL_8 keeps cur_min at zero and counts zeros
+        dst->putCurMin(0);
+        dst->putNumAtCurMin(0);
+      }
+    }
+    //both of these are required for isomorphism
+    dst->putHipAccum(sketch.hip_accum_);
+    dst->putOutOfOrderFlag(sketch.ooo_flag_);
+    if (!dst_impl->isEmpty()) { // gadget is LIST or SET
+      dst->mergeList(*static_cast<const CouponList<A>*>(dst_impl));
+    }
+    gadget_.sketch_impl->get_deleter()(gadget_.sketch_impl); // gadget to be replaced
+    gadget_.sketch_impl = dst; // gadget replaced
+  }
+}
+
+template<typename A>
+void hll_union_alloc<A>::merge_wrapped(Hll8Array<A>& dst, const wrapped_hll_sketch_alloc<A>& sketch) {
+  dst.mergeHllBytes(sketch.tgt_type_, sketch.lg_config_k_, sketch.registers_, sketch.cur_min_);
+  // exceptions of HLL_4
+  for (uint32_t i = 0; i < sketch.num_coupon_slots_; ++i) {
+    const uint32_t coupon = sketch.get_coupon(i);
+    if (coupon != hll_constants::EMPTY) dst.mergeCoupon(coupon);
+  }
+}
+
+template<typename A>
+template<typename ForwardIt>
+void hll_union_alloc<A>::update_many(ForwardIt first, ForwardIt last) {
+  using HllArrayPtrAlloc = typename std::allocator_traits<A>::template rebind_alloc<const HllArray<A>*>;
+  using CouponListPtrAlloc = typename std::allocator_traits<A>::template rebind_alloc<const CouponList<A>*>;
+  std::vector<const HllArray<A>*, HllArrayPtrAlloc> hll_arrays(gadget_.sketch_impl->getAllocator());
+  std::vector<const CouponList<A>*, CouponListPtrAlloc> coupon_lists(gadget_.sketch_impl->getAllocator());
+  uint8_t lg_k = lg_max_k_;
+  for (ForwardIt it = first; it != last; ++it) {
+    const hll_sketch_alloc<A>& sketch = *it;
+    if (sketch.is_empty()) continue;
+    if (sketch.get_current_mode() == HLL) {
+      hll_arrays.push_back(static_cast<const HllArray<A>*>(sketch.sketch_impl));
+      lg_k = std::min(lg_k, sketch.get_lg_config_k());
+    } else {
+      coupon_lists.push_back(static_cast<const CouponList<A>*>(sketch.sketch_impl));
+    }
+  }
+  if (hll_arrays.size() < 2) {
+    for (; first != last; ++first) {
+      const hll_sketch_alloc<A>& sketch = *first;
+      update(sketch);
+    }
+    return;
+  }
+
+  // bring the gadget to HLL mode with the final lg_k before merging
+  HllSketchImpl<A>* dst_impl = gadget_.sketch_impl;
+  if (dst_impl->getCurMode() == HLL) {
+    if (dst_impl->getLgConfigK() > lg_k) {
+      dst_impl = copy_or_downsample(dst_impl, lg_k);
+      gadget_.sketch_impl->get_deleter()(gadget_.sketch_impl); // gadget to be replaced
+    } else {
+      lg_k = dst_impl->getLgConfigK();
+    }
+  } else {
+    typedef typename std::allocator_traits<A>::template rebind_alloc<Hll8Array<A>> hll8Alloc;
+    const A allocator = dst_impl->getAllocator();
+    Hll8Array<A>* hll8 = new (hll8Alloc(allocator).allocate(1)) Hll8Array<A>(lg_k, false, allocator);
+    if (!dst_impl->isEmpty()) hll8->mergeList(*static_cast<const CouponList<A>*>(dst_impl));
+    gadget_.sketch_impl->get_deleter()(gadget_.sketch_impl); // gadget to be replaced
+    dst_impl = hll8;
+  }
+  gadget_.sketch_impl = dst_impl; // gadget replaced
+
+  Hll8Array<A>* dst = static_cast<Hll8Array<A>*>(dst_impl);
+  const uint32_t k = 1 << lg_k;
+  const uint32_t block_slots = std::min(k, hll_constants::MERGE_BLOCK_SLOTS);
+  for (uint32_t slot = 0; slot < k; slot += block_slots) {
+    for (const HllArray<A>* src: hll_arrays) dst->mergeHllSlots(*src, slot, block_slots);
+  }
+  // sketches in LIST or SET mode go in as coupons
+  for (const CouponList<A>* src: coupon_lists) {
+    for (const auto coupon: *src) dst->mergeCoupon(coupon);
+  }
+  dst->setRebuildKxqCurminFlag(true);
+  // cur_min must be valid right away, otherwise the gadget looks empty to union_impl
+  dst->check_rebuild_kxq_cur_min();
+  if (dst->getCurMin() > 0) {
+    // HLL_8 keeps cur_min at zero and counts zeros
+    dst->putCurMin(0);
+    dst->putNumAtCurMin(0);
+  }
+  dst->putOutOfOrderFlag(true);
+  dst->putHipAccum(0);
+}
+
 template<typename A>
 void hll_union_alloc<A>::update(const std::string& datum) {
   gadget_.update(datum);
@@ -121,8 +276,8 @@ void hll_union_alloc<A>::update(const void* data, size_t length_bytes) {
 
 template<typename A>
 void hll_union_alloc<A>::coupon_update(uint32_t coupon) {
-  if (coupon == HllUtil<A>::EMPTY) { return; }
-  HllSketchImpl<A>* result = gadget_.sketch_impl->coupon_update(coupon);
+  if (coupon == hll_constants::EMPTY) { return; }
+  HllSketchImpl<A>* result = gadget_.sketch_impl->couponUpdate(coupon);
   if (result != gadget_.sketch_impl) {
     if (gadget_.sketch_impl != nullptr) { gadget_.sketch_impl->get_deleter()(gadget_.sketch_impl); }
     gadget_.sketch_impl = result;
@@ -211,6 +366,8 @@ HllSketchImpl<A>* hll_union_alloc<A>::copy_or_downsample(const HllSketchImpl<A>*
   typedef typename std::allocator_traits<A>::template rebind_alloc<Hll8Array<A>> hll8Alloc;
   Hll8Array<A>* tgtHllArr = new (hll8Alloc(src->getAllocator()).allocate(1)) Hll8Array<A>(tgt_lg_k, false, src->getAllocator());
   tgtHllArr->mergeHll(*src);
+  // cur_min must be valid right away, otherwise the new gadget looks empty to union_impl
+  tgtHllArr->check_rebuild_kxq_cur_min();
   //both of these are required for isomorphism
   tgtHllArr->putHipAccum(src->getHipAccum());
   tgtHllArr->putOutOfOrderFlag(src->isOutOfOrderFlag());
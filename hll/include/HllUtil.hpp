@@ -92,6 +92,9 @@ static const uint8_t LG_INIT_SET_SIZE = 5;
 static const uint32_t RESIZE_NUMER = 3;
 static const uint32_t RESIZE_DENOM = 4;
 
+// number of union registers merged from all sketches at a time in hll_union::update_many()
+static const uint32_t MERGE_BLOCK_SLOTS = 4096;
+
 static const uint8_t loNibbleMask = 0x0f;
 static const uint8_t hiNibbleMask = 0xf0;
 static const uint8_t AUX_TOKEN = 0xf;
@@ -0,0 +1,185 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _WRAPPEDHLLSKETCH_INTERNAL_HPP_
+#define _WRAPPEDHLLSKETCH_INTERNAL_HPP_
+
+#include "hll.hpp"
+
+#include "CouponList.hpp"
+#include "HllArray.hpp"
+#include "HllSketchImpl.hpp"
+#include "HllUtil.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace datasketches {
+
+template<typename A>
+wrapped_hll_sketch_alloc<A>::wrapped_hll_sketch_alloc():
+bytes_(nullptr),
+size_(0),
+mode_(LIST),
+tgt_type_(HLL_4),
+lg_config_k_(0),
+compact_(false),
+ooo_flag_(false),
+start_full_size_(false),
+coupon_count_(0),
+coupons_(nullptr),
+num_coupon_slots_(0),
+registers_(nullptr),
+cur_min_(0),
+num_at_cur_min_(0),
+hip_accum_(0),
+kxq0_(0),
+kxq1_(0)
+{}
+
+template<typename A>
+wrapped_hll_sketch_alloc<A> wrapped_hll_sketch_alloc<A>::wrap(const void* bytes, size_t size) {
+  if (size < hll_constants::EMPTY_SKETCH_SIZE_BYTES) {
+    throw std::out_of_range("Input data length insufficient to hold HLL sketch");
+  }
+  const uint8_t* data = static_cast<const uint8_t*>(bytes);
+  if (data[hll_constants::SER_VER_BYTE] != hll_constants::SER_VER) {
+    throw std::invalid_argument("Wrong ser ver in input stream");
+  }
+  if (data[hll_constants::FAMILY_BYTE] != hll_constants::FAMILY_ID) {
+    throw std::invalid_argument("Input array is not an HLL sketch");
+  }
+
+  wrapped_hll_sketch_alloc sketch;
+  sketch.bytes_ = data;
+  sketch.size_ = size;
+  sketch.mode_ = HllSketchImpl<A>::extractCurMode(data[hll_constants::MODE_BYTE]);
+  sketch.tgt_type_ = HllSketchImpl<A>::extractTgtHllType(data[hll_constants::MODE_BYTE]);
+  sketch.lg_config_k_ = HllUtil<A>::checkLgK(data[hll_constants::LG_K_BYTE]);
+  sketch.compact_ = (data[hll_constants::FLAGS_BYTE] & hll_constants::COMPACT_FLAG_MASK) ? true : false;
+  sketch.ooo_flag_ = (data[hll_constants::FLAGS_BYTE] & hll_constants::OUT_OF_ORDER_FLAG_MASK) ? true : false;
+  sketch.start_full_size_ = (data[hll_constants::FLAGS_BYTE] & hll_constants::FULL_SIZE_FLAG_MASK) ? true : false;
+
+  const uint8_t expected_pre_ints = sketch.mode_ == LIST ? hll_constants::LIST_PREINTS
+      : (sketch.mode_ == SET ? hll_constants::HASH_SET_PREINTS : hll_constants::HLL_PREINTS);
+  if (data[hll_constants::PREAMBLE_INTS_BYTE] != expected_pre_ints) {
+    throw std::invalid_argument("Incorrect number of preInts in input stream");
+  }
+
+  size_t coupons_start;
+  if (sketch.mode_ == LIST) {
+    sketch.coupon_count_ = data[hll_constants::LIST_COUNT_BYTE];
+    sketch.num_coupon_slots_ = sketch.compact_ ? sketch.coupon_count_
+        : 1 << HllUtil<A>::computeLgArrInts(LIST, sketch.coupon_count_, sketch.lg_config_k_);
+    coupons_start = hll_constants::LIST_INT_ARR_START;
+  } else if (sketch.mode_ == SET) {
+    if (size < hll_constants::HASH_SET_INT_ARR_START) {
+      throw std::out_of_range("Input data length insufficient to hold CouponHashSet");
+    }
+    std::memcpy(&sketch.coupon_count_, data + hll_constants::HASH_SET_COUNT_INT, sizeof(uint32_t));
+    uint8_t lg_arr_ints = data[hll_constants::LG_ARR_BYTE];
+    if (lg_arr_ints < hll_constants::LG_INIT_SET_SIZE) {
+      lg_arr_ints = HllUtil<A>::computeLgArrInts(SET, sketch.coupon_count_, sketch.lg_config_k_);
+    }
+    sketch.num_coupon_slots_ = sketch.compact_ ? sketch.coupon_count_ : 1 << lg_arr_ints;
+    coupons_start = hll_constants::HASH_SET_INT_ARR_START;
+  } else { // HLL
+    const uint32_t array_bytes = HllArray<A>::hllArrBytes(sketch.tgt_type_, sketch.lg_config_k_);
+    if (size < hll_constants::HLL_BYTE_ARR_START + array_bytes) {
+      throw std::out_of_range("Input array too small to hold sketch image");
+    }
+    sketch.cur_min_ = data[hll_constants::HLL_CUR_MIN_BYTE];
+    std::memcpy(&sketch.hip_accum_, data + hll_constants::HIP_ACCUM_DOUBLE, sizeof(double));
+    std::memcpy(&sketch.kxq0_, data + hll_constants::KXQ0_DOUBLE, sizeof(double));
+    std::memcpy(&sketch.kxq1_, data + hll_constants::KXQ1_DOUBLE, sizeof(double));
+    if (sketch.ooo_flag_) sketch.hip_accum_ = 0;
+    std::memcpy(&sketch.num_at_cur_min_, data + hll_constants::CUR_MIN_COUNT_INT, sizeof(uint32_t));
+    uint32_t aux_count;
+    std::memcpy(&aux_count, data + hll_constants::AUX_COUNT_INT, sizeof(uint32_t));
+    sketch.registers_ = data + hll_constants::HLL_BYTE_ARR_START;
+    if (aux_count > 0) { // necessarily HLL_4
+      sketch.num_coupon_slots_ = sketch.compact_ ? aux_count : 1 << data[hll_constants::LG_ARR_BYTE];
+    }
+    coupons_start = hll_constants::HLL_BYTE_ARR_START + array_bytes;
+  }
+  const size_t expected_size = coupons_start + sketch.num_coupon_slots_ * sizeof(uint32_t);
+  if (size < expected_size) {
+    throw std::out_of_range("Byte array too short for sketch. Expected " + std::to_string(expected_size)
+                                + ", found: " + std::to_string(size));
+  }
+  sketch.coupons_ = data + coupons_start;
+  return sketch;
+}
+
+template<typename A>
+double wrapped_hll_sketch_alloc<A>::get_estimate() const {
+  if (mode_ != HLL) return CouponList<A>::estimate(coupon_count_);
+  return ooo_flag_ ? get_composite_estimate() : hip_accum_;
+}
+
+template<typename A>
+double wrapped_hll_sketch_alloc<A>::get_composite_estimate() const {
+  if (mode_ != HLL) return CouponList<A>::estimate(coupon_count_);
+  return HllArray<A>::compositeEstimate(lg_config_k_, kxq0_ + kxq1_, cur_min_, num_at_cur_min_);
+}
+
+template<typename A>
+double wrapped_hll_sketch_alloc<A>::get_lower_bound(uint8_t num_std_dev) const {
+  if (mode_ != HLL) return CouponList<A>::lowerBound(coupon_count_, num_std_dev);
+  return HllArray<A>::lowerBound(lg_config_k_, ooo_flag_, cur_min_, num_at_cur_min_, get_estimate(), num_std_dev);
+}
+
+template<typename A>
+double wrapped_hll_sketch_alloc<A>::get_upper_bound(uint8_t num_std_dev) const {
+  if (mode_ != HLL) return CouponList<A>::upperBound(coupon_count_, num_std_dev);
+  return HllArray<A>::upperBound(lg_config_k_, ooo_flag_, get_estimate(), num_std_dev);
+}
+
+template<typename A>
+uint8_t wrapped_hll_sketch_alloc<A>::get_lg_config_k() const {
+  return lg_config_k_;
+}
+
+template<typename A>
+target_hll_type wrapped_hll_sketch_alloc<A>::get_target_type() const {
+  return tgt_type_;
+}
+
+template<typename A>
+bool wrapped_hll_sketch_alloc<A>::is_compact() const {
+  return compact_;
+}
+
+template<typename A>
+bool wrapped_hll_sketch_alloc<A>::is_empty() const {
+  if (mode_ != HLL) return coupon_count_ == 0;
+  return cur_min_ == 0 && num_at_cur_min_ == (1U << lg_config_k_);
+}
+
+template<typename A>
+uint32_t wrapped_hll_sketch_alloc<A>::get_coupon(uint32_t index) const {
+  uint32_t coupon;
+  std::memcpy(&coupon, coupons_ + index * sizeof(uint32_t), sizeof(uint32_t));
+  return coupon;
+}
+
+}
+
+#endif // _WRAPPEDHLLSKETCH_INTERNAL_HPP_
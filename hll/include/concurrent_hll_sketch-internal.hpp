@@ -0,0 +1,164 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _CONCURRENT_HLL_SKETCH_INTERNAL_HPP_
+#define _CONCURRENT_HLL_SKETCH_INTERNAL_HPP_
+
+#include "concurrent_hll_sketch.hpp"
+
+namespace datasketches {
+
+template<typename A>
+concurrent_hll_sketch_alloc<A>::concurrent_hll_sketch_alloc(uint8_t lg_config_k, const A& allocator):
+lg_config_k_(HllUtil<A>::checkLgK(lg_config_k)),
+is_empty_(true),
+registers_(1 << lg_config_k, AllocRegister(allocator)) // value-initialized to zero
+{}
+
+template<typename A>
+void concurrent_hll_sketch_alloc<A>::update(const std::string& datum) {
+  if (datum.empty()) { return; }
+  update(datum.c_str(), datum.length());
+}
+
+template<typename A>
+void concurrent_hll_sketch_alloc<A>::update(uint64_t datum) {
+  update(&datum, sizeof(uint64_t));
+}
+
+template<typename A>
+void concurrent_hll_sketch_alloc<A>::update(uint32_t datum) {
+  update(static_cast<int32_t>(datum));
+}
+
+template<typename A>
+void concurrent_hll_sketch_alloc<A>::update(uint16_t datum) {
+  update(static_cast<int16_t>(datum));
+}
+
+template<typename A>
+void concurrent_hll_sketch_alloc<A>::update(uint8_t datum) {
+  update(static_cast<int8_t>(datum));
+}
+
+template<typename A>
+void concurrent_hll_sketch_alloc<A>::update(int64_t datum) {
+  update(&datum, sizeof(int64_t));
+}
+
+template<typename A>
+void concurrent_hll_sketch_alloc<A>::update(int32_t datum) {
+  update(static_cast<int64_t>(datum));
+}
+
+template<typename A>
+void concurrent_hll_sketch_alloc<A>::update(int16_t datum) {
+  update(static_cast<int64_t>(datum));
+}
+
+template<typename A>
+void concurrent_hll_sketch_alloc<A>::update(int8_t datum) {
+  update(static_cast<int64_t>(datum));
+}
+
+template<typename A>
+void concurrent_hll_sketch_alloc<A>::update(double datum) {
+  const int64_t val = canonical_double(datum);
+  update(&val, sizeof(int64_t));
+}
+
+template<typename A>
+void concurrent_hll_sketch_alloc<A>::update(float datum) {
+  update(static_cast<double>(datum));
+}
+
+template<typename A>
+void concurrent_hll_sketch_alloc<A>::update(const void* data, size_t length_bytes) {
+  if (data == nullptr) { return; }
+  HashState hashResult;
+  HllUtil<A>::hash(data, length_bytes, DEFAULT_SEED, hashResult);
+  coupon_update(HllUtil<A>::coupon(hashResult));
+}
+
+template<typename A>
+void concurrent_hll_sketch_alloc<A>::coupon_update(uint32_t coupon) {
+  // avoid writing the shared flag on every update
+  if (is_empty_.load(std::memory_order_relaxed)) is_empty_.store(false, std::memory_order_relaxed);
+  const uint32_t slot = HllUtil<A>::getLow26(coupon) & ((1 << lg_config_k_) - 1);
+  const uint8_t value = HllUtil<A>::getValue(coupon);
+  std::atomic<uint8_t>& reg = registers_[slot];
+  uint8_t current = reg.load(std::memory_order_relaxed);
+  // on failure current is reloaded, and the loop stops as soon as another thread has stored a larger value
+  while (value > current && !reg.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+template<typename A>
+bool concurrent_hll_sketch_alloc<A>::is_empty() const {
+  return is_empty_.load(std::memory_order_relaxed);
+}
+
+template<typename A>
+uint8_t concurrent_hll_sketch_alloc<A>::get_lg_config_k() const {
+  return lg_config_k_;
+}
+
+template<typename A>
+double concurrent_hll_sketch_alloc<A>::get_estimate() const {
+  return snapshot().get_estimate();
+}
+
+template<typename A>
+double concurrent_hll_sketch_alloc<A>::get_lower_bound(uint8_t num_std_dev) const {
+  return snapshot().get_lower_bound(num_std_dev);
+}
+
+template<typename A>
+double concurrent_hll_sketch_alloc<A>::get_upper_bound(uint8_t num_std_dev) const {
+  return snapshot().get_upper_bound(num_std_dev);
+}
+
+template<typename A>
+hll_sketch_alloc<A> concurrent_hll_sketch_alloc<A>::get_result(target_hll_type tgt_type) const {
+  if (tgt_type == HLL_8) return snapshot();
+  return hll_sketch_alloc<A>(snapshot(), tgt_type);
+}
+
+template<typename A>
+A concurrent_hll_sketch_alloc<A>::get_allocator() const {
+  return A(registers_.get_allocator());
+}
+
+template<typename A>
+hll_sketch_alloc<A> concurrent_hll_sketch_alloc<A>::snapshot() const {
+  const A allocator = get_allocator();
+  if (is_empty()) return hll_sketch_alloc<A>(lg_config_k_, HLL_8, false, allocator);
+  typedef typename std::allocator_traits<A>::template rebind_alloc<Hll8Array<A>> hll8Alloc;
+  Hll8Array<A>* hll8 = new (hll8Alloc(allocator).allocate(1)) Hll8Array<A>(lg_config_k_, true, allocator);
+  const uint32_t k = 1 << lg_config_k_;
+  for (uint32_t i = 0; i < k; ++i) hll8->putSlot(i, registers_[i].load(std::memory_order_relaxed));
+  // the HIP estimator is not valid, kxq and cur_min are computed from the registers
+  hll8->putOutOfOrderFlag(true);
+  hll8->setRebuildKxqCurminFlag(true);
+  hll8->check_rebuild_kxq_cur_min();
+  return hll_sketch_alloc<A>(hll8);
+}
+
+} // namespace datasketches
+
+#endif // _CONCURRENT_HLL_SKETCH_INTERNAL_HPP_
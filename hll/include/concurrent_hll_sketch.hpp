@@ -0,0 +1,202 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _CONCURRENT_HLL_SKETCH_HPP_
+#define _CONCURRENT_HLL_SKETCH_HPP_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "hll.hpp"
+
+namespace datasketches {
+
+// forward declaration
+template<typename A> class concurrent_hll_sketch_alloc;
+
+/// Concurrent HLL sketch alias with default allocator
+using concurrent_hll_sketch = concurrent_hll_sketch_alloc<std::allocator<uint8_t>>;
+
+/**
+ * Concurrent HLL sketch.
+ * This sketch can be updated from multiple threads at the same time without locks.
+ * It always has the HLL_8 layout at full size: one byte register per slot,
+ * which is raised with an atomic compare-and-swap maximum on update.
+ *
+ * Since the order of updates across threads is not defined, the HIP estimator
+ * cannot be maintained. Like the result of a union, the estimate is computed from
+ * the registers at query time with the composite estimator, so queries cost
+ * a pass over the registers and are meant to be much less frequent than updates.
+ * Queries can run concurrently with updates and reflect a subset of the updates in flight.
+ *
+ * The result can be converted to a regular hll_sketch of any type with get_result().
+ */
+template<typename A = std::allocator<uint8_t>>
+class concurrent_hll_sketch_alloc {
+  public:
+    /**
+     * Constructs a new concurrent HLL sketch.
+     * @param lg_config_k Sketch can hold 2^lg_config_k rows, from 4 to 21 inclusive
+     * @param allocator instance of an Allocator
+     */
+    explicit concurrent_hll_sketch_alloc(uint8_t lg_config_k, const A& allocator = A());
+
+    concurrent_hll_sketch_alloc(const concurrent_hll_sketch_alloc& other) = delete;
+    concurrent_hll_sketch_alloc& operator=(const concurrent_hll_sketch_alloc& other) = delete;
+
+    /**
+     * Present the given std::string as a potential unique item.
+     * The string is converted to a byte array using UTF8 encoding.
+     * If the string is null or empty no update attempt is made and the method returns.
+     * @param datum The given string.
+     */
+    void update(const std::string& datum);
+
+    /**
+     * Present the given unsigned 64-bit integer as a potential unique item.
+     * @param datum The given integer.
+     */
+    void update(uint64_t datum);
+
+    /**
+     * Present the given unsigned 32-bit integer as a potential unique item.
+     * @param datum The given integer.
+     */
+    void update(uint32_t datum);
+
+    /**
+     * Present the given unsigned 16-bit integer as a potential unique item.
+     * @param datum The given integer.
+     */
+    void update(uint16_t datum);
+
+    /**
+     * Present the given unsigned 8-bit integer as a potential unique item.
+     * @param datum The given integer.
+     */
+    void update(uint8_t datum);
+
+    /**
+     * Present the given signed 64-bit integer as a potential unique item.
+     * @param datum The given integer.
+     */
+    void update(int64_t datum);
+
+    /**
+     * Present the given signed 32-bit integer as a potential unique item.
+     * @param datum The given integer.
+     */
+    void update(int32_t datum);
+
+    /**
+     * Present the given signed 16-bit integer as a potential unique item.
+     * @param datum The given integer.
+     */
+    void update(int16_t datum);
+
+    /**
+     * Present the given signed 8-bit integer as a potential unique item.
+     * @param datum The given integer.
+     */
+    void update(int8_t datum);
+
+    /**
+     * Present the given 64-bit floating point value as a potential unique item.
+     * @param datum The given double.
+     */
+    void update(double datum);
+
+    /**
+     * Present the given 32-bit floating point value as a potential unique item.
+     * @param datum The given float.
+     */
+    void update(float datum);
+
+    /**
+     * Present the given data array as a potential unique item.
+     * @param data The given array.
+     * @param length_bytes The array length in bytes.
+     */
+    void update(const void* data, size_t length_bytes);
+
+    /**
+     * Indicates if the sketch has not seen any updates.
+     * @return True if the sketch is empty
+     */
+    bool is_empty() const;
+
+    /**
+     * Returns sketch's configured lg_k value.
+     * @return Configured lg_k value.
+     */
+    uint8_t get_lg_config_k() const;
+
+    /**
+     * Returns the current cardinality estimate computed from the registers
+     * @return the cardinality estimate
+     */
+    double get_estimate() const;
+
+    /**
+     * Returns the approximate lower error bound given the specified
+     * number of standard deviations.
+     * @param num_std_dev Number of standard deviations, an integer from the set  {1, 2, 3}.
+     * @return The approximate lower bound.
+     */
+    double get_lower_bound(uint8_t num_std_dev) const;
+
+    /**
+     * Returns the approximate upper error bound given the specified
+     * number of standard deviations.
+     * @param num_std_dev Number of standard deviations, an integer from the set  {1, 2, 3}.
+     * @return The approximate upper bound.
+     */
+    double get_upper_bound(uint8_t num_std_dev) const;
+
+    /**
+     * Returns a snapshot of the current state as a regular sketch with the given target type.
+     * The result is out of order, the same as the result of a union.
+     * @param tgt_type The tgt_hll_type enum value of the desired result (Default: HLL_4)
+     * @return A snapshot of this sketch with the specified tgt_hll_type
+     */
+    hll_sketch_alloc<A> get_result(target_hll_type tgt_type = HLL_4) const;
+
+    /**
+     * @return allocator
+     */
+    A get_allocator() const;
+
+  private:
+    using AllocRegister = typename std::allocator_traits<A>::template rebind_alloc<std::atomic<uint8_t>>;
+
+    uint8_t lg_config_k_;
+    std::atomic<bool> is_empty_;
+    std::vector<std::atomic<uint8_t>, AllocRegister> registers_;
+
+    void coupon_update(uint32_t coupon);
+    hll_sketch_alloc<A> snapshot() const;
+};
+
+} // namespace datasketches
+
+#include "concurrent_hll_sketch-internal.hpp"
+
+#endif // _CONCURRENT_HLL_SKETCH_HPP_
@@ -33,11 +33,15 @@ namespace datasketches {
 // forward declarations
 template<typename A> class hll_sketch_alloc;
 template<typename A> class hll_union_alloc;
+template<typename A> class concurrent_hll_sketch_alloc;
+template<typename A> class wrapped_hll_sketch_alloc;
 
 /// HLL sketch alias with default allocator
 using hll_sketch = hll_sketch_alloc<std::allocator<uint8_t>>;
 /// HLL union alias with default allocator
 using hll_union = hll_union_alloc<std::allocator<uint8_t>>;
+/// Wrapped HLL sketch alias with default allocator
+using wrapped_hll_sketch = wrapped_hll_sketch_alloc<std::allocator<uint8_t>>;
 
 /**
  * Specifies the target type of HLL sketch to be created. It is a target in that the actual
@@ -108,8 +112,9 @@ enum target_hll_type {
  * author Kevin Lang
  */
 
-// forward declaration
+// forward declarations
 template<typename A> class HllSketchImpl;
+template<typename A> class Hll8Array;
 
 template<typename A = std::allocator<uint8_t> >
 class hll_sketch_alloc final {
@@ -303,6 +308,31 @@ class hll_sketch_alloc final {
      */
     void update(const void* data, size_t length_bytes);
 
+    /**
+     * Present a batch of unsigned 64-bit integers as potential unique items.
+     * The result is the same as calling update(uint64_t) for each item,
+     * but the items are hashed in blocks by a specialized 8-byte kernel.
+     * @param data The given array of items.
+     * @param num_items The number of items in the array.
+     */
+    void update_batch(const uint64_t* data, size_t num_items);
+
+    /**
+     * Present a batch of signed 64-bit integers as potential unique items.
+     * The result is the same as calling update(int64_t) for each item.
+     * @param data The given array of items.
+     * @param num_items The number of items in the array.
+     */
+    void update_batch(const int64_t* data, size_t num_items);
+
+    /**
+     * Present a batch of 64-bit floating point values as potential unique items.
+     * The result is the same as calling update(double) for each item.
+     * @param data The given array of items.
+     * @param num_items The number of items in the array.
+     */
+    void update_batch(const double* data, size_t num_items);
+
     /**
      * Returns the current cardinality estimate
      * @return the cardinality estimate
@@ -401,9 +431,12 @@ class hll_sketch_alloc final {
                               uint8_t lg_config_k, uint8_t num_std_dev);
 
   private:
+    static const uint8_t HASH_BATCH_SIZE = 16;
+
     explicit hll_sketch_alloc(HllSketchImpl<A>* that);
 
     void coupon_update(uint32_t coupon);
+    void update_batch_keys(const uint64_t* keys, size_t num_keys);
 
     std::string type_as_string() const;
     std::string mode_as_string() const;
@@ -415,6 +448,108 @@ class hll_sketch_alloc final {
 
     HllSketchImpl<A>* sketch_impl;
     friend hll_union_alloc<A>;
+    friend concurrent_hll_sketch_alloc<A>;
+};
+
+/**
+ * Read-only view of a serialized HLL sketch.
+ * This can wrap a compact or updatable image of any target type and mode
+ * as produced by hll_sketch::serialize_compact() or hll_sketch::serialize_updatable().
+ * Nothing is copied or allocated: the estimate and bounds are computed from the header,
+ * and hll_union reads the registers or coupons directly from the buffer
+ * (except for a sketch in LIST or SET mode going into an empty union, which is copied as is).
+ * The union ends up in the same state as with a deserialized copy of the sketch.
+ * The buffer must outlive the view.
+ */
+template<typename A = std::allocator<uint8_t>>
+class wrapped_hll_sketch_alloc {
+  public:
+    /**
+     * This method wraps a serialized HLL sketch.
+     * @param bytes pointer to a serialized sketch image
+     * @param size the size of the image in bytes
+     * @return an instance of the wrapped sketch
+     */
+    static wrapped_hll_sketch_alloc wrap(const void* bytes, size_t size);
+
+    /**
+     * Returns the current cardinality estimate
+     * @return the cardinality estimate
+     */
+    double get_estimate() const;
+
+    /**
+     * This is less accurate than the get_estimate() method and is automatically used
+     * when the sketch has gone through union operations where the more accurate HIP
+     * estimator cannot be used.
+     * @return the composite cardinality estimate
+     */
+    double get_composite_estimate() const;
+
+    /**
+     * Returns the approximate lower error bound given the specified
+     * number of standard deviations.
+     * @param num_std_dev Number of standard deviations, an integer from the set  {1, 2, 3}.
+     * @return The approximate lower bound.
+     */
+    double get_lower_bound(uint8_t num_std_dev) const;
+
+    /**
+     * Returns the approximate upper error bound given the specified
+     * number of standard deviations.
+     * @param num_std_dev Number of standard deviations, an integer from the set  {1, 2, 3}.
+     * @return The approximate upper bound.
+     */
+    double get_upper_bound(uint8_t num_std_dev) const;
+
+    /**
+     * Returns sketch's configured lg_k value.
+     * @return Configured lg_k value.
+     */
+    uint8_t get_lg_config_k() const;
+
+    /**
+     * Returns the sketch's target HLL mode (from #target_hll_type).
+     * @return The sketch's target HLL mode.
+     */
+    target_hll_type get_target_type() const;
+
+    /**
+     * Indicates if the sketch is currently stored compacted.
+     * @return True if the sketch is stored in compact form.
+     */
+    bool is_compact() const;
+
+    /**
+     * Indicates if the sketch is currently empty.
+     * @return True if the sketch is empty.
+     */
+    bool is_empty() const;
+
+  private:
+    wrapped_hll_sketch_alloc();
+
+    uint32_t get_coupon(uint32_t index) const;
+
+    const uint8_t* bytes_;
+    size_t size_;
+    hll_mode mode_;
+    target_hll_type tgt_type_;
+    uint8_t lg_config_k_;
+    bool compact_;
+    bool ooo_flag_;
+    bool start_full_size_;
+    uint32_t coupon_count_; // LIST and SET modes
+    const uint8_t* coupons_; // coupons in LIST and SET modes, exceptions of HLL_4
+    uint32_t num_coupon_slots_; // empty slots are zero
+    const uint8_t* registers_; // HLL mode
+    uint8_t cur_min_;
+    uint32_t num_at_cur_min_;
+    double hip_accum_;
+    double kxq0_;
+    double kxq1_;
+
+    friend hll_union_alloc<A>;
 };
 
 /**
@@ -531,6 +666,28 @@ class hll_union_alloc {
      * @param sketch The given sketch.
      */
     void update(hll_sketch_alloc<A>&& sketch);
+
+    /**
+     * Update this union operator with the given wrapped sketch.
+     * Registers or coupons are read directly from the wrapped buffer.
+     * @param sketch The given wrapped sketch.
+     */
+    void update(const wrapped_hll_sketch_alloc<A>& sketch);
+
+    /**
+     * Update this union operator with a range of sketches.
+     * The result is the same as updating with each sketch in turn, but sketches in HLL mode
+     * are merged in a single pass over the registers of the union, a block at a time
+     * from all sketches, and the union is reduced to the smallest lg_config_k in the range upfront.
+     * Coupons of sketches in LIST or SET mode are merged into the same registers directly.
+     * This pays off when unioning many sketches at once.
+     * If fewer than two sketches are in HLL mode, this falls back to updating one by one
+     * so that the HIP estimator is preserved when possible.
+     * @param first iterator to the first sketch (must dereference to hll_sketch_alloc)
+     * @param last iterator past the last sketch
+     */
+    template<typename ForwardIt>
+    void update_many(ForwardIt first, ForwardIt last);
   
     /**
      * Present the given std::string as a potential unique item.
@@ -634,6 +791,7 @@ class hll_union_alloc {
     inline void union_impl(const hll_sketch_alloc<A>& sketch, uint8_t lg_max_k);
 
     static HllSketchImpl<A>* copy_or_downsample(const HllSketchImpl<A>* src_impl, uint8_t tgt_lg_k);
+    static void merge_wrapped(Hll8Array<A>& dst, const wrapped_hll_sketch_alloc<A>& sketch);
 
     void coupon_update(uint32_t coupon);
 
@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "concurrent_hll_sketch.hpp"
+
+namespace datasketches {
+
+TEST_CASE("concurrent hll sketch: empty", "[concurrent_hll_sketch]") {
+  concurrent_hll_sketch sketch(12);
+  REQUIRE(sketch.is_empty());
+  REQUIRE(sketch.get_lg_config_k() == 12);
+  REQUIRE(sketch.get_estimate() == 0.0);
+  REQUIRE(sketch.get_lower_bound(1) == 0.0);
+  REQUIRE(sketch.get_upper_bound(1) == 0.0);
+  REQUIRE(sketch.get_result().is_empty());
+
+  REQUIRE_THROWS_AS(concurrent_hll_sketch(3), std::invalid_argument);
+}
+
+TEST_CASE("concurrent hll sketch: same registers as hll sketch", "[concurrent_hll_sketch]") {
+  for (int n: {10, 1000, 100000}) {
+    concurrent_hll_sketch sketch(12);
+    hll_sketch expected(12, HLL_8);
+    for (int i = 0; i < n; ++i) {
+      sketch.update(i);
+      expected.update(i);
+    }
+    sketch.update(std::string("a"));
+    expected.update(std::string("a"));
+    sketch.update(1.5);
+    expected.update(1.5);
+    REQUIRE_FALSE(sketch.is_empty());
+
+    if (n == 100000) { // the regular sketch is in HLL mode
+      // no HIP estimator, the composite estimate of the same registers
+      REQUIRE(sketch.get_estimate() == Approx(expected.get_composite_estimate()).epsilon(1e-10));
+    }
+    REQUIRE(sketch.get_estimate() == Approx(n + 2).margin((n + 2) * 0.05));
+    REQUIRE(sketch.get_lower_bound(2) < sketch.get_estimate());
+    REQUIRE(sketch.get_upper_bound(2) > sketch.get_estimate());
+
+    // a regular sketch in HLL mode from the start has every register
+    hll_sketch full(12, HLL_8, true);
+    for (int i = 0; i < n; ++i) full.update(i);
+    full.update(std::string("a"));
+    full.update(1.5);
+    const auto result_bytes = sketch.get_result(HLL_8).serialize_compact();
+    const auto full_bytes = full.serialize_compact();
+    REQUIRE(result_bytes.size() == full_bytes.size());
+    REQUIRE(std::equal(result_bytes.begin() + hll_constants::HLL_BYTE_ARR_START, result_bytes.end(),
+        full_bytes.begin() + hll_constants::HLL_BYTE_ARR_START));
+
+    const auto result = sketch.get_result(HLL_4);
+    REQUIRE(result.get_target_type() == HLL_4);
+    REQUIRE(result.get_lg_config_k() == 12);
+    REQUIRE(result.get_estimate() == Approx(sketch.get_estimate()).epsilon(1e-10));
+  }
+}
+
+TEST_CASE("concurrent hll sketch: multiple writers", "[concurrent_hll_sketch]") {
+  concurrent_hll_sketch sketch(14);
+  const int num_threads = 4;
+  const int n = 100000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&sketch, t, n]() {
+      // half overlap with the next thread
+      for (int i = 0; i < n; ++i) sketch.update(t * n / 2 + i);
+    });
+  }
+  for (auto& thread: threads) thread.join();
+
+  concurrent_hll_sketch expected(14);
+  for (int i = 0; i < (num_threads + 1) * n / 2; ++i) expected.update(i);
+  REQUIRE(sketch.get_result(HLL_8).serialize_updatable() == expected.get_result(HLL_8).serialize_updatable());
+  REQUIRE(sketch.get_estimate() == Approx((num_threads + 1) * n / 2).margin((num_threads + 1) * n / 2 * 0.05));
+}
+
+} /* namespace datasketches */
@@ -18,6 +18,8 @@
  */
 
 #include <stdexcept>
+#include <vector>
+#include <limits>
 
 #include "hll.hpp"
 
@@ -441,4 +443,60 @@ TEST_CASE("hll sketch: compact bytes serialize-deserialize-serialize set mode")
   REQUIRE(test_allocator_total_bytes == 0);
 }
 
+TEST_CASE("hll sketch: batch update", "[hll_sketch]") {
+  const size_t n = 10001; // not a multiple of the batch size
+  std::vector<uint64_t> unsigned_values(n);
+  std::vector<int64_t> signed_values(n);
+  std::vector<double> double_values(n);
+  for (size_t i = 0; i < n; ++i) {
+    unsigned_values[i] = i;
+    signed_values[i] = -static_cast<int64_t>(i);
+    double_values[i] = static_cast<double>(i) / 3;
+  }
+  double_values[1] = -0.0;
+  double_values[2] = std::numeric_limits<double>::quiet_NaN();
+
+  for (auto type: {target_hll_type::HLL_4, target_hll_type::HLL_6, target_hll_type::HLL_8}) {
+    hll_sketch sketch1(11, type);
+    for (auto value: unsigned_values) sketch1.update(value);
+    for (auto value: signed_values) sketch1.update(value);
+    for (auto value: double_values) sketch1.update(value);
+
+    hll_sketch sketch2(11, type);
+    sketch2.update_batch(unsigned_values.data(), n);
+    sketch2.update_batch(signed_values.data(), n);
+    sketch2.update_batch(double_values.data(), n);
+    sketch2.update_batch(double_values.data(), 0);
+
+    REQUIRE(sketch1.serialize_compact() == sketch2.serialize_compact());
+  }
+}
+
+TEST_CASE("hll sketch: wrap", "[hll_sketch]") {
+  for (auto type: {HLL_4, HLL_6, HLL_8}) {
+    for (int n: {0, 10, 500, 100000}) { // empty, list, set and hll modes
+      hll_sketch sketch(12, type);
+      for (int i = 0; i < n; ++i) sketch.update(i);
+      for (bool compact: {true, false}) {
+        const auto bytes = compact ? sketch.serialize_compact() : sketch.serialize_updatable();
+        const auto expected = hll_sketch::deserialize(bytes.data(), bytes.size());
+        const auto wrapped = wrapped_hll_sketch::wrap(bytes.data(), bytes.size());
+        REQUIRE(wrapped.is_empty() == expected.is_empty());
+        REQUIRE(wrapped.is_compact() == compact);
+        REQUIRE(wrapped.get_lg_config_k() == 12);
+        REQUIRE(wrapped.get_target_type() == type);
+        REQUIRE(wrapped.get_estimate() == expected.get_estimate());
+        REQUIRE(wrapped.get_composite_estimate() == expected.get_composite_estimate());
+        REQUIRE(wrapped.get_lower_bound(1) == expected.get_lower_bound(1));
+        REQUIRE(wrapped.get_upper_bound(2) == expected.get_upper_bound(2));
+        REQUIRE_THROWS_AS(wrapped_hll_sketch::wrap(bytes.data(), bytes.size() / 2), std::out_of_range);
+      }
+    }
+  }
+
+  auto bytes = hll_sketch(12).serialize_compact();
+  bytes[1] = 0; // ser ver
+  REQUIRE_THROWS_AS(wrapped_hll_sketch::wrap(bytes.data(), bytes.size()), std::invalid_argument);
+}
+
 } /* namespace datasketches */
@@ -18,8 +18,11 @@
  */
 
 #include <catch2/catch.hpp>
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 
 #include "hll.hpp"
 
@@ -187,6 +190,52 @@ TEST_CASE("hll union: check composite estimate", "[hll_union]") {
   REQUIRE(u.get_composite_estimate() == Approx(1000.0).margin(1000 * 0.03));
 }
 
+TEST_CASE("hll union: rebuilt estimator state matches direct updates", "[hll_union]") {
+  hll_sketch s1(12, HLL_8);
+  hll_sketch s2(12, HLL_4);
+  hll_sketch all(12, HLL_8);
+  for (int i = 0; i < 100000; ++i) { s1.update(i); all.update(i); }
+  for (int i = 100000; i < 200000; ++i) { s2.update(i); all.update(i); }
+  hll_union u(12);
+  u.update(s1);
+  u.update(s2);
+  const auto result = u.get_result(HLL_8);
+  REQUIRE(result.get_composite_estimate() == Approx(all.get_composite_estimate()).epsilon(1e-12));
+  const auto result4 = u.get_result(HLL_4);
+  REQUIRE(result4.get_composite_estimate() == Approx(all.get_composite_estimate()).epsilon(1e-12));
+}
+
+TEST_CASE("hll union: rebuilt kxq split", "[hll_union]") {
+  hll_sketch sketch(12, HLL_8);
+  for (int i = 0; i < 100000; ++i) sketch.update(i);
+  auto bytes = sketch.serialize_updatable();
+  bytes[hll_constants::HLL_BYTE_ARR_START] = 40; // a register that goes to kxq1
+  hll_sketch other(12, HLL_4);
+  for (int i = 100000; i < 200000; ++i) other.update(i);
+  hll_union u(12);
+  u.update(hll_sketch::deserialize(bytes.data(), bytes.size()));
+  u.update(other);
+  u.get_composite_estimate(); // rebuilds the estimator state from the registers, the result is then a copy
+  const auto result = u.get_result(HLL_8).serialize_updatable();
+  REQUIRE(result[hll_constants::HLL_BYTE_ARR_START] == 40);
+
+  // the baseline rebuild split: kxq0 starts at k, 2^-v - 1 of registers of 32 and above goes to kxq1
+  // (the incremental update splits differently, -1 to kxq0 and 2^-v to kxq1, the rebuild must not follow it)
+  double expected_kxq0 = 1 << 12;
+  double expected_kxq1 = 0;
+  for (uint32_t i = 0; i < (1 << 12); ++i) {
+    const uint8_t v = result[hll_constants::HLL_BYTE_ARR_START + i];
+    if (v == 0) continue;
+    if (v < 32) expected_kxq0 += 1.0 / (1ULL << v) - 1.0;
+    else expected_kxq1 += 1.0 / (1ULL << v) - 1.0;
+  }
+  double kxq0, kxq1;
+  std::memcpy(&kxq0, result.data() + hll_constants::KXQ0_DOUBLE, sizeof(double));
+  std::memcpy(&kxq1, result.data() + hll_constants::KXQ1_DOUBLE, sizeof(double));
+  REQUIRE(kxq0 == Approx(expected_kxq0).epsilon(1e-12));
+  REQUIRE(kxq1 == Approx(expected_kxq1).epsilon(1e-12));
+}
+
 TEST_CASE("hll union: check config k limits", "[hll_union]") {
   REQUIRE_THROWS_AS(hll_union(hll_constants::MIN_LOG_K - 1), std::invalid_argument);
 
@@ -314,4 +363,135 @@ TEST_CASE("hll union: check hll to hll", "[hll_union]") {
   union_two_sketches_with_overlap(1000000, 11, HLL_4);
 }
 
+TEST_CASE("hll union: merge into hll registers matches conversion to HLL_8", "[hll_union]") {
+  const uint8_t lg_k = 14;
+  for (uint8_t src_lg_k = lg_k; src_lg_k <= lg_k + 1; ++src_lg_k) {
+    for (auto type: {HLL_4, HLL_6, HLL_8}) {
+      hll_sketch base(lg_k, HLL_8);
+      for (int i = 0; i < 100000; ++i) base.update(i);
+      hll_sketch src(src_lg_k, type);
+      for (int i = 50000; i < (1 << 22); ++i) src.update(i);
+      if (type == HLL_4) {
+        // make sure the exception path for values in the aux hash map is covered
+        const uint32_t num_bytes = static_cast<uint32_t>(src.serialize_compact().size());
+        REQUIRE(num_bytes > hll_constants::HLL_BYTE_ARR_START + (1 << src_lg_k) / 2);
+      }
+
+      hll_union u(lg_k);
+      u.update(base);
+      u.update(src);
+      hll_union expected(lg_k);
+      expected.update(base);
+      expected.update(hll_sketch(src, HLL_8));
+      REQUIRE(u.get_result(HLL_8).serialize_updatable() == expected.get_result(HLL_8).serialize_updatable());
+      REQUIRE(u.get_estimate() == expected.get_estimate());
+    }
+  }
+}
+
+TEST_CASE("hll union: downsampled gadget is not replaced by the next sketch", "[hll_union]") {
+  // the first sketch is downsampled into the empty gadget, the second one must be merged into it
+  hll_sketch sketch1(14, HLL_8);
+  for (int i = 0; i < 50000; ++i) sketch1.update(i);
+  hll_sketch sketch2(12, HLL_8);
+  for (int i = 50000; i < 100000; ++i) sketch2.update(i);
+
+  hll_union u(12);
+  u.update(sketch1);
+  REQUIRE(u.get_lg_config_k() == 12);
+  REQUIRE(u.get_estimate() == Approx(50000).margin(50000 * 0.05));
+  u.update(sketch2);
+  REQUIRE(u.get_estimate() == Approx(100000).margin(100000 * 0.05));
+
+  // the same registers as a single sketch of all values
+  hll_sketch expected(12, HLL_8);
+  for (int i = 0; i < 100000; ++i) expected.update(i);
+  const auto result_bytes = u.get_result(HLL_8).serialize_compact();
+  const auto expected_bytes = expected.serialize_compact();
+  REQUIRE(result_bytes.size() == expected_bytes.size());
+  REQUIRE(std::equal(result_bytes.begin() + hll_constants::HLL_BYTE_ARR_START, result_bytes.end(),
+      expected_bytes.begin() + hll_constants::HLL_BYTE_ARR_START));
+}
+
+TEST_CASE("hll union: update many", "[hll_union]") {
+  const uint8_t lg_max_k = 12;
+  std::vector<hll_sketch> sketches;
+  sketches.emplace_back(10, HLL_4); // stays empty
+  int value = 0;
+  // HLL mode with different lg_k and types, one of them with fewer slots than the union
+  const uint8_t lg_ks[] = {12, 13, 11, 12, 14};
+  const target_hll_type types[] = {HLL_4, HLL_6, HLL_8, HLL_8, HLL_4};
+  for (int i = 0; i < 5; ++i) {
+    sketches.emplace_back(lg_ks[i], types[i]);
+    for (int j = 0; j < 20000; ++j) sketches.back().update(value++);
+  }
+  // LIST and SET mode
+  sketches.emplace_back(12, HLL_8);
+  for (int j = 0; j < 5; ++j) sketches.back().update(value++);
+  sketches.emplace_back(12, HLL_6);
+  for (int j = 0; j < 100; ++j) sketches.back().update(value++);
+
+  // start from a gadget in each mode
+  for (int initial: {0, 10, 1000}) {
+    hll_union expected(lg_max_k);
+    hll_union u(lg_max_k);
+    for (int i = 0; i < initial; ++i) { expected.update(-i - 1); u.update(-i - 1); }
+    for (const auto& sketch: sketches) expected.update(sketch);
+    u.update_many(sketches.begin(), sketches.end());
+    REQUIRE(u.get_lg_config_k() == 11);
+    REQUIRE(u.get_result(HLL_8).serialize_updatable() == expected.get_result(HLL_8).serialize_updatable());
+    REQUIRE(u.get_estimate() == expected.get_estimate());
+  }
+
+  // the gadget must not look empty to a later update
+  {
+    hll_union expected(lg_max_k);
+    hll_union u(lg_max_k);
+    for (int i = 1; i < 3; ++i) expected.update(sketches[i]);
+    u.update_many(sketches.begin() + 1, sketches.begin() + 3);
+    REQUIRE_FALSE(u.is_empty());
+    expected.update(sketches[3]);
+    u.update(sketches[3]);
+    REQUIRE(u.get_result(HLL_8).serialize_updatable() == expected.get_result(HLL_8).serialize_updatable());
+    REQUIRE(u.get_estimate() == expected.get_estimate());
+  }
+
+  // fewer than two sketches in HLL mode keep the HIP estimator
+  hll_union u(lg_max_k);
+  u.update_many(sketches.begin() + 1, sketches.begin() + 2);
+  REQUIRE(u.get_estimate() == sketches[1].get_estimate());
+  u.update_many(sketches.end(), sketches.end());
+  REQUIRE(u.get_estimate() == sketches[1].get_estimate());
+}
+
+TEST_CASE("hll union: update with wrapped sketches", "[hll_union]") {
+  std::vector<hll_sketch> sketches;
+  int value = 0;
+  const uint8_t lg_ks[] = {12, 13, 11, 12, 12, 14};
+  const target_hll_type types[] = {HLL_8, HLL_4, HLL_6, HLL_6, HLL_8, HLL_4};
+  const int counts[] = {10, 200000, 50000, 500, 100000, 1 << 22}; // list, hll, hll, set, hll, hll with exceptions
+  for (int i = 0; i < 6; ++i) {
+    sketches.emplace_back(lg_ks[i], types[i]);
+    for (int j = 0; j < counts[i]; ++j) sketches.back().update(value++);
+  }
+
+  // the first sketch lands in an empty union, try each of them first
+  for (size_t first = 0; first < sketches.size(); ++first) {
+    for (bool compact: {true, false}) {
+      hll_union expected(12);
+      hll_union u(12);
+      for (size_t i = 0; i < sketches.size(); ++i) {
+        const auto& sketch = sketches[(first + i) % sketches.size()];
+        const auto bytes = compact ? sketch.serialize_compact() : sketch.serialize_updatable();
+        expected.update(hll_sketch::deserialize(bytes.data(), bytes.size()));
+        u.update(wrapped_hll_sketch::wrap(bytes.data(), bytes.size()));
+        REQUIRE(u.get_lg_config_k() == expected.get_lg_config_k());
+        // the whole image must be the same, including the header state
+        REQUIRE(u.get_result(HLL_8).serialize_compact() == expected.get_result(HLL_8).serialize_compact());
+        REQUIRE(u.get_estimate() == expected.get_estimate());
+      }
+    }
+  }
+}
+
 } /* namespace datasketches */
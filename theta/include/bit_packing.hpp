@@ -21,6 +21,12 @@
 #define BIT_PACKING_HPP_
 
 #include <memory>
+#include <string>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
 
 namespace datasketches {
 
@@ -6274,6 +6280,112 @@ static inline void unpack_bits_block8(uint64_t* values, const uint8_t* ptr, uint
   }
 }
 
+// undo delta encoding of a block of 8 values given the last value of the previous block
+// returns the last value of this block
+static inline uint64_t undo_deltas_block8(uint64_t* values, uint64_t previous) {
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  // prefix sum of pairs of values, carrying the running sum in both lanes
+  __m128i carry = _mm_set1_epi64x(static_cast<long long>(previous));
+  for (int i = 0; i < 8; i += 2) {
+    __m128i pair = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+    pair = _mm_add_epi64(pair, _mm_slli_si128(pair, 8));
+    pair = _mm_add_epi64(pair, carry);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), pair);
+    carry = _mm_unpackhi_epi64(pair, pair);
+  }
+  return values[7];
+#else
+  for (int i = 0; i < 8; ++i) {
+    values[i] += previous;
+    previous = values[i];
+  }
+  return previous;
+#endif
+}
+
+template<void (*unpack_bits_n)(uint64_t*, const uint8_t*)>
+static inline uint64_t unpack_deltas_blocks8_impl(uint64_t* values, const uint8_t* ptr, uint8_t bits, size_t num_blocks, uint64_t previous) {
+  for (size_t i = 0; i < num_blocks; ++i) {
+    unpack_bits_n(values, ptr);
+    previous = undo_deltas_block8(values, previous);
+    values += 8;
+    ptr += bits;
+  }
+  return previous;
+}
+
+// unpack a number of consecutive blocks of 8 delta-encoded values and undo delta encoding
+// the number of bits is dispatched once for all blocks, not for every block
+// returns the last decoded value to continue from
+static inline uint64_t unpack_deltas_blocks8(uint64_t* values, const uint8_t* ptr, uint8_t bits, size_t num_blocks, uint64_t previous) {
+  switch (bits) {
+    case 1: return unpack_deltas_blocks8_impl<unpack_bits_1>(values, ptr, bits, num_blocks, previous);
+    case 2: return unpack_deltas_blocks8_impl<unpack_bits_2>(values, ptr, bits, num_blocks, previous);
+    case 3: return unpack_deltas_blocks8_impl<unpack_bits_3>(values, ptr, bits, num_blocks, previous);
+    case 4: return unpack_deltas_blocks8_impl<unpack_bits_4>(values, ptr, bits, num_blocks, previous);
+    case 5: return unpack_deltas_blocks8_impl<unpack_bits_5>(values, ptr, bits, num_blocks, previous);
+    case 6: return unpack_deltas_blocks8_impl<unpack_bits_6>(values, ptr, bits, num_blocks, previous);
+    case 7: return unpack_deltas_blocks8_impl<unpack_bits_7>(values, ptr, bits, num_blocks, previous);
+    case 8: return unpack_deltas_blocks8_impl<unpack_bits_8>(values, ptr, bits, num_blocks, previous);
+    case 9: return unpack_deltas_blocks8_impl<unpack_bits_9>(values, ptr, bits, num_blocks, previous);
+    case 10: return unpack_deltas_blocks8_impl<unpack_bits_10>(values, ptr, bits, num_blocks, previous);
+    case 11: return unpack_deltas_blocks8_impl<unpack_bits_11>(values, ptr, bits, num_blocks, previous);
+    case 12: return unpack_deltas_blocks8_impl<unpack_bits_12>(values, ptr, bits, num_blocks, previous);
+    case 13: return unpack_deltas_blocks8_impl<unpack_bits_13>(values, ptr, bits, num_blocks, previous);
+    case 14: return unpack_deltas_blocks8_impl<unpack_bits_14>(values, ptr, bits, num_blocks, previous);
+    case 15: return unpack_deltas_blocks8_impl<unpack_bits_15>(values, ptr, bits, num_blocks, previous);
+    case 16: return unpack_deltas_blocks8_impl<unpack_bits_16>(values, ptr, bits, num_blocks, previous);
+    case 17: return unpack_deltas_blocks8_impl<unpack_bits_17>(values, ptr, bits, num_blocks, previous);
+    case 18: return unpack_deltas_blocks8_impl<unpack_bits_18>(values, ptr, bits, num_blocks, previous);
+    case 19: return unpack_deltas_blocks8_impl<unpack_bits_19>(values, ptr, bits, num_blocks, previous);
+    case 20: return unpack_deltas_blocks8_impl<unpack_bits_20>(values, ptr, bits, num_blocks, previous);
+    case 21: return unpack_deltas_blocks8_impl<unpack_bits_21>(values, ptr, bits, num_blocks, previous);
+    case 22: return unpack_deltas_blocks8_impl<unpack_bits_22>(values, ptr, bits, num_blocks, previous);
+    case 23: return unpack_deltas_blocks8_impl<unpack_bits_23>(values, ptr, bits, num_blocks, previous);
+    case 24: return unpack_deltas_blocks8_impl<unpack_bits_24>(values, ptr, bits, num_blocks, previous);
+    case 25: return unpack_deltas_blocks8_impl<unpack_bits_25>(values, ptr, bits, num_blocks, previous);
+    case 26: return unpack_deltas_blocks8_impl<unpack_bits_26>(values, ptr, bits, num_blocks, previous);
+    case 27: return unpack_deltas_blocks8_impl<unpack_bits_27>(values, ptr, bits, num_blocks, previous);
+    case 28: return unpack_deltas_blocks8_impl<unpack_bits_28>(values, ptr, bits, num_blocks, previous);
+    case 29: return unpack_deltas_blocks8_impl<unpack_bits_29>(values, ptr, bits, num_blocks, previous);
+    case 30: return unpack_deltas_blocks8_impl<unpack_bits_30>(values, ptr, bits, num_blocks, previous);
+    case 31: return unpack_deltas_blocks8_impl<unpack_bits_31>(values, ptr, bits, num_blocks, previous);
+    case 32: return unpack_deltas_blocks8_impl<unpack_bits_32>(values, ptr, bits, num_blocks, previous);
+    case 33: return unpack_deltas_blocks8_impl<unpack_bits_33>(values, ptr, bits, num_blocks, previous);
+    case 34: return unpack_deltas_blocks8_impl<unpack_bits_34>(values, ptr, bits, num_blocks, previous);
+    case 35: return unpack_deltas_blocks8_impl<unpack_bits_35>(values, ptr, bits, num_blocks, previous);
+    case 36: return unpack_deltas_blocks8_impl<unpack_bits_36>(values, ptr, bits, num_blocks, previous);
+    case 37: return unpack_deltas_blocks8_impl<unpack_bits_37>(values, ptr, bits, num_blocks, previous);
+    case 38: return unpack_deltas_blocks8_impl<unpack_bits_38>(values, ptr, bits, num_blocks, previous);
+    case 39: return unpack_deltas_blocks8_impl<unpack_bits_39>(values, ptr, bits, num_blocks, previous);
+    case 40: return unpack_deltas_blocks8_impl<unpack_bits_40>(values, ptr, bits, num_blocks, previous);
+    case 41: return unpack_deltas_blocks8_impl<unpack_bits_41>(values, ptr, bits, num_blocks, previous);
+    case 42: return unpack_deltas_blocks8_impl<unpack_bits_42>(values, ptr, bits, num_blocks, previous);
+    case 43: return unpack_deltas_blocks8_impl<unpack_bits_43>(values, ptr, bits, num_blocks, previous);
+    case 44: return unpack_deltas_blocks8_impl<unpack_bits_44>(values, ptr, bits, num_blocks, previous);
+    case 45: return unpack_deltas_blocks8_impl<unpack_bits_45>(values, ptr, bits, num_blocks, previous);
+    case 46: return unpack_deltas_blocks8_impl<unpack_bits_46>(values, ptr, bits, num_blocks, previous);
+    case 47: return unpack_deltas_blocks8_impl<unpack_bits_47>(values, ptr, bits, num_blocks, previous);
+    case 48: return unpack_deltas_blocks8_impl<unpack_bits_48>(values, ptr, bits, num_blocks, previous);
+    case 49: return unpack_deltas_blocks8_impl<unpack_bits_49>(values, ptr, bits, num_blocks, previous);
+    case 50: return unpack_deltas_blocks8_impl<unpack_bits_50>(values, ptr, bits, num_blocks, previous);
+    case 51: return unpack_deltas_blocks8_impl<unpack_bits_51>(values, ptr, bits, num_blocks, previous);
+    case 52: return unpack_deltas_blocks8_impl<unpack_bits_52>(values, ptr, bits, num_blocks, previous);
+    case 53: return unpack_deltas_blocks8_impl<unpack_bits_53>(values, ptr, bits, num_blocks, previous);
+    case 54: return unpack_deltas_blocks8_impl<unpack_bits_54>(values, ptr, bits, num_blocks, previous);
+    case 55: return unpack_deltas_blocks8_impl<unpack_bits_55>(values, ptr, bits, num_blocks, previous);
+    case 56: return unpack_deltas_blocks8_impl<unpack_bits_56>(values, ptr, bits, num_blocks, previous);
+    case 57: return unpack_deltas_blocks8_impl<unpack_bits_57>(values, ptr, bits, num_blocks, previous);
+    case 58: return unpack_deltas_blocks8_impl<unpack_bits_58>(values, ptr, bits, num_blocks, previous);
+    case 59: return unpack_deltas_blocks8_impl<unpack_bits_59>(values, ptr, bits, num_blocks, previous);
+    case 60: return unpack_deltas_blocks8_impl<unpack_bits_60>(values, ptr, bits, num_blocks, previous);
+    case 61: return unpack_deltas_blocks8_impl<unpack_bits_61>(values, ptr, bits, num_blocks, previous);
+    case 62: return unpack_deltas_blocks8_impl<unpack_bits_62>(values, ptr, bits, num_blocks, previous);
+    case 63: return unpack_deltas_blocks8_impl<unpack_bits_63>(values, ptr, bits, num_blocks, previous);
+    default: throw std::logic_error("wrong number of bits in unpack_deltas_blocks8: " + std::to_string(bits));
+  }
+}
+
 } // namespace
 
 #endif // BIT_PACKING_HPP_
@@ -0,0 +1,208 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef COMPACT_THETA_SKETCH_COLLECTION_HPP_
+#define COMPACT_THETA_SKETCH_COLLECTION_HPP_
+
+#include "theta_sketch.hpp"
+
+namespace datasketches {
+
+// forward declaration
+template<typename A> class compact_theta_sketch_collection_alloc;
+
+/// Compact Theta sketch collection alias with default allocator
+using compact_theta_sketch_collection = compact_theta_sketch_collection_alloc<std::allocator<uint64_t>>;
+
+/**
+ * Read-only view of a collection of serialized compact Theta sketches indexed by a 64-bit key.
+ *
+ * The binary layout is a short preamble, an index of (key, offset, size) records sorted by key,
+ * and the serialized images of the sketches, each starting at an 8-byte boundary.
+ * The intended use is to memory-map a file produced by the writer and wrap the mapped region:
+ * looking up a sketch is a binary search over the index and returns a wrapped_compact_theta_sketch
+ * pointing into the buffer, so nothing is copied or allocated per query.
+ * The collection does not take the ownership of the buffer, which must outlive the collection
+ * and all the sketches obtained from it.
+ *
+ * Layout:
+ * <pre>
+ * Long || Start Byte Adr:
+ * Adr:
+ *      ||    7   |    6   |    5   |    4   |    3   |    2   |    1   |     0              |
+ *  0   ||    Seed Hash    |    unused                |  Type  | SerVer | PreambleLongs = 2  |
+ *
+ *      ||   15   |   14   |   13   |   12   |   11   |   10   |    9   |     8              |
+ *  1   ||    unused                         |    Number of sketches                         |
+ *
+ * followed by the index of 3 longs per sketch: key, offset of the image from the start, size of the image
+ * followed by the images
+ * </pre>
+ */
+template<typename Allocator = std::allocator<uint64_t>>
+class compact_theta_sketch_collection_alloc {
+public:
+  using wrapped_sketch = wrapped_compact_theta_sketch_alloc<Allocator>;
+  using compact_sketch = compact_theta_sketch_alloc<Allocator>;
+  using AllocBytes = typename std::allocator_traits<Allocator>::template rebind_alloc<uint8_t>;
+  using vector_bytes = std::vector<uint8_t, AllocBytes>;
+
+  static const uint8_t SERIAL_VERSION = 1;
+  static const uint8_t SKETCH_TYPE = 100;
+
+  class writer;
+
+  /**
+   * @return number of sketches in the collection
+   */
+  uint32_t get_num_sketches() const;
+
+  /**
+   * @param index position of a sketch in the collection (sketches are ordered by key)
+   * @return key of the sketch at the given position
+   */
+  uint64_t get_key(uint32_t index) const;
+
+  /**
+   * @param index position of a sketch in the collection (sketches are ordered by key)
+   * @return wrapped sketch at the given position
+   */
+  const wrapped_sketch get_sketch(uint32_t index) const;
+
+  /**
+   * @param key key of a sketch
+   * @return true if the collection has a sketch with the given key
+   */
+  bool contains(uint64_t key) const;
+
+  /**
+   * Looks up a sketch by key.
+   * Throws std::out_of_range if there is no sketch with the given key.
+   * @param key key of a sketch
+   * @return wrapped sketch with the given key
+   */
+  const wrapped_sketch get(uint64_t key) const;
+
+  /**
+   * This method wraps a serialized collection of sketches as an array of bytes.
+   * Only the preamble and the size of the index are checked here.
+   * Each image is checked when the sketch is obtained from the collection.
+   * @param bytes pointer to the array of bytes
+   * @param size the size of the array
+   * @param seed the seed for the hash function that was used to create the sketches
+   * @return an instance of the collection
+   */
+  static const compact_theta_sketch_collection_alloc wrap(const void* bytes, size_t size, uint64_t seed = DEFAULT_SEED);
+
+private:
+  static const uint8_t PREAMBLE_LONGS = 2;
+  static const uint8_t PREAMBLE_LONGS_BYTE = 0;
+  static const uint8_t SERIAL_VERSION_BYTE = 1;
+  static const uint8_t SKETCH_TYPE_BYTE = 2;
+  static const uint8_t SEED_HASH_BYTE = 6;
+  static const uint8_t NUM_SKETCHES_BYTE = 8;
+  static const uint8_t INDEX_ENTRY_SIZE_BYTES = 24;
+
+  const uint8_t* ptr_;
+  size_t size_;
+  uint64_t seed_;
+  uint32_t num_sketches_;
+
+  compact_theta_sketch_collection_alloc(const uint8_t* ptr, size_t size, uint64_t seed, uint32_t num_sketches);
+
+  const uint8_t* index_entry(uint32_t index) const;
+  uint32_t lower_bound(uint64_t key) const;
+};
+
+/**
+ * Writer of a collection of compact Theta sketches.
+ * Sketches can be added in any order. They are sorted by key when the collection is serialized.
+ */
+template<typename Allocator>
+class compact_theta_sketch_collection_alloc<Allocator>::writer {
+public:
+  /**
+   * Constructor
+   * @param seed the seed for the hash function that was used to create the sketches
+   * @param allocator to use for the buffers
+   */
+  explicit writer(uint64_t seed = DEFAULT_SEED, const Allocator& allocator = Allocator());
+
+  /**
+   * Adds a sketch to the collection.
+   * @param key key of the sketch, which must be unique in the collection
+   * @param sketch to add
+   * @param compressed if true the sketch is serialized in the compressed form
+   */
+  void add(uint64_t key, const compact_sketch& sketch, bool compressed = false);
+
+  /**
+   * Adds a sketch that was already serialized.
+   * The image is checked by wrapping it.
+   * @param key key of the sketch, which must be unique in the collection
+   * @param bytes pointer to the serialized compact sketch
+   * @param size the size of the serialized compact sketch
+   */
+  void add(uint64_t key, const void* bytes, size_t size);
+
+  /**
+   * @return number of sketches added so far
+   */
+  uint32_t get_num_sketches() const;
+
+  /**
+   * @return size in bytes required to serialize the collection
+   */
+  size_t get_serialized_size_bytes() const;
+
+  /**
+   * This method serializes the collection into a given stream in a binary form.
+   * Throws std::invalid_argument if some key was added more than once.
+   * @param os output stream
+   */
+  void serialize(std::ostream& os) const;
+
+  /**
+   * This method serializes the collection as a vector of bytes.
+   * Throws std::invalid_argument if some key was added more than once.
+   * @return serialized collection as a vector of bytes
+   */
+  vector_bytes serialize() const;
+
+private:
+  struct index_entry {
+    uint64_t key;
+    uint64_t offset; // from the start of images_
+    uint64_t size;
+  };
+  using AllocIndexEntry = typename std::allocator_traits<Allocator>::template rebind_alloc<index_entry>;
+
+  uint64_t seed_;
+  std::vector<index_entry, AllocIndexEntry> index_;
+  vector_bytes images_;
+
+  std::vector<index_entry, AllocIndexEntry> sorted_index() const;
+  size_t images_offset() const;
+};
+
+} /* namespace datasketches */
+
+#include "compact_theta_sketch_collection_impl.hpp"
+
+#endif
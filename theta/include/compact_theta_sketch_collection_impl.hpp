@@ -0,0 +1,232 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef COMPACT_THETA_SKETCH_COLLECTION_IMPL_HPP_
+#define COMPACT_THETA_SKETCH_COLLECTION_IMPL_HPP_
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "memory_operations.hpp"
+
+namespace datasketches {
+
+template<typename A>
+compact_theta_sketch_collection_alloc<A>::compact_theta_sketch_collection_alloc(const uint8_t* ptr, size_t size,
+    uint64_t seed, uint32_t num_sketches):
+ptr_(ptr),
+size_(size),
+seed_(seed),
+num_sketches_(num_sketches)
+{}
+
+template<typename A>
+uint32_t compact_theta_sketch_collection_alloc<A>::get_num_sketches() const {
+  return num_sketches_;
+}
+
+template<typename A>
+uint64_t compact_theta_sketch_collection_alloc<A>::get_key(uint32_t index) const {
+  uint64_t key;
+  copy_from_mem(index_entry(index), key);
+  return key;
+}
+
+template<typename A>
+auto compact_theta_sketch_collection_alloc<A>::get_sketch(uint32_t index) const -> const wrapped_sketch {
+  const uint8_t* ptr = index_entry(index) + sizeof(uint64_t);
+  uint64_t offset;
+  ptr += copy_from_mem(ptr, offset);
+  uint64_t size;
+  copy_from_mem(ptr, size);
+  if (offset > size_ || size > size_ - offset) {
+    throw std::out_of_range("sketch " + std::to_string(index) + " at offset " + std::to_string(offset)
+        + " of size " + std::to_string(size) + " is outside of the buffer of size " + std::to_string(size_));
+  }
+  return wrapped_sketch::wrap(ptr_ + offset, size, seed_);
+}
+
+template<typename A>
+bool compact_theta_sketch_collection_alloc<A>::contains(uint64_t key) const {
+  const uint32_t index = lower_bound(key);
+  return index < num_sketches_ && get_key(index) == key;
+}
+
+template<typename A>
+auto compact_theta_sketch_collection_alloc<A>::get(uint64_t key) const -> const wrapped_sketch {
+  const uint32_t index = lower_bound(key);
+  if (index == num_sketches_ || get_key(index) != key) {
+    throw std::out_of_range("no sketch with key " + std::to_string(key));
+  }
+  return get_sketch(index);
+}
+
+template<typename A>
+const uint8_t* compact_theta_sketch_collection_alloc<A>::index_entry(uint32_t index) const {
+  if (index >= num_sketches_) {
+    throw std::out_of_range("index " + std::to_string(index) + " is out of range for "
+        + std::to_string(num_sketches_) + " sketches");
+  }
+  return ptr_ + PREAMBLE_LONGS * sizeof(uint64_t) + static_cast<size_t>(index) * INDEX_ENTRY_SIZE_BYTES;
+}
+
+template<typename A>
+uint32_t compact_theta_sketch_collection_alloc<A>::lower_bound(uint64_t key) const {
+  uint32_t first = 0;
+  uint32_t count = num_sketches_;
+  while (count > 0) {
+    const uint32_t step = count / 2;
+    if (get_key(first + step) < key) {
+      first += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+  return first;
+}
+
+template<typename A>
+auto compact_theta_sketch_collection_alloc<A>::wrap(const void* bytes, size_t size, uint64_t seed)
+-> const compact_theta_sketch_collection_alloc {
+  ensure_minimum_memory(size, PREAMBLE_LONGS * sizeof(uint64_t));
+  const uint8_t* ptr = static_cast<const uint8_t*>(bytes);
+  const uint8_t preamble_longs = ptr[PREAMBLE_LONGS_BYTE];
+  const uint8_t serial_version = ptr[SERIAL_VERSION_BYTE];
+  const uint8_t type = ptr[SKETCH_TYPE_BYTE];
+  if (preamble_longs != PREAMBLE_LONGS) {
+    throw std::invalid_argument("preamble longs mismatch: expected " + std::to_string(PREAMBLE_LONGS)
+        + ", actual " + std::to_string(preamble_longs));
+  }
+  if (serial_version != SERIAL_VERSION) {
+    throw std::invalid_argument("serial version mismatch: expected " + std::to_string(SERIAL_VERSION)
+        + ", actual " + std::to_string(serial_version));
+  }
+  if (type != SKETCH_TYPE) {
+    throw std::invalid_argument("sketch type mismatch: expected " + std::to_string(SKETCH_TYPE)
+        + ", actual " + std::to_string(type));
+  }
+  uint16_t seed_hash;
+  copy_from_mem(ptr + SEED_HASH_BYTE, seed_hash);
+  checker<true>::check_seed_hash(seed_hash, compute_seed_hash(seed));
+  uint32_t num_sketches;
+  copy_from_mem(ptr + NUM_SKETCHES_BYTE, num_sketches);
+  ensure_minimum_memory(size, PREAMBLE_LONGS * sizeof(uint64_t) + static_cast<size_t>(num_sketches) * INDEX_ENTRY_SIZE_BYTES);
+  return compact_theta_sketch_collection_alloc(ptr, size, seed, num_sketches);
+}
+
+// writer
+
+template<typename A>
+compact_theta_sketch_collection_alloc<A>::writer::writer(uint64_t seed, const A& allocator):
+seed_(seed),
+index_(allocator),
+images_(allocator)
+{}
+
+template<typename A>
+void compact_theta_sketch_collection_alloc<A>::writer::add(uint64_t key, const compact_sketch& sketch, bool compressed) {
+  checker<true>::check_seed_hash(sketch.get_seed_hash(), compute_seed_hash(seed_));
+  const auto bytes = compressed ? sketch.serialize_compressed() : sketch.serialize();
+  add(key, bytes.data(), bytes.size());
+}
+
+template<typename A>
+void compact_theta_sketch_collection_alloc<A>::writer::add(uint64_t key, const void* bytes, size_t size) {
+  wrapped_sketch::wrap(bytes, size, seed_);
+  const size_t offset = images_.size();
+  // keep images aligned to 8 bytes relative to the start of the collection
+  const size_t padded_size = (size + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+  images_.resize(offset + padded_size, 0);
+  copy_from_mem(bytes, images_.data() + offset, size);
+  index_.push_back({key, offset, size});
+}
+
+template<typename A>
+uint32_t compact_theta_sketch_collection_alloc<A>::writer::get_num_sketches() const {
+  return static_cast<uint32_t>(index_.size());
+}
+
+template<typename A>
+size_t compact_theta_sketch_collection_alloc<A>::writer::images_offset() const {
+  return PREAMBLE_LONGS * sizeof(uint64_t) + index_.size() * INDEX_ENTRY_SIZE_BYTES;
+}
+
+template<typename A>
+size_t compact_theta_sketch_collection_alloc<A>::writer::get_serialized_size_bytes() const {
+  return images_offset() + images_.size();
+}
+
+template<typename A>
+auto compact_theta_sketch_collection_alloc<A>::writer::sorted_index() const -> std::vector<index_entry, AllocIndexEntry> {
+  std::vector<index_entry, AllocIndexEntry> index(index_);
+  std::sort(index.begin(), index.end(), [](const index_entry& a, const index_entry& b) { return a.key < b.key; });
+  auto it = std::adjacent_find(index.begin(), index.end(),
+      [](const index_entry& a, const index_entry& b) { return a.key == b.key; });
+  if (it != index.end()) throw std::invalid_argument("duplicate key " + std::to_string(it->key));
+  return index;
+}
+
+template<typename A>
+void compact_theta_sketch_collection_alloc<A>::writer::serialize(std::ostream& os) const {
+  const auto index = sorted_index();
+  write(os, PREAMBLE_LONGS);
+  write(os, SERIAL_VERSION);
+  write(os, SKETCH_TYPE);
+  const uint8_t unused8 = 0;
+  write(os, unused8);
+  const uint16_t unused16 = 0;
+  write(os, unused16);
+  write(os, compute_seed_hash(seed_));
+  write(os, static_cast<uint32_t>(index.size()));
+  const uint32_t unused32 = 0;
+  write(os, unused32);
+  const uint64_t images_start = images_offset();
+  for (const auto& entry: index) {
+    write(os, entry.key);
+    write(os, images_start + entry.offset);
+    write(os, entry.size);
+  }
+  write(os, images_.data(), images_.size());
+}
+
+template<typename A>
+auto compact_theta_sketch_collection_alloc<A>::writer::serialize() const -> vector_bytes {
+  const auto index = sorted_index();
+  vector_bytes bytes(get_serialized_size_bytes(), 0, images_.get_allocator());
+  uint8_t* ptr = bytes.data();
+  ptr[PREAMBLE_LONGS_BYTE] = PREAMBLE_LONGS;
+  ptr[SERIAL_VERSION_BYTE] = SERIAL_VERSION;
+  ptr[SKETCH_TYPE_BYTE] = SKETCH_TYPE;
+  copy_to_mem(compute_seed_hash(seed_), ptr + SEED_HASH_BYTE);
+  copy_to_mem(static_cast<uint32_t>(index.size()), ptr + NUM_SKETCHES_BYTE);
+  ptr += PREAMBLE_LONGS * sizeof(uint64_t);
+  const uint64_t images_start = images_offset();
+  for (const auto& entry: index) {
+    ptr += copy_to_mem(entry.key, ptr);
+    ptr += copy_to_mem(images_start + entry.offset, ptr);
+    ptr += copy_to_mem(entry.size, ptr);
+  }
+  if (!images_.empty()) copy_to_mem(images_.data(), ptr, images_.size());
+  return bytes;
+}
+
+} /* namespace datasketches */
+
+#endif
@@ -0,0 +1,296 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CONCURRENT_THETA_SKETCH_HPP_
+#define CONCURRENT_THETA_SKETCH_HPP_
+
+#include <atomic>
+#include <mutex>
+
+#include "theta_sketch.hpp"
+
+namespace datasketches {
+
+// forward declaration
+template<typename A> class concurrent_theta_sketch_alloc;
+
+/// Concurrent Theta sketch alias with default allocator
+using concurrent_theta_sketch = concurrent_theta_sketch_alloc<std::allocator<uint64_t>>;
+
+/**
+ * Concurrent Theta sketch.
+ * This is a shared sketch that can be updated from multiple threads at the same time.
+ * Each writer thread updates its own local_buffer, which retains a small number of hashes
+ * and propagates them into the shared sketch when it fills up, when flush() is called
+ * or when it is destroyed. The theta of the shared sketch is published atomically,
+ * so that local buffers can screen incoming hashes without taking a lock.
+ * Queries reflect the state of the shared sketch, that is only propagated updates.
+ * The sketch must outlive all of its local buffers.
+ * There is no constructor. Use builder instead.
+ */
+template<typename Allocator = std::allocator<uint64_t>>
+class concurrent_theta_sketch_alloc {
+public:
+  using Entry = uint64_t;
+  using ExtractKey = trivial_extract_key;
+  using theta_table = theta_update_sketch_base<Entry, ExtractKey, Allocator>;
+  using resize_factor = typename theta_table::resize_factor;
+  using CompactSketch = compact_theta_sketch_alloc<Allocator>;
+
+  static const uint8_t DEFAULT_LOCAL_LG_K = 4;
+
+  // No constructor here. Use builder instead.
+  class builder;
+  class local_buffer;
+
+  /**
+   * Move constructor.
+   * Must not be used while the other sketch is being updated or queried.
+   * @param other sketch to be moved
+   */
+  concurrent_theta_sketch_alloc(concurrent_theta_sketch_alloc&& other) noexcept;
+
+  concurrent_theta_sketch_alloc(const concurrent_theta_sketch_alloc& other) = delete;
+  concurrent_theta_sketch_alloc& operator=(const concurrent_theta_sketch_alloc& other) = delete;
+  concurrent_theta_sketch_alloc& operator=(concurrent_theta_sketch_alloc&& other) = delete;
+
+  /**
+   * Creates a local buffer to update this sketch from the calling thread.
+   * The sketch must outlive the buffer.
+   * @return local buffer
+   */
+  local_buffer get_local_buffer();
+
+  /**
+   * @return allocator
+   */
+  Allocator get_allocator() const;
+
+  /**
+   * @return true if this sketch represents an empty set (not the same as no retained entries!)
+   */
+  bool is_empty() const;
+
+  /**
+   * @return theta as a positive integer between 0 and LLONG_MAX
+   */
+  uint64_t get_theta64() const;
+
+  /**
+   * @return theta as a fraction from 0 to 1 (effective sampling rate)
+   */
+  double get_theta() const;
+
+  /**
+   * @return the number of retained entries in the shared sketch
+   */
+  uint32_t get_num_retained() const;
+
+  /**
+   * Returns the estimate of the distinct count of the propagated input.
+   * This does not take the lock, but the value can lag behind the latest propagation.
+   * @return estimate of the distinct count
+   */
+  double get_estimate() const;
+
+  /**
+   * @return hash of the seed that was used to hash the input
+   */
+  uint16_t get_seed_hash() const;
+
+  /**
+   * @return configured nominal number of entries in the shared sketch
+   */
+  uint8_t get_lg_k() const;
+
+  /**
+   * Converts the current state of the shared sketch to a compact sketch (ordered or unordered).
+   * @param ordered optional flag to specify if an ordered sketch should be produced
+   * @return compact sketch
+   */
+  CompactSketch compact(bool ordered = true) const;
+
+private:
+  mutable std::mutex mutex_;
+  theta_table table_;
+  uint8_t local_lg_k_;
+  std::atomic<bool> is_empty_;
+  std::atomic<uint64_t> theta_;
+  std::atomic<uint32_t> num_retained_;
+  std::atomic<double> estimate_;
+
+  // for builder
+  concurrent_theta_sketch_alloc(uint8_t lg_cur_size, uint8_t lg_nom_size, resize_factor rf, float p,
+      uint64_t theta, uint64_t seed, uint8_t local_lg_k, const Allocator& allocator);
+
+  void propagate(const theta_table& local_table);
+};
+
+/**
+ * Local buffer of the Concurrent Theta sketch.
+ * An instance must be used by one thread at a time.
+ * The shared sketch must outlive the buffer, since the buffer propagates into it on destruction.
+ * A moved-from buffer is detached from the shared sketch: flush() does nothing and update() throws std::logic_error.
+ */
+template<typename Allocator>
+class concurrent_theta_sketch_alloc<Allocator>::local_buffer {
+public:
+  /**
+   * Move constructor
+   * @param other buffer to be moved
+   */
+  local_buffer(local_buffer&& other) noexcept;
+
+  local_buffer(const local_buffer& other) = delete;
+  local_buffer& operator=(const local_buffer& other) = delete;
+  local_buffer& operator=(local_buffer&& other) = delete;
+
+  /**
+   * Propagates the remaining hashes into the shared sketch.
+   * Errors are not reported here and the remaining hashes are lost if propagation fails.
+   * Call flush() before destruction to handle them.
+   */
+  ~local_buffer();
+
+  /**
+   * Update this sketch with a given string.
+   * @param value string to update the sketch with
+   */
+  void update(const std::string& value);
+
+  /**
+   * Update this sketch with a given unsigned 64-bit integer.
+   * @param value uint64_t to update the sketch with
+   */
+  void update(uint64_t value);
+
+  /**
+   * Update this sketch with a given signed 64-bit integer.
+   * @param value int64_t to update the sketch with
+   */
+  void update(int64_t value);
+
+  /**
+   * Update this sketch with a given unsigned 32-bit integer.
+   * For compatibility with Java implementation.
+   * @param value uint32_t to update the sketch with
+   */
+  void update(uint32_t value);
+
+  /**
+   * Update this sketch with a given signed 32-bit integer.
+   * For compatibility with Java implementation.
+   * @param value int32_t to update the sketch with
+   */
+  void update(int32_t value);
+
+  /**
+   * Update this sketch with a given unsigned 16-bit integer.
+   * For compatibility with Java implementation.
+   * @param value uint16_t to update the sketch with
+   */
+  void update(uint16_t value);
+
+  /**
+   * Update this sketch with a given signed 16-bit integer.
+   * For compatibility with Java implementation.
+   * @param value int16_t to update the sketch with
+   */
+  void update(int16_t value);
+
+  /**
+   * Update this sketch with a given unsigned 8-bit integer.
+   * For compatibility with Java implementation.
+   * @param value uint8_t to update the sketch with
+   */
+  void update(uint8_t value);
+
+  /**
+   * Update this sketch with a given signed 8-bit integer.
+   * For compatibility with Java implementation.
+   * @param value int8_t to update the sketch with
+   */
+  void update(int8_t value);
+
+  /**
+   * Update this sketch with a given double-precision floating point value.
+   * For compatibility with Java implementation.
+   * @param value double to update the sketch with
+   */
+  void update(double value);
+
+  /**
+   * Update this sketch with a given floating point value.
+   * For compatibility with Java implementation.
+   * @param value float to update the sketch with
+   */
+  void update(float value);
+
+  /**
+   * Update this sketch with given data of any type.
+   * See update_theta_sketch_alloc::update(const void*, size_t) for the caveats.
+   * @param data pointer to the data
+   * @param length of the data in bytes
+   */
+  void update(const void* data, size_t length);
+
+  /// Propagates buffered hashes into the shared sketch
+  void flush();
+
+private:
+  concurrent_theta_sketch_alloc* shared_;
+  theta_table table_;
+
+  friend class concurrent_theta_sketch_alloc<Allocator>;
+  explicit local_buffer(concurrent_theta_sketch_alloc& shared);
+
+  void clear();
+};
+
+/// Concurrent Theta sketch builder
+template<typename Allocator>
+class concurrent_theta_sketch_alloc<Allocator>::builder: public theta_base_builder<builder, Allocator> {
+public:
+  /**
+   * Constructor
+   * @param allocator
+   */
+  builder(const Allocator& allocator = Allocator());
+
+  /**
+   * Set log2 of the number of hashes a local buffer retains before propagating them
+   * into the shared sketch (defaults to 4). Larger buffers reduce lock contention,
+   * smaller buffers make the shared sketch lag less behind the input.
+   * @param lg_k base 2 logarithm of local buffer size
+   * @return this builder
+   */
+  builder& set_local_lg_k(uint8_t lg_k);
+
+  /// @return instance of Concurrent Theta sketch
+  concurrent_theta_sketch_alloc build() const;
+
+private:
+  uint8_t local_lg_k_;
+};
+
+} /* namespace datasketches */
+
+#include "concurrent_theta_sketch_impl.hpp"
+
+#endif
@@ -0,0 +1,264 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CONCURRENT_THETA_SKETCH_IMPL_HPP_
+#define CONCURRENT_THETA_SKETCH_IMPL_HPP_
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "theta_radix_sort.hpp"
+
+namespace datasketches {
+
+template<typename A>
+concurrent_theta_sketch_alloc<A>::concurrent_theta_sketch_alloc(uint8_t lg_cur_size, uint8_t lg_nom_size, resize_factor rf,
+    float p, uint64_t theta, uint64_t seed, uint8_t local_lg_k, const A& allocator):
+table_(lg_cur_size, lg_nom_size, rf, p, theta, seed, allocator),
+local_lg_k_(local_lg_k),
+is_empty_(true),
+theta_(theta),
+num_retained_(0),
+estimate_(0)
+{}
+
+template<typename A>
+concurrent_theta_sketch_alloc<A>::concurrent_theta_sketch_alloc(concurrent_theta_sketch_alloc&& other) noexcept:
+table_(std::move(other.table_)),
+local_lg_k_(other.local_lg_k_),
+is_empty_(other.is_empty_.load()),
+theta_(other.theta_.load()),
+num_retained_(other.num_retained_.load()),
+estimate_(other.estimate_.load())
+{}
+
+template<typename A>
+auto concurrent_theta_sketch_alloc<A>::get_local_buffer() -> local_buffer {
+  return local_buffer(*this);
+}
+
+template<typename A>
+A concurrent_theta_sketch_alloc<A>::get_allocator() const {
+  return table_.allocator_;
+}
+
+template<typename A>
+bool concurrent_theta_sketch_alloc<A>::is_empty() const {
+  return is_empty_.load(std::memory_order_acquire);
+}
+
+template<typename A>
+uint64_t concurrent_theta_sketch_alloc<A>::get_theta64() const {
+  return is_empty() ? theta_constants::MAX_THETA : theta_.load(std::memory_order_acquire);
+}
+
+template<typename A>
+double concurrent_theta_sketch_alloc<A>::get_theta() const {
+  return static_cast<double>(get_theta64()) / static_cast<double>(theta_constants::MAX_THETA);
+}
+
+template<typename A>
+uint32_t concurrent_theta_sketch_alloc<A>::get_num_retained() const {
+  return num_retained_.load(std::memory_order_acquire);
+}
+
+template<typename A>
+double concurrent_theta_sketch_alloc<A>::get_estimate() const {
+  return estimate_.load(std::memory_order_acquire);
+}
+
+template<typename A>
+uint16_t concurrent_theta_sketch_alloc<A>::get_seed_hash() const {
+  return compute_seed_hash(table_.seed_);
+}
+
+template<typename A>
+uint8_t concurrent_theta_sketch_alloc<A>::get_lg_k() const {
+  return table_.lg_nom_size_;
+}
+
+template<typename A>
+auto concurrent_theta_sketch_alloc<A>::compact(bool ordered) const -> CompactSketch {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<uint64_t, A> entries(table_.allocator_);
+  entries.reserve(table_.num_entries_);
+  std::copy_if(table_.begin(), table_.end(), std::back_inserter(entries), key_not_zero<Entry, ExtractKey>());
+  if (ordered) sort_by_key<ExtractKey>(entries.begin(), entries.end(), table_.allocator_);
+  const uint64_t theta = table_.is_empty_ ? theta_constants::MAX_THETA : table_.theta_;
+  return CompactSketch(table_.is_empty_, ordered, compute_seed_hash(table_.seed_), theta, std::move(entries));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::propagate(const theta_table& local_table) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!local_table.is_empty_) table_.is_empty_ = false;
+  for (const uint64_t hash: local_table) {
+    // the local table could have retained hashes before the shared theta went down
+    if (hash != 0 && hash < table_.theta_) {
+      auto result = table_.find(hash);
+      if (!result.second) table_.insert(result.first, hash);
+    }
+  }
+  num_retained_.store(table_.num_entries_, std::memory_order_release);
+  estimate_.store(table_.num_entries_ / (static_cast<double>(table_.theta_) / static_cast<double>(theta_constants::MAX_THETA)),
+      std::memory_order_release);
+  theta_.store(table_.theta_, std::memory_order_release);
+  is_empty_.store(table_.is_empty_, std::memory_order_release);
+}
+
+// local buffer
+
+template<typename A>
+concurrent_theta_sketch_alloc<A>::local_buffer::local_buffer(concurrent_theta_sketch_alloc& shared):
+shared_(&shared),
+table_(shared.local_lg_k_ + 1, shared.local_lg_k_, resize_factor::X1, 1,
+    shared.theta_.load(std::memory_order_acquire), shared.table_.seed_, shared.table_.allocator_)
+{}
+
+template<typename A>
+concurrent_theta_sketch_alloc<A>::local_buffer::local_buffer(local_buffer&& other) noexcept:
+shared_(other.shared_),
+table_(std::move(other.table_))
+{
+  other.shared_ = nullptr;
+}
+
+template<typename A>
+concurrent_theta_sketch_alloc<A>::local_buffer::~local_buffer() {
+  // a destructor must not throw, the remaining hashes are lost if propagation fails
+  try {
+    flush();
+  } catch (...) {}
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(uint64_t value) {
+  update(&value, sizeof(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(int64_t value) {
+  update(&value, sizeof(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(uint32_t value) {
+  update(static_cast<int32_t>(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(int32_t value) {
+  update(static_cast<int64_t>(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(uint16_t value) {
+  update(static_cast<int16_t>(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(int16_t value) {
+  update(static_cast<int64_t>(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(uint8_t value) {
+  update(static_cast<int8_t>(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(int8_t value) {
+  update(static_cast<int64_t>(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(double value) {
+  update(canonical_double(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(float value) {
+  update(static_cast<double>(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(const std::string& value) {
+  if (value.empty()) return;
+  update(value.c_str(), value.length());
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(const void* data, size_t length) {
+  if (shared_ == nullptr) throw std::logic_error("update of a moved-from local buffer");
+  // screen against the latest published theta of the shared sketch
+  table_.theta_ = shared_->theta_.load(std::memory_order_relaxed);
+  const uint64_t hash = table_.hash_and_screen(data, length);
+  if (hash == 0) return;
+  auto result = table_.find(hash);
+  if (!result.second) {
+    table_.insert(result.first, hash);
+    // the local table is sized so that it never needs to resize or rebuild before this point
+    if (table_.num_entries_ == (1U << table_.lg_nom_size_)) flush();
+  }
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::flush() {
+  if (shared_ == nullptr || table_.is_empty_) return;
+  shared_->propagate(table_);
+  clear();
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::clear() {
+  for (auto& hash: table_) hash = 0;
+  table_.num_entries_ = 0;
+  table_.is_empty_ = true;
+  table_.theta_ = shared_->theta_.load(std::memory_order_acquire);
+}
+
+// builder
+
+template<typename A>
+concurrent_theta_sketch_alloc<A>::builder::builder(const A& allocator):
+theta_base_builder<builder, A>(allocator),
+local_lg_k_(DEFAULT_LOCAL_LG_K)
+{}
+
+template<typename A>
+auto concurrent_theta_sketch_alloc<A>::builder::set_local_lg_k(uint8_t lg_k) -> builder& {
+  if (lg_k < 1) {
+    throw std::invalid_argument("local lg_k must not be less than 1: " + std::to_string(lg_k));
+  }
+  if (lg_k > theta_constants::MAX_LG_K) {
+    throw std::invalid_argument("local lg_k must not be greater than " + std::to_string(theta_constants::MAX_LG_K) + ": " + std::to_string(lg_k));
+  }
+  local_lg_k_ = lg_k;
+  return *this;
+}
+
+template<typename A>
+auto concurrent_theta_sketch_alloc<A>::builder::build() const -> concurrent_theta_sketch_alloc {
+  return concurrent_theta_sketch_alloc(this->starting_lg_size(), this->lg_k_, this->rf_, this->p_, this->starting_theta(),
+      this->seed_, local_lg_k_, this->allocator_);
+}
+
+} /* namespace datasketches */
+
+#endif
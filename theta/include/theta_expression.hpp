@@ -0,0 +1,162 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef THETA_EXPRESSION_HPP_
+#define THETA_EXPRESSION_HPP_
+
+#include <initializer_list>
+#include <vector>
+
+#include "theta_sketch.hpp"
+
+namespace datasketches {
+
+// forward declaration
+template<typename A> class theta_expression_alloc;
+
+// alias with default allocator for convenience
+using theta_expression = theta_expression_alloc<std::allocator<uint64_t>>;
+
+/**
+ * Theta set expression.
+ * Evaluates an expression tree of unions, intersections and set differences over Theta sketches,
+ * for example (A union B) intersect C minus D, in a single pass without intermediate compact sketches.
+ *
+ * The expression is built bottom-up: sketches are added as leaves, and operations are added
+ * over previously added nodes. Each add method returns a handle of the new node.
+ * Hashes of the leaves are copied into the expression, so the sketches do not have to outlive it.
+ *
+ * Evaluation uses the minimum theta of all sketches in the evaluated subtree.
+ * Sorted hashes of the leaves are merged, and each distinct hash below theta is tested
+ * against the expression once. Unlike theta_union, the result is not limited to K entries.
+ * The result is always ordered.
+ */
+template<typename Allocator = std::allocator<uint64_t>>
+class theta_expression_alloc {
+public:
+  using CompactSketch = compact_theta_sketch_alloc<Allocator>;
+  /// handle of a node in the expression
+  using node = uint32_t;
+
+  /**
+   * Constructor
+   * @param seed for the hash function that was used to create the sketches
+   * @param allocator to use for allocating and deallocating memory
+   */
+  explicit theta_expression_alloc(uint64_t seed = DEFAULT_SEED, const Allocator& allocator = Allocator());
+
+  /**
+   * Adds a sketch as a leaf of the expression.
+   * @param sketch Theta sketch of any kind (update, compact or wrapped)
+   * @return handle of the new node
+   */
+  template<typename Sketch>
+  node add_sketch(const Sketch& sketch);
+
+  /**
+   * Adds a union of given nodes.
+   * @param first iterator to the first node handle
+   * @param last iterator past the last node handle
+   * @return handle of the new node
+   */
+  template<typename InputIt>
+  node add_union(InputIt first, InputIt last);
+
+  /**
+   * Adds a union of given nodes.
+   * @param nodes node handles
+   * @return handle of the new node
+   */
+  node add_union(std::initializer_list<node> nodes);
+
+  /**
+   * Adds an intersection of given nodes.
+   * @param first iterator to the first node handle
+   * @param last iterator past the last node handle
+   * @return handle of the new node
+   */
+  template<typename InputIt>
+  node add_intersection(InputIt first, InputIt last);
+
+  /**
+   * Adds an intersection of given nodes.
+   * @param nodes node handles
+   * @return handle of the new node
+   */
+  node add_intersection(std::initializer_list<node> nodes);
+
+  /**
+   * Adds a set difference A-not-B.
+   * @param a node handle of A
+   * @param b node handle of B
+   * @return handle of the new node
+   */
+  node add_a_not_b(node a, node b);
+
+  /**
+   * Evaluates the expression rooted at a given node.
+   * @param root handle of the node to evaluate
+   * @return the result as an ordered compact sketch
+   */
+  CompactSketch evaluate(node root) const;
+
+  /// @return number of nodes in the expression
+  uint32_t get_num_nodes() const;
+
+private:
+  enum node_type { SKETCH, UNION, INTERSECTION, A_NOT_B };
+
+  struct node_info {
+    node_type type;
+    uint32_t first; // leaf index for a sketch, position of the first child otherwise
+    uint32_t num_children;
+  };
+
+  struct leaf_info {
+    size_t offset; // position of the first hash
+    uint32_t num_entries;
+    bool is_empty;
+    uint64_t theta;
+  };
+
+  using AllocU32 = typename std::allocator_traits<Allocator>::template rebind_alloc<uint32_t>;
+  using AllocNode = typename std::allocator_traits<Allocator>::template rebind_alloc<node_info>;
+  using AllocLeaf = typename std::allocator_traits<Allocator>::template rebind_alloc<leaf_info>;
+  using AllocBool = typename std::allocator_traits<Allocator>::template rebind_alloc<bool>;
+  using AllocPtr = typename std::allocator_traits<Allocator>::template rebind_alloc<const uint64_t*>;
+  using cursor = std::pair<uint64_t, uint32_t>; // hash, leaf
+  using AllocCursor = typename std::allocator_traits<Allocator>::template rebind_alloc<cursor>;
+
+  uint16_t seed_hash_;
+  std::vector<uint64_t, Allocator> hashes_;
+  std::vector<leaf_info, AllocLeaf> leaves_;
+  std::vector<node_info, AllocNode> nodes_;
+  std::vector<uint32_t, AllocU32> children_;
+
+  template<typename InputIt>
+  node add_operation(node_type type, InputIt first, InputIt last);
+  void check_node(node n) const;
+  bool contains(node n, const std::vector<uint64_t, Allocator>& stamps, uint64_t stamp) const;
+};
+
+} /* namespace datasketches */
+
+#include "theta_expression_impl.hpp"
+
+#endif
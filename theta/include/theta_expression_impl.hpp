@@ -0,0 +1,207 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef THETA_EXPRESSION_IMPL_HPP_
+#define THETA_EXPRESSION_IMPL_HPP_
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "theta_radix_sort.hpp"
+
+namespace datasketches {
+
+template<typename A>
+theta_expression_alloc<A>::theta_expression_alloc(uint64_t seed, const A& allocator):
+seed_hash_(compute_seed_hash(seed)),
+hashes_(allocator),
+leaves_(allocator),
+nodes_(allocator),
+children_(allocator)
+{}
+
+template<typename A>
+template<typename Sketch>
+auto theta_expression_alloc<A>::add_sketch(const Sketch& sketch) -> node {
+  if (!sketch.is_empty() && sketch.get_seed_hash() != seed_hash_) throw std::invalid_argument("seed hash mismatch");
+  const size_t offset = hashes_.size();
+  hashes_.reserve(offset + sketch.get_num_retained());
+  for (const uint64_t hash: sketch) hashes_.push_back(hash);
+  if (!sketch.is_ordered()) sort_by_key<trivial_extract_key>(hashes_.begin() + offset, hashes_.end(), hashes_.get_allocator());
+  leaves_.push_back(leaf_info {offset, static_cast<uint32_t>(hashes_.size() - offset), sketch.is_empty(), sketch.get_theta64()});
+  nodes_.push_back(node_info {SKETCH, static_cast<uint32_t>(leaves_.size() - 1), 0});
+  return static_cast<node>(nodes_.size() - 1);
+}
+
+template<typename A>
+template<typename InputIt>
+auto theta_expression_alloc<A>::add_union(InputIt first, InputIt last) -> node {
+  return add_operation(UNION, first, last);
+}
+
+template<typename A>
+auto theta_expression_alloc<A>::add_union(std::initializer_list<node> nodes) -> node {
+  return add_operation(UNION, nodes.begin(), nodes.end());
+}
+
+template<typename A>
+template<typename InputIt>
+auto theta_expression_alloc<A>::add_intersection(InputIt first, InputIt last) -> node {
+  return add_operation(INTERSECTION, first, last);
+}
+
+template<typename A>
+auto theta_expression_alloc<A>::add_intersection(std::initializer_list<node> nodes) -> node {
+  return add_operation(INTERSECTION, nodes.begin(), nodes.end());
+}
+
+template<typename A>
+auto theta_expression_alloc<A>::add_a_not_b(node a, node b) -> node {
+  const node nodes[] = {a, b};
+  return add_operation(A_NOT_B, nodes, nodes + 2);
+}
+
+template<typename A>
+template<typename InputIt>
+auto theta_expression_alloc<A>::add_operation(node_type type, InputIt first, InputIt last) -> node {
+  const size_t position = children_.size();
+  for (auto it = first; it != last; ++it) {
+    try {
+      check_node(*it);
+    } catch (...) {
+      children_.resize(position);
+      throw;
+    }
+    children_.push_back(*it);
+  }
+  if (children_.size() == position) throw std::invalid_argument("operation must have at least one argument");
+  nodes_.push_back(node_info {type, static_cast<uint32_t>(position), static_cast<uint32_t>(children_.size() - position)});
+  return static_cast<node>(nodes_.size() - 1);
+}
+
+template<typename A>
+void theta_expression_alloc<A>::check_node(node n) const {
+  if (n >= nodes_.size()) throw std::invalid_argument("invalid node handle: " + std::to_string(n));
+}
+
+template<typename A>
+uint32_t theta_expression_alloc<A>::get_num_nodes() const {
+  return static_cast<uint32_t>(nodes_.size());
+}
+
+template<typename A>
+auto theta_expression_alloc<A>::evaluate(node root) const -> CompactSketch {
+  check_node(root);
+
+  // children are always added before their parents,
+  // so a backward pass finds reachable nodes and a forward pass propagates emptiness
+  const AllocBool alloc_bool(hashes_.get_allocator());
+  std::vector<bool, AllocBool> reachable(root + 1, false, alloc_bool);
+  reachable[root] = true;
+  for (uint32_t i = root + 1; i-- > 0;) {
+    if (!reachable[i] || nodes_[i].type == SKETCH) continue;
+    for (uint32_t j = 0; j < nodes_[i].num_children; ++j) reachable[children_[nodes_[i].first + j]] = true;
+  }
+  std::vector<bool, AllocBool> is_empty(root + 1, false, alloc_bool);
+  uint64_t theta = theta_constants::MAX_THETA;
+  for (uint32_t i = 0; i <= root; ++i) {
+    if (!reachable[i]) continue;
+    const node_info& n = nodes_[i];
+    const uint32_t* children = children_.data() + n.first;
+    switch (n.type) {
+    case SKETCH:
+      is_empty[i] = leaves_[n.first].is_empty;
+      if (!is_empty[i]) theta = std::min(theta, leaves_[n.first].theta);
+      break;
+    case UNION:
+      is_empty[i] = std::all_of(children, children + n.num_children, [&is_empty](uint32_t c) { return is_empty[c]; });
+      break;
+    case INTERSECTION:
+      is_empty[i] = std::any_of(children, children + n.num_children, [&is_empty](uint32_t c) { return is_empty[c]; });
+      break;
+    case A_NOT_B:
+      is_empty[i] = is_empty[children[0]];
+      break;
+    }
+  }
+  std::vector<uint64_t, A> entries(hashes_.get_allocator());
+  if (is_empty[root]) return CompactSketch(true, true, seed_hash_, theta_constants::MAX_THETA, std::move(entries));
+
+  // merge sorted hashes of the reachable leaves below theta
+  std::vector<cursor, AllocCursor> heap(hashes_.get_allocator());
+  std::vector<const uint64_t*, AllocPtr> positions(leaves_.size(), nullptr, hashes_.get_allocator());
+  std::vector<const uint64_t*, AllocPtr> ends(leaves_.size(), nullptr, hashes_.get_allocator());
+  for (uint32_t i = 0; i <= root; ++i) {
+    if (!reachable[i] || nodes_[i].type != SKETCH) continue;
+    const uint32_t leaf = nodes_[i].first;
+    const uint64_t* begin = hashes_.data() + leaves_[leaf].offset;
+    ends[leaf] = std::lower_bound(begin, begin + leaves_[leaf].num_entries, theta);
+    if (begin != ends[leaf]) {
+      positions[leaf] = begin;
+      heap.push_back(cursor(*begin, leaf));
+    }
+  }
+  std::make_heap(heap.begin(), heap.end(), std::greater<cursor>());
+  std::vector<uint64_t, A> stamps(leaves_.size(), 0, hashes_.get_allocator());
+  uint64_t stamp = 0;
+  while (!heap.empty()) {
+    const uint64_t hash = heap.front().first;
+    ++stamp;
+    while (!heap.empty() && heap.front().first == hash) {
+      std::pop_heap(heap.begin(), heap.end(), std::greater<cursor>());
+      const uint32_t leaf = heap.back().second;
+      stamps[leaf] = stamp;
+      if (++positions[leaf] != ends[leaf]) {
+        heap.back().first = *positions[leaf];
+        std::push_heap(heap.begin(), heap.end(), std::greater<cursor>());
+      } else {
+        heap.pop_back();
+      }
+    }
+    if (contains(root, stamps, stamp)) entries.push_back(hash);
+  }
+  const bool result_is_empty = entries.empty() && theta == theta_constants::MAX_THETA;
+  return CompactSketch(result_is_empty, true, seed_hash_, theta, std::move(entries));
+}
+
+template<typename A>
+bool theta_expression_alloc<A>::contains(node n, const std::vector<uint64_t, A>& stamps, uint64_t stamp) const {
+  const node_info& info = nodes_[n];
+  const uint32_t* children = children_.data() + info.first;
+  switch (info.type) {
+  case SKETCH:
+    return stamps[info.first] == stamp;
+  case UNION:
+    for (uint32_t i = 0; i < info.num_children; ++i) if (contains(children[i], stamps, stamp)) return true;
+    return false;
+  case INTERSECTION:
+    for (uint32_t i = 0; i < info.num_children; ++i) if (!contains(children[i], stamps, stamp)) return false;
+    return true;
+  case A_NOT_B:
+    return contains(children[0], stamps, stamp) && !contains(children[1], stamps, stamp);
+  }
+  return false;
+}
+
+} /* namespace datasketches */
+
+#endif
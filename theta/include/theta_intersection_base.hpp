@@ -20,6 +20,8 @@
 #ifndef THETA_INTERSECTION_BASE_HPP_
 #define THETA_INTERSECTION_BASE_HPP_
 
+#include <vector>
+
 namespace datasketches {
 
 template<
@@ -49,7 +51,14 @@ public:
 private:
   Policy policy_;
   bool is_valid_;
+  // while all inputs are ordered, the state is kept as a sorted vector of entries
+  // and intersected by a linear merge, otherwise in the hash table
+  bool is_ordered_;
   hash_table table_;
+  std::vector<Entry, Allocator> entries_;
+
+  uint32_t get_num_entries() const;
+  void convert_to_hash_table();
 };
 
 } /* namespace datasketches */
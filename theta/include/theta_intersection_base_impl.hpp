@@ -23,6 +23,7 @@
 #include <stdexcept>
 
 #include "conditional_forward.hpp"
+#include "theta_radix_sort.hpp"
 
 namespace datasketches {
 
@@ -30,7 +31,9 @@ template<typename EN, typename EK, typename P, typename S, typename CS, typename
 theta_intersection_base<EN, EK, P, S, CS, A>::theta_intersection_base(uint64_t seed, const P& policy, const A& allocator):
 policy_(policy),
 is_valid_(false),
-table_(0, 0, resize_factor::X1, 1, theta_constants::MAX_THETA, seed, allocator, false)
+is_ordered_(false),
+table_(0, 0, resize_factor::X1, 1, theta_constants::MAX_THETA, seed, allocator, false),
+entries_(allocator)
 {}
 
 template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
@@ -40,13 +43,48 @@ void theta_intersection_base<EN, EK, P, S, CS, A>::update(SS&& sketch) {
   if (!sketch.is_empty() && sketch.get_seed_hash() != compute_seed_hash(table_.seed_)) throw std::invalid_argument("seed hash mismatch");
   table_.is_empty_ |= sketch.is_empty();
   table_.theta_ = table_.is_empty_ ? theta_constants::MAX_THETA : std::min(table_.theta_, sketch.get_theta64());
-  if (is_valid_ && table_.num_entries_ == 0) return;
+  if (is_valid_ && get_num_entries() == 0) return;
   if (sketch.get_num_retained() == 0) {
     is_valid_ = true;
+    is_ordered_ = false;
+    entries_.clear();
     table_ = hash_table(0, 0, resize_factor::X1, 1, table_.theta_, table_.seed_, table_.allocator_, table_.is_empty_);
     return;
   }
-  if (!is_valid_) { // first update, copy or move incoming sketch
+  if (!is_valid_ && sketch.is_ordered()) { // first update, copy or move incoming ordered sketch
+    is_valid_ = true;
+    is_ordered_ = true;
+    entries_.reserve(sketch.get_num_retained());
+    for (auto&& entry: sketch) {
+      if (!entries_.empty() && !comparator()(entries_.back(), entry)) {
+        throw std::invalid_argument("duplicate or out of order key, possibly corrupted input sketch");
+      }
+      entries_.push_back(conditional_forward<SS>(entry));
+    }
+    if (entries_.size() != sketch.get_num_retained()) throw std::invalid_argument("num entries mismatch, possibly corrupted input sketch");
+  } else if (is_ordered_ && sketch.is_ordered()) { // sort-merge intersection
+    std::vector<EN, A> matched_entries(table_.allocator_);
+    matched_entries.reserve(std::min(get_num_entries(), sketch.get_num_retained()));
+    auto it = entries_.begin();
+    uint32_t count = 0;
+    for (auto&& entry: sketch) {
+      const uint64_t hash = EK()(entry);
+      if (hash >= table_.theta_) break; // early stop
+      while (it != entries_.end() && EK()(*it) < hash) ++it;
+      if (it == entries_.end()) break;
+      if (EK()(*it) == hash) {
+        policy_(*it, conditional_forward<SS>(entry));
+        matched_entries.push_back(std::move(*it));
+        ++it;
+      }
+      ++count;
+    }
+    if (count > sketch.get_num_retained()) {
+      throw std::invalid_argument(" more keys than expected, possibly corrupted input sketch");
+    }
+    entries_ = std::move(matched_entries);
+    if (entries_.empty() && table_.theta_ == theta_constants::MAX_THETA) table_.is_empty_ = true;
+  } else if (!is_valid_) { // first update, copy or move incoming sketch
     is_valid_ = true;
     const uint8_t lg_size = lg_size_from_count(sketch.get_num_retained(), theta_update_sketch_base<EN, EK, A>::REBUILD_THRESHOLD);
     table_ = hash_table(lg_size, lg_size - 1, resize_factor::X1, 1, table_.theta_, table_.seed_, table_.allocator_, table_.is_empty_);
@@ -58,7 +96,8 @@ void theta_intersection_base<EN, EK, P, S, CS, A>::update(SS&& sketch) {
       table_.insert(result.first, conditional_forward<SS>(entry));
     }
     if (table_.num_entries_ != sketch.get_num_retained()) throw std::invalid_argument("num entries mismatch, possibly corrupted input sketch");
-  } else { // intersection
+  } else { // hash-based intersection
+    if (is_ordered_) convert_to_hash_table();
     const uint32_t max_matches = std::min(table_.num_entries_, sketch.get_num_retained());
     std::vector<EN, A> matched_entries(table_.allocator_);
     matched_entries.reserve(max_matches);
@@ -100,11 +139,15 @@ void theta_intersection_base<EN, EK, P, S, CS, A>::update(SS&& sketch) {
 template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
 CS theta_intersection_base<EN, EK, P, S, CS, A>::get_result(bool ordered) const {
   if (!is_valid_) throw std::invalid_argument("calling get_result() before calling update() is undefined");
+  if (is_ordered_) {
+    // entries are already ordered, so the result is ordered regardless of the flag
+    return CS(table_.is_empty_, true, compute_seed_hash(table_.seed_), table_.theta_, std::vector<EN, A>(entries_));
+  }
   std::vector<EN, A> entries(table_.allocator_);
   if (table_.num_entries_ > 0) {
     entries.reserve(table_.num_entries_);
     std::copy_if(table_.begin(), table_.end(), std::back_inserter(entries), key_not_zero<EN, EK>());
-    if (ordered) std::sort(entries.begin(), entries.end(), comparator());
+    if (ordered) sort_by_key<EK>(entries.begin(), entries.end(), entries.get_allocator());
   }
   return CS(table_.is_empty_, ordered, compute_seed_hash(table_.seed_), table_.theta_, std::move(entries));
 }
@@ -119,4 +162,22 @@ const P& theta_intersection_base<EN, EK, P, S, CS, A>::get_policy() const {
   return policy_;
 }
 
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+uint32_t theta_intersection_base<EN, EK, P, S, CS, A>::get_num_entries() const {
+  return is_ordered_ ? static_cast<uint32_t>(entries_.size()) : table_.num_entries_;
+}
+
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+void theta_intersection_base<EN, EK, P, S, CS, A>::convert_to_hash_table() {
+  const uint8_t lg_size = lg_size_from_count(static_cast<uint32_t>(entries_.size()), hash_table::REBUILD_THRESHOLD);
+  table_ = hash_table(lg_size, lg_size - 1, resize_factor::X1, 1, table_.theta_, table_.seed_, table_.allocator_, table_.is_empty_);
+  for (auto& entry: entries_) {
+    auto result = table_.find(EK()(entry));
+    table_.insert(result.first, std::move(entry));
+  }
+  entries_.clear();
+  entries_.shrink_to_fit();
+  is_ordered_ = false;
+}
+
 } /* namespace datasketches */
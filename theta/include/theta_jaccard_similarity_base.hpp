@@ -22,11 +22,19 @@
 
 #include <memory>
 #include <array>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
 
 #include "theta_constants.hpp"
+#include "theta_update_sketch_base.hpp"
+#include "theta_radix_sort.hpp"
 #include "bounds_on_ratios_in_theta_sketched_sets.hpp"
 #include "ceiling_power_of_2.hpp"
 #include "common_defs.hpp"
+#include "thread_joiner.hpp"
 
 namespace datasketches {
 
@@ -34,6 +42,9 @@ namespace datasketches {
 template<typename Union, typename Intersection, typename ExtractKey>
 class jaccard_similarity_base {
 public:
+  using Allocator = decltype(std::declval<const typename Union::Sketch&>().get_allocator());
+  using AllocResult = typename std::allocator_traits<Allocator>::template rebind_alloc<std::array<double, 3>>;
+  using vector_result = std::vector<std::array<double, 3>, AllocResult>;
 
   /**
    * Computes the Jaccard similarity index with upper and lower bounds. The Jaccard similarity index
@@ -132,8 +143,171 @@ public:
     return jc[2] <= threshold;
   }
 
+  /**
+   * Computes the Jaccard similarity index of a query sketch with each sketch in a given range.
+   * The result for each sketch is the same as of jaccard(query, sketch), but the hashes of the query
+   * are indexed once for the whole range, and for each sketch only the common hashes are counted,
+   * so no union or intersection results are built.
+   * The range can be split into contiguous parts processed by separate threads.
+   * Memory is allocated using the allocator of the query sketch.
+   * @param query the query sketch
+   * @param first iterator to the first sketch to compare the query with
+   * @param last iterator past the last sketch to compare the query with
+   * @param seed for the hash function that was used to create the sketches
+   * @param num_threads number of threads to use (1 means the calling thread only)
+   * @return a vector of double arrays {LowerBound, Estimate, UpperBound}, one for each sketch in the range
+   */
+  template<typename Query, typename ForwardIt>
+  static vector_result jaccard_many(const Query& query, ForwardIt first, ForwardIt last,
+      uint64_t seed = DEFAULT_SEED, unsigned num_threads = 1) {
+    const sketch_index index(query, seed);
+    const size_t num_sketches = std::distance(first, last);
+    vector_result result(num_sketches, std::array<double, 3>(), AllocResult(query.get_allocator()));
+    if (num_threads > num_sketches) num_threads = static_cast<unsigned>(num_sketches);
+    if (num_threads <= 1) {
+      size_t i = 0;
+      for (ForwardIt it = first; it != last; ++it) result[i++] = jaccard_with_index(index, *it, seed);
+      return result;
+    }
+    // parts of the range and their offsets in the result
+    using AllocPart = typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<ForwardIt, size_t>>;
+    std::vector<std::pair<ForwardIt, size_t>, AllocPart> parts(AllocPart(query.get_allocator()));
+    parts.reserve(num_threads + 1);
+    parts.emplace_back(first, 0);
+    for (unsigned t = 0; t < num_threads; ++t) {
+      const size_t part_size = num_sketches / num_threads + (t < num_sketches % num_threads ? 1 : 0);
+      parts.emplace_back(std::next(parts.back().first, part_size), parts.back().second + part_size);
+    }
+    run_on_threads(num_threads, [&index, &result, &parts, seed](unsigned t) {
+      size_t i = parts[t].second;
+      for (ForwardIt it = parts[t].first; it != parts[t + 1].first; ++it) result[i++] = jaccard_with_index(index, *it, seed);
+    });
+    return result;
+  }
+
+  /**
+   * Computes the Jaccard similarity index of all pairs of sketches in a given range.
+   * Each sketch is indexed once and compared with all sketches after it in the range,
+   * the same way as in jaccard_many(). Rows are distributed over threads in a round-robin fashion.
+   * The index of each sketch is allocated using the allocator of that sketch.
+   * @param first iterator to the first sketch
+   * @param last iterator past the last sketch
+   * @param seed for the hash function that was used to create the sketches
+   * @param num_threads number of threads to use (1 means the calling thread only)
+   * @param allocator instance of an Allocator for the result
+   * @return a symmetric n by n matrix of double arrays {LowerBound, Estimate, UpperBound} in row-major order
+   */
+  template<typename ForwardIt>
+  static vector_result jaccard_matrix(ForwardIt first, ForwardIt last,
+      uint64_t seed = DEFAULT_SEED, unsigned num_threads = 1, const Allocator& allocator = Allocator()) {
+    using Sketch = typename std::iterator_traits<ForwardIt>::value_type;
+    using AllocSketchPtr = typename std::allocator_traits<Allocator>::template rebind_alloc<const Sketch*>;
+    std::vector<const Sketch*, AllocSketchPtr> sketches(allocator);
+    for (ForwardIt it = first; it != last; ++it) sketches.push_back(&*it);
+    const size_t n = sketches.size();
+    vector_result result(n * n, std::array<double, 3>(), AllocResult(allocator));
+    if (num_threads > n) num_threads = static_cast<unsigned>(n);
+    if (num_threads < 1) num_threads = 1;
+    auto compute_rows = [&sketches, &result, n, num_threads, seed](unsigned t) {
+      for (size_t i = t; i < n; i += num_threads) {
+        result[i * n + i] = {1, 1, 1};
+        const sketch_index index(*sketches[i], seed);
+        for (size_t j = i + 1; j < n; ++j) {
+          result[i * n + j] = jaccard_with_index(index, *sketches[j], seed);
+          result[j * n + i] = result[i * n + j];
+        }
+      }
+    };
+    if (num_threads == 1) {
+      compute_rows(0);
+      return result;
+    }
+    run_on_threads(num_threads, compute_rows);
+    return result;
+  }
+
 private:
 
+  // hashes of a sketch indexed for repeated comparisons
+  class sketch_index {
+  public:
+    using AllocU64 = typename std::allocator_traits<Allocator>::template rebind_alloc<uint64_t>;
+    using hash_table = theta_update_sketch_base<uint64_t, trivial_extract_key, AllocU64>;
+
+    template<typename Sketch>
+    sketch_index(const Sketch& sketch, uint64_t seed):
+    address_(&sketch),
+    is_empty_(sketch.is_empty()),
+    theta_(sketch.get_theta64()),
+    hashes_(AllocU64(sketch.get_allocator())),
+    table_(lg_size(sketch.get_num_retained()), lg_size(sketch.get_num_retained()), resize_factor::X1, 1,
+        theta_constants::MAX_THETA, seed, AllocU64(sketch.get_allocator()))
+    {
+      if (!is_empty_ && sketch.get_seed_hash() != compute_seed_hash(seed)) throw std::invalid_argument("seed hash mismatch");
+      hashes_.reserve(sketch.get_num_retained());
+      for (const auto& entry: sketch) {
+        const uint64_t hash = ExtractKey()(entry);
+        hashes_.push_back(hash);
+        auto result = table_.find(hash);
+        if (!result.second) table_.insert(result.first, hash);
+      }
+      if (!sketch.is_ordered()) sort_by_key<trivial_extract_key>(hashes_.begin(), hashes_.end(), hashes_.get_allocator());
+    }
+
+    bool contains(uint64_t hash) const { return table_.find(hash).second; }
+
+    uint64_t count_less_than(uint64_t theta) const {
+      if (theta == theta_) return hashes_.size();
+      return std::distance(hashes_.begin(), std::lower_bound(hashes_.begin(), hashes_.end(), theta));
+    }
+
+    const void* address_;
+    bool is_empty_;
+    uint64_t theta_;
+    std::vector<uint64_t, AllocU64> hashes_;
+    hash_table table_;
+
+  private:
+    // the load factor does not exceed 0.5, so the table never resizes
+    static uint8_t lg_size(uint32_t num_entries) {
+      return std::max(static_cast<uint8_t>(log2(ceiling_power_of_2(num_entries)) + 1), theta_constants::MIN_LG_K);
+    }
+  };
+
+  template<typename Sketch>
+  static std::array<double, 3> jaccard_with_index(const sketch_index& index, const Sketch& sketch, uint64_t seed) {
+    if (index.address_ == reinterpret_cast<const void*>(&sketch)) return {1, 1, 1};
+    if (index.is_empty_ && sketch.is_empty()) return {1, 1, 1};
+    if (index.is_empty_ || sketch.is_empty()) return {0, 0, 0};
+    if (sketch.get_seed_hash() != compute_seed_hash(seed)) throw std::invalid_argument("seed hash mismatch");
+
+    // the union and the intersection of the two sketches would both have the smaller theta
+    const uint64_t theta = std::min(index.theta_, sketch.get_theta64());
+    const uint64_t count_index = index.count_less_than(theta);
+    uint64_t count_sketch = 0;
+    uint64_t count_intersection = 0;
+    for (const auto& entry: sketch) {
+      const uint64_t hash = ExtractKey()(entry);
+      if (hash < theta) {
+        ++count_sketch;
+        if (index.contains(hash)) ++count_intersection;
+      } else if (sketch.is_ordered()) {
+        break;
+      }
+    }
+    const uint64_t count_union = count_index + count_sketch - count_intersection;
+    if (count_union == index.hashes_.size() && count_union == sketch.get_num_retained() &&
+        theta == index.theta_ && theta == sketch.get_theta64()) return {1, 1, 1};
+
+    if (count_union == 0) return {0, 0.5, 1};
+    const double f = static_cast<double>(theta) / static_cast<double>(theta_constants::MAX_THETA);
+    return {
+      bounds_on_ratios_in_sampled_sets::lower_bound_for_b_over_a(count_union, count_intersection, f),
+      static_cast<double>(count_intersection) / static_cast<double>(count_union),
+      bounds_on_ratios_in_sampled_sets::upper_bound_for_b_over_a(count_union, count_intersection, f)
+    };
+  }
+
   template<typename SketchA, typename SketchB>
   static typename Union::CompactSketch compute_union(const SketchA& sketch_a, const SketchB& sketch_b, uint64_t seed) {
     const auto count_a = sketch_a.get_num_retained();
@@ -0,0 +1,119 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef THETA_RADIX_SORT_HPP_
+#define THETA_RADIX_SORT_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#include "theta_comparators.hpp"
+
+namespace datasketches {
+
+namespace radix_sort_constants {
+  // below this number of entries std::sort is faster
+  static const size_t THRESHOLD = 2048;
+  static const unsigned DIGIT_BITS = 8;
+  static const unsigned NUM_BUCKETS = 1 << DIGIT_BITS;
+  static const unsigned NUM_PASSES = 64 / DIGIT_BITS;
+}
+
+/**
+ * Sorts entries in ascending order of their 64-bit keys.
+ * Large ranges are sorted using LSD radix sort with a scratch buffer obtained from the given allocator.
+ * Passes over digits that are the same in all keys are skipped, which is common
+ * since hashes are below theta. Entries that cannot be moved without exceptions
+ * and small ranges are sorted using std::sort.
+ * @param first iterator to the first entry
+ * @param last iterator past the last entry
+ * @param allocator to rebind for the scratch buffer
+ */
+template<typename ExtractKey, typename RandomIt, typename Allocator>
+void sort_by_key(RandomIt first, RandomIt last, const Allocator& allocator) {
+  using namespace radix_sort_constants;
+  using Entry = typename std::iterator_traits<RandomIt>::value_type;
+  using AllocEntry = typename std::allocator_traits<Allocator>::template rebind_alloc<Entry>;
+  using Traits = std::allocator_traits<AllocEntry>;
+  const size_t n = std::distance(first, last);
+  if (n < THRESHOLD || !std::is_nothrow_move_constructible<Entry>::value || !std::is_nothrow_move_assignable<Entry>::value) {
+    std::sort(first, last, compare_by_key<ExtractKey>());
+    return;
+  }
+
+  // histograms of all digits in one pass
+  size_t counts[NUM_PASSES][NUM_BUCKETS] = {};
+  for (auto it = first; it != last; ++it) {
+    const uint64_t key = ExtractKey()(*it);
+    for (unsigned pass = 0; pass < NUM_PASSES; ++pass) {
+      ++counts[pass][(key >> (pass * DIGIT_BITS)) & (NUM_BUCKETS - 1)];
+    }
+  }
+  // a pass over a digit that is the same in all keys would not move anything
+  const uint64_t first_key = ExtractKey()(*first);
+  bool skip[NUM_PASSES];
+  bool any_pass = false;
+  for (unsigned pass = 0; pass < NUM_PASSES; ++pass) {
+    skip[pass] = counts[pass][(first_key >> (pass * DIGIT_BITS)) & (NUM_BUCKETS - 1)] == n;
+    any_pass = any_pass || !skip[pass];
+  }
+  // all keys are the same
+  if (!any_pass) return;
+
+  AllocEntry alloc(allocator);
+  Entry* buffer = Traits::allocate(alloc, n);
+  bool in_buffer = false;
+  size_t offsets[NUM_BUCKETS];
+  for (unsigned pass = 0; pass < NUM_PASSES; ++pass) {
+    const unsigned shift = pass * DIGIT_BITS;
+    if (skip[pass]) continue;
+    size_t offset = 0;
+    for (unsigned i = 0; i < NUM_BUCKETS; ++i) {
+      offsets[i] = offset;
+      offset += counts[pass][i];
+    }
+    if (in_buffer) {
+      for (size_t i = 0; i < n; ++i) {
+        const uint64_t key = ExtractKey()(buffer[i]);
+        *(first + offsets[(key >> shift) & (NUM_BUCKETS - 1)]++) = std::move(buffer[i]);
+        Traits::destroy(alloc, buffer + i);
+      }
+    } else {
+      for (auto it = first; it != last; ++it) {
+        const uint64_t key = ExtractKey()(*it);
+        Traits::construct(alloc, buffer + offsets[(key >> shift) & (NUM_BUCKETS - 1)]++, std::move(*it));
+      }
+    }
+    in_buffer = !in_buffer;
+  }
+  if (in_buffer) {
+    for (size_t i = 0; i < n; ++i) {
+      *(first + i) = std::move(buffer[i]);
+      Traits::destroy(alloc, buffer + i);
+    }
+  }
+  Traits::deallocate(alloc, buffer, n);
+}
+
+} /* namespace datasketches */
+
+#endif
@@ -23,8 +23,8 @@
 #include <algorithm>
 #include <stdexcept>
 
-#include "conditional_back_inserter.hpp"
 #include "conditional_forward.hpp"
+#include "theta_radix_sort.hpp"
 
 namespace datasketches {
 
@@ -46,12 +46,25 @@ CS theta_set_difference_base<EN, EK, CS, A>::compute(FwdSketch&& a, const Sketch
   bool is_empty = a.is_empty();
 
   if (b.get_num_retained() == 0) {
-    std::copy_if(forward_begin(std::forward<FwdSketch>(a)), forward_end(std::forward<FwdSketch>(a)), std::back_inserter(entries),
-        key_less_than<uint64_t, EN, EK>(theta));
+    for (auto&& entry: a) {
+      if (EK()(entry) < theta) {
+        entries.push_back(conditional_forward<FwdSketch>(entry));
+      } else if (a.is_ordered()) {
+        break; // early stop
+      }
+    }
   } else {
     if (a.is_ordered() && b.is_ordered()) { // sort-based
-      std::set_difference(forward_begin(std::forward<FwdSketch>(a)), forward_end(std::forward<FwdSketch>(a)), b.begin(), b.end(),
-          conditional_back_inserter(entries, key_less_than<uint64_t, EN, EK>(theta)), comparator());
+      // linear merge that stops at theta, so that entries of wrapped compressed sketches
+      // at or above theta are not decoded at all
+      auto it_b = b.begin();
+      const auto end_b = b.end();
+      for (auto&& entry: a) {
+        const uint64_t hash = EK()(entry);
+        if (hash >= theta) break;
+        while (it_b != end_b && EK()(*it_b) < hash) ++it_b;
+        if (it_b == end_b || EK()(*it_b) != hash) entries.push_back(conditional_forward<FwdSketch>(entry));
+      }
     } else { // hash-based
       const uint8_t lg_size = lg_size_from_count(b.get_num_retained(), hash_table::REBUILD_THRESHOLD);
       hash_table table(lg_size, lg_size, hash_table::resize_factor::X1, 1, 0, 0, allocator_); // theta and seed are not used here
@@ -77,7 +90,7 @@ CS theta_set_difference_base<EN, EK, CS, A>::compute(FwdSketch&& a, const Sketch
     }
   }
   if (entries.empty() && theta == theta_constants::MAX_THETA) is_empty = true;
-  if (ordered && !a.is_ordered()) std::sort(entries.begin(), entries.end(), comparator());
+  if (ordered && !a.is_ordered()) sort_by_key<EK>(entries.begin(), entries.end(), entries.get_allocator());
   return CS(is_empty, a.is_ordered() || ordered, seed_hash_, theta, std::move(entries));
 }
 
@@ -319,6 +319,41 @@ public:
    */
   void update(const void* data, size_t length);
 
+  /**
+   * Update this sketch with a batch of unsigned 64-bit integers.
+   * The result is the same as calling update(uint64_t) for each item, but the items are hashed
+   * in blocks by a specialized 8-byte kernel and the hash table slots are prefetched
+   * before inserting to hide memory latency.
+   * @param items pointer to the array of items
+   * @param num_items number of items in the array
+   */
+  void update_batch(const uint64_t* items, size_t num_items);
+
+  /**
+   * Update this sketch with a batch of signed 64-bit integers.
+   * The result is the same as calling update(int64_t) for each item.
+   * @param items pointer to the array of items
+   * @param num_items number of items in the array
+   */
+  void update_batch(const int64_t* items, size_t num_items);
+
+  /**
+   * Update this sketch with a batch of double-precision floating point values.
+   * The result is the same as calling update(double) for each item.
+   * @param items pointer to the array of items
+   * @param num_items number of items in the array
+   */
+  void update_batch(const double* items, size_t num_items);
+
+  /**
+   * Update this sketch with a batch of strings.
+   * The result is the same as calling update(const std::string&) for each item.
+   * Empty strings are ignored.
+   * @param items pointer to the array of items
+   * @param num_items number of items in the array
+   */
+  void update_batch(const std::string* items, size_t num_items);
+
   /**
    * Remove retained entries in excess of the nominal size k (if any)
    */
@@ -348,6 +383,11 @@ private:
   update_theta_sketch_alloc(uint8_t lg_cur_size, uint8_t lg_nom_size, resize_factor rf, float p,
       uint64_t theta, uint64_t seed, const Allocator& allocator);
 
+  template<typename HashAndScreen>
+  void update_batch_impl(size_t num_items, HashAndScreen&& hash_and_screen);
+  void update_batch_keys(const uint64_t* keys, size_t num_keys);
+  void insert_batch(const uint64_t* hashes, uint8_t num_hashes);
+
   virtual void print_specifics(std::ostringstream& os) const;
 };
 
@@ -501,6 +541,8 @@ private:
   std::vector<uint64_t, Allocator> entries_;
 
   uint8_t get_preamble_longs(bool compressed) const;
+  static uint8_t get_preamble_longs(bool is_empty, uint64_t theta, uint32_t num_entries);
+  static size_t write_preamble(uint8_t* ptr, bool is_empty, bool is_ordered, uint16_t seed_hash, uint64_t theta, uint32_t num_entries);
   bool is_suitable_for_compression() const;
   uint8_t compute_entry_bits() const;
   uint8_t get_num_entries_bytes() const;
@@ -518,6 +560,8 @@ private:
   template<typename E, typename EK, typename P, typename S, typename CS, typename A> friend class theta_union_base;
   template<typename E, typename EK, typename P, typename S, typename CS, typename A> friend class theta_intersection_base;
   template<typename E, typename EK, typename CS, typename A> friend class theta_set_difference_base;
+  template<typename A> friend class concurrent_theta_sketch_alloc;
+  template<typename A> friend class theta_expression_alloc;
   compact_theta_sketch_alloc(bool is_empty, bool is_ordered, uint16_t seed_hash, uint64_t theta, std::vector<uint64_t, Allocator>&& entries);
 };
 
@@ -29,6 +29,7 @@
 #include "count_zeros.hpp"
 #include "bit_packing.hpp"
 #include "memory_operations.hpp"
+#include "theta_radix_sort.hpp"
 
 namespace datasketches {
 
@@ -208,6 +209,89 @@ void update_theta_sketch_alloc<A>::update(const void* data, size_t length) {
   }
 }
 
+template<typename A>
+void update_theta_sketch_alloc<A>::update_batch(const uint64_t* items, size_t num_items) {
+  update_batch_keys(items, num_items);
+}
+
+template<typename A>
+void update_theta_sketch_alloc<A>::update_batch(const int64_t* items, size_t num_items) {
+  update_batch_keys(reinterpret_cast<const uint64_t*>(items), num_items);
+}
+
+template<typename A>
+void update_theta_sketch_alloc<A>::update_batch(const double* items, size_t num_items) {
+  uint64_t keys[theta_table::BATCH_SIZE];
+  while (num_items > 0) {
+    const uint8_t block_size = static_cast<uint8_t>(num_items < theta_table::BATCH_SIZE ? num_items : theta_table::BATCH_SIZE);
+    for (uint8_t i = 0; i < block_size; ++i) keys[i] = canonical_double(items[i]);
+    update_batch_keys(keys, block_size);
+    items += block_size;
+    num_items -= block_size;
+  }
+}
+
+template<typename A>
+void update_theta_sketch_alloc<A>::update_batch(const std::string* items, size_t num_items) {
+  update_batch_impl(num_items, [this, items](size_t i) -> uint64_t {
+    if (items[i].empty()) return 0;
+    return table_.hash_and_screen(items[i].c_str(), items[i].length());
+  });
+}
+
+template<typename A>
+template<typename HashAndScreen>
+void update_theta_sketch_alloc<A>::update_batch_impl(size_t num_items, HashAndScreen&& hash_and_screen) {
+  uint64_t hashes[theta_table::BATCH_SIZE] = {};
+  uint8_t num_hashes = 0;
+  for (size_t i = 0; i < num_items; ++i) {
+    const uint64_t hash = hash_and_screen(i);
+    if (hash == 0) continue;
+    table_.prefetch(hash);
+    hashes[num_hashes++] = hash;
+    if (num_hashes == theta_table::BATCH_SIZE) {
+      insert_batch(hashes, num_hashes);
+      num_hashes = 0;
+    }
+  }
+  insert_batch(hashes, num_hashes);
+}
+
+template<typename A>
+void update_theta_sketch_alloc<A>::update_batch_keys(const uint64_t* keys, size_t num_keys) {
+  if (num_keys == 0) return;
+  table_.is_empty_ = false;
+  HashState hash_states[theta_table::BATCH_SIZE];
+  uint64_t hashes[theta_table::BATCH_SIZE];
+  while (num_keys > 0) {
+    const uint8_t block_size = static_cast<uint8_t>(num_keys < theta_table::BATCH_SIZE ? num_keys : theta_table::BATCH_SIZE);
+    MurmurHash3_x64_128_batch(keys, block_size, table_.seed_, hash_states);
+    uint8_t num_hashes = 0;
+    for (uint8_t i = 0; i < block_size; ++i) {
+      const uint64_t hash = hash_states[i].h1 >> 1; // same as compute_hash()
+      if (hash == 0 || hash >= table_.theta_) continue;
+      table_.prefetch(hash);
+      hashes[num_hashes++] = hash;
+    }
+    insert_batch(hashes, num_hashes);
+    keys += block_size;
+    num_keys -= block_size;
+  }
+}
+
+// hashes were screened against theta before insertion of the preceding ones,
+// which could have reduced theta or resized the table
+template<typename A>
+void update_theta_sketch_alloc<A>::insert_batch(const uint64_t* hashes, uint8_t num_hashes) {
+  for (uint8_t i = 0; i < num_hashes; ++i) {
+    if (hashes[i] >= table_.theta_) continue;
+    auto result = table_.find(hashes[i]);
+    if (!result.second) {
+      table_.insert(result.first, hashes[i]);
+    }
+  }
+}
+
 template<typename A>
 void update_theta_sketch_alloc<A>::trim() {
   table_.trim();
@@ -274,7 +358,7 @@ entries_(other.get_allocator())
   if (!other.is_empty()) {
     entries_.reserve(other.get_num_retained());
     std::copy(other.begin(), other.end(), std::back_inserter(entries_));
-    if (ordered && !other.is_ordered()) std::sort(entries_.begin(), entries_.end());
+    if (ordered && !other.is_ordered()) sort_by_key<trivial_extract_key>(entries_.begin(), entries_.end(), entries_.get_allocator());
   }
 }
 
@@ -346,7 +430,13 @@ uint8_t compact_theta_sketch_alloc<A>::get_preamble_longs(bool compressed) const
   if (compressed) {
     return this->is_estimation_mode() ? 2 : 1;
   }
-  return this->is_estimation_mode() ? 3 : this->is_empty() || entries_.size() == 1 ? 1 : 2;
+  return get_preamble_longs(this->is_empty(), theta_, static_cast<uint32_t>(entries_.size()));
+}
+
+template<typename A>
+uint8_t compact_theta_sketch_alloc<A>::get_preamble_longs(bool is_empty, uint64_t theta, uint32_t num_entries) {
+  const bool is_estimation_mode = theta < theta_constants::MAX_THETA && !is_empty;
+  return is_estimation_mode ? 3 : is_empty || num_entries == 1 ? 1 : 2;
 }
 
 template<typename A>
@@ -402,26 +492,35 @@ auto compact_theta_sketch_alloc<A>::serialize(unsigned header_size_bytes) const
   const size_t size = get_serialized_size_bytes() + header_size_bytes;
   vector_bytes bytes(size, 0, entries_.get_allocator());
   uint8_t* ptr = bytes.data() + header_size_bytes;
-  const uint8_t preamble_longs = get_preamble_longs(false);
+  ptr += write_preamble(ptr, this->is_empty(), this->is_ordered(), get_seed_hash(), theta_, static_cast<uint32_t>(entries_.size()));
+  if (entries_.size() > 0) ptr += copy_to_mem(entries_.data(), ptr, entries_.size() * sizeof(uint64_t));
+  return bytes;
+}
+
+template<typename A>
+size_t compact_theta_sketch_alloc<A>::write_preamble(uint8_t* ptr, bool is_empty, bool is_ordered, uint16_t seed_hash,
+    uint64_t theta, uint32_t num_entries) {
+  // unused fields are written explicitly since the buffer might not be zeroed
+  uint8_t* start = ptr;
+  const uint8_t preamble_longs = get_preamble_longs(is_empty, theta, num_entries);
   *ptr++ = preamble_longs;
   *ptr++ = UNCOMPRESSED_SERIAL_VERSION;
   *ptr++ = SKETCH_TYPE;
-  ptr += sizeof(uint16_t); // unused
+  ptr += copy_to_mem(static_cast<uint16_t>(0), ptr); // unused
   const uint8_t flags_byte(
     (1 << flags::IS_COMPACT) |
     (1 << flags::IS_READ_ONLY) |
-    (this->is_empty() ? 1 << flags::IS_EMPTY : 0) |
-    (this->is_ordered() ? 1 << flags::IS_ORDERED : 0)
+    (is_empty ? 1 << flags::IS_EMPTY : 0) |
+    (is_ordered ? 1 << flags::IS_ORDERED : 0)
   );
   *ptr++ = flags_byte;
-  ptr += copy_to_mem(get_seed_hash(), ptr);
+  ptr += copy_to_mem(seed_hash, ptr);
   if (preamble_longs > 1) {
-    ptr += copy_to_mem(static_cast<uint32_t>(entries_.size()), ptr);
-    ptr += sizeof(uint32_t); // unused
+    ptr += copy_to_mem(num_entries, ptr);
+    ptr += copy_to_mem(static_cast<uint32_t>(0), ptr); // unused
   }
-  if (this->is_estimation_mode()) ptr += copy_to_mem(theta_, ptr);
-  if (entries_.size() > 0) ptr += copy_to_mem(entries_.data(), ptr, entries_.size() * sizeof(uint64_t));
-  return bytes;
+  if (preamble_longs > 2) ptr += copy_to_mem(theta, ptr);
+  return ptr - start;
 }
 
 template<typename A>
@@ -685,26 +784,21 @@ compact_theta_sketch_alloc<A> compact_theta_sketch_alloc<A>::deserialize_v4(
   for (unsigned i = 0; i < num_entries_bytes; ++i) {
     num_entries |= read<uint8_t>(is) << (i << 3);
   }
-  vector_bytes buffer(entry_bits, 0, allocator); // block of 8 entries takes entry_bits bytes
+  // block of 8 entries takes entry_bits bytes
+  const uint32_t num_blocks = num_entries / 8;
+  const size_t blocks_bytes = static_cast<size_t>(num_blocks) * entry_bits;
+  vector_bytes buffer(blocks_bytes + whole_bytes_to_hold_bits((num_entries - num_blocks * 8) * entry_bits), 0, allocator);
+  read(is, buffer.data(), buffer.size());
+  if (!is.good()) throw std::runtime_error("error reading from std::istream");
   std::vector<uint64_t, A> entries(num_entries, 0, allocator);
 
-  // unpack blocks of 8 deltas
-  unsigned i;
-  for (i = 0; i + 7 < num_entries; i += 8) {
-    read(is, buffer.data(), buffer.size());
-    unpack_bits_block8(&entries[i], buffer.data(), entry_bits);
-  }
+  // unpack blocks of 8 deltas and undo deltas
+  uint64_t previous = unpack_deltas_blocks8(entries.data(), buffer.data(), entry_bits, num_blocks, 0);
   // unpack extra deltas if fewer than 8 of them left
-  if (i < num_entries) read(is, buffer.data(), whole_bytes_to_hold_bits((num_entries - i) * entry_bits));
-  if (!is.good()) throw std::runtime_error("error reading from std::istream");
-  const uint8_t* ptr = buffer.data();
+  const uint8_t* ptr = buffer.data() + blocks_bytes;
   uint8_t offset = 0;
-  for (; i < num_entries; ++i) {
+  for (uint32_t i = num_blocks * 8; i < num_entries; ++i) {
     offset = unpack_bits(entries[i], entry_bits, ptr, offset);
-  }
-  // undo deltas
-  uint64_t previous = 0;
-  for (i = 0; i < num_entries; ++i) {
     entries[i] += previous;
     previous = entries[i];
   }
@@ -722,20 +816,14 @@ compact_theta_sketch_alloc<A> compact_theta_sketch_alloc<A>::deserialize(const v
   } else { // version 4
     std::vector<uint64_t, A> entries(data.num_entries, 0, allocator);
     const uint8_t* ptr = reinterpret_cast<const uint8_t*>(data.entries_start_ptr);
-    // unpack blocks of 8 deltas
-    unsigned i;
-    for (i = 0; i + 7 < data.num_entries; i += 8) {
-      unpack_bits_block8(&entries[i], ptr, data.entry_bits);
-      ptr += data.entry_bits;
-    }
+    // unpack blocks of 8 deltas and undo deltas
+    const uint32_t num_blocks = data.num_entries / 8;
+    uint64_t previous = unpack_deltas_blocks8(entries.data(), ptr, data.entry_bits, num_blocks, 0);
+    ptr += static_cast<size_t>(num_blocks) * data.entry_bits;
     // unpack extra deltas if fewer than 8 of them left
     uint8_t offset = 0;
-    for (; i < data.num_entries; ++i) {
+    for (uint32_t i = num_blocks * 8; i < data.num_entries; ++i) {
       offset = unpack_bits(entries[i], data.entry_bits, ptr, offset);
-    }
-    // undo deltas
-    uint64_t previous = 0;
-    for (i = 0; i < data.num_entries; ++i) {
       entries[i] += previous;
       previous = entries[i];
     }
@@ -863,12 +951,8 @@ void wrapped_compact_theta_sketch_alloc<Allocator>::const_iterator::unpack1() {
 
 template<typename Allocator>
 void wrapped_compact_theta_sketch_alloc<Allocator>::const_iterator::unpack8() {
-  unpack_bits_block8(buffer_, reinterpret_cast<const uint8_t*>(ptr_), entry_bits_);
+  previous_ = unpack_deltas_blocks8(buffer_, reinterpret_cast<const uint8_t*>(ptr_), entry_bits_, 1, previous_);
   ptr_ = reinterpret_cast<const uint8_t*>(ptr_) + entry_bits_;
-  for (int i = 0; i < 8; ++i) {
-    buffer_[i] += previous_;
-    previous_ = buffer_[i];
-  }
 }
 
 template<typename Allocator>
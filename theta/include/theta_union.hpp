@@ -53,6 +53,10 @@ public:
     }
   };
   using State = theta_union_base<Entry, ExtractKey, nop_policy, Sketch, CompactSketch, Allocator>;
+  using vector_bytes = typename State::vector_bytes;
+
+  /// family ID of the serialized state
+  static const uint8_t STATE_FAMILY = 4;
 
   // No constructor here. Use builder instead.
   class builder;
@@ -64,6 +68,19 @@ public:
   template<typename FwdSketch>
   void update(FwdSketch&& sketch);
 
+  /**
+   * Update the union with a range of sketches.
+   * The smallest theta of all sketches in the range is taken into account upfront,
+   * so that entries that cannot make it into the result are skipped.
+   * The range is split into contiguous parts, each part is reduced into a partial union
+   * in a separate thread, and partial unions are merged into this one at the end.
+   * @param first iterator to the first sketch
+   * @param last iterator past the last sketch
+   * @param num_threads number of threads to use (1 means the calling thread only)
+   */
+  template<typename ForwardIt>
+  void update(ForwardIt first, ForwardIt last, unsigned num_threads = 1);
+
   /**
    * Produces a copy of the current state of the union as a compact sketch.
    * @param ordered optional flag to specify if an ordered sketch should be produced
@@ -71,12 +88,91 @@ public:
    */
   CompactSketch get_result(bool ordered = true) const;
 
+  /**
+   * Writes the current state of the union into a given compact sketch, reusing its storage.
+   * The entries of the given sketch are first sized to the number of entries in the hash table of the union,
+   * which can be larger than the number of entries in the result. No memory is allocated as long as the
+   * capacity of the given sketch covers the table, so a sketch that previously held only a smaller result
+   * can grow once.
+   * @param result compact sketch to write the result into
+   * @param ordered optional flag to specify if an ordered sketch should be produced
+   */
+  void get_result(CompactSketch& result, bool ordered = true) const;
+
+  /**
+   * Computes size in bytes a buffer must have to serialize the current state of the union
+   * using serialize_result(). This can be larger than the size of the serialized result.
+   * @return size in bytes
+   */
+  size_t get_max_serialized_result_size_bytes() const;
+
+  /**
+   * Serializes the current state of the union into a given buffer without building a compact sketch.
+   * The binary form is the same as produced by compact_theta_sketch::serialize(),
+   * so it can be deserialized or wrapped.
+   * The buffer is used as scratch space to select and sort the entries,
+   * so it must be aligned to 8 bytes and at least get_max_serialized_result_size_bytes() long.
+   * @param bytes pointer to the buffer
+   * @param size size of the buffer in bytes
+   * @param ordered optional flag to specify if an ordered sketch should be produced
+   * @return number of bytes written
+   */
+  size_t serialize_result(void* bytes, size_t size, bool ordered = true) const;
+
   /// Reset the union to the initial empty state
   void reset();
 
+  /**
+   * Serializes the internal state of the union including the hash table into a given stream.
+   * Unlike the result, the state can be deserialized to continue the union.
+   * @param os output stream
+   */
+  void serialize(std::ostream& os) const;
+
+  /**
+   * Serializes the internal state of the union including the hash table as a vector of bytes.
+   * An optional header can be reserved in front of the state.
+   * It is a blank space of a given size.
+   * @param header_size_bytes space to reserve in front of the state
+   * @return serialized state as a vector of bytes
+   */
+  vector_bytes serialize(unsigned header_size_bytes = 0) const;
+
+  /**
+   * Deserializes the state of a union from a given stream to continue the union.
+   * @param is input stream
+   * @param seed the seed for the hash function that was used to create the union
+   * @param allocator instance of an Allocator
+   * @return an instance of the union
+   */
+  static theta_union_alloc deserialize(std::istream& is, uint64_t seed = DEFAULT_SEED, const Allocator& allocator = Allocator());
+
+  /**
+   * Deserializes the state of a union from a given array of bytes to continue the union.
+   * @param bytes pointer to the array of bytes
+   * @param size the size of the array
+   * @param seed the seed for the hash function that was used to create the union
+   * @param allocator instance of an Allocator
+   * @return an instance of the union
+   */
+  static theta_union_alloc deserialize(const void* bytes, size_t size, uint64_t seed = DEFAULT_SEED,
+      const Allocator& allocator = Allocator());
+
 private:
   State state_;
 
+  // serialization of the hash table entries in the state
+  struct state_serde {
+    static const uint8_t FAMILY = STATE_FAMILY;
+    void serialize(std::ostream& os, uint64_t entry) const { write(os, entry); }
+    size_t serialize(void* ptr, size_t capacity, uint64_t entry) const;
+    size_t size_of(uint64_t) const { return sizeof(uint64_t); }
+    uint64_t deserialize(std::istream& is) const { return read<uint64_t>(is); }
+    uint64_t deserialize(const void* ptr, size_t capacity, size_t& size) const;
+  };
+
+  explicit theta_union_alloc(State&& state);
+
   // for builder
   theta_union_alloc(uint8_t lg_cur_size, uint8_t lg_nom_size, resize_factor rf, float p, uint64_t theta, uint64_t seed, const Allocator& allocator);
 };
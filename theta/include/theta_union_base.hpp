@@ -20,6 +20,9 @@
 #ifndef THETA_UNION_BASE_HPP_
 #define THETA_UNION_BASE_HPP_
 
+#include <iostream>
+#include <vector>
+
 #include "theta_update_sketch_base.hpp"
 
 namespace datasketches {
@@ -37,22 +40,69 @@ public:
   using hash_table = theta_update_sketch_base<Entry, ExtractKey, Allocator>;
   using resize_factor = typename hash_table::resize_factor;
   using comparator = compare_by_key<ExtractKey>;
+  using AllocBytes = typename std::allocator_traits<Allocator>::template rebind_alloc<uint8_t>;
+  using vector_bytes = std::vector<uint8_t, AllocBytes>;
+
+  // not accepted by any compact sketch reader, some of which share the family ID with the state
+  static const uint8_t STATE_SERIAL_VERSION = 5;
+  static const uint8_t STATE_PREAMBLE_LONGS = 5;
+  enum flags { IS_BIG_ENDIAN, IS_READ_ONLY, IS_EMPTY };
 
   theta_union_base(uint8_t lg_cur_size, uint8_t lg_nom_size, resize_factor rf, float p, uint64_t theta, uint64_t seed, const Policy& policy, const Allocator& allocator);
 
   template<typename FwdSketch>
   void update(FwdSketch&& sketch);
 
+  template<typename ForwardIt>
+  void update(ForwardIt first, ForwardIt last, unsigned num_threads);
+
   CompactSketch get_result(bool ordered = true) const;
 
+  // reuses the storage of the given sketch
+  void get_result(CompactSketch& result, bool ordered) const;
+
+  size_t get_max_serialized_result_size_bytes() const;
+
+  // the buffer is used as scratch space, so it must be large enough for all retained entries
+  size_t serialize_result(void* bytes, size_t size, bool ordered) const;
+
   const Policy& get_policy() const;
 
   void reset();
 
+  // serialization of the internal state including the hash table
+  // EntrySerDe serializes entries and defines the family
+  template<typename EntrySerDe>
+  void serialize(std::ostream& os, const EntrySerDe& sd) const;
+
+  template<typename EntrySerDe>
+  vector_bytes serialize(unsigned header_size_bytes, const EntrySerDe& sd) const;
+
+  template<typename EntrySerDe>
+  static theta_union_base deserialize(std::istream& is, uint64_t seed, const EntrySerDe& sd,
+      const Policy& policy, const Allocator& allocator);
+
+  template<typename EntrySerDe>
+  static theta_union_base deserialize(const void* bytes, size_t size, uint64_t seed, const EntrySerDe& sd,
+      const Policy& policy, const Allocator& allocator);
+
 private:
   Policy policy_;
   hash_table table_;
   uint64_t union_theta_;
+
+  theta_union_base make_empty_copy() const;
+  void merge(theta_union_base&& other);
+
+  template<typename OutputIt>
+  OutputIt copy_result_entries(OutputIt out, uint64_t& theta) const;
+
+  template<typename RandomIt>
+  RandomIt trim_result_entries(RandomIt first, RandomIt last, uint64_t& theta) const;
+
+  static void check_state(uint8_t lg_cur_size, uint8_t lg_nom_size, uint8_t rf, uint32_t num_entries,
+      float p, uint64_t theta, uint64_t union_theta);
+  void insert_state_entry(Entry&& entry);
 };
 
 } /* namespace datasketches */
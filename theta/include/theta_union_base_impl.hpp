@@ -22,8 +22,14 @@
 
 #include <algorithm>
 #include <stdexcept>
+#include <iterator>
+#include <cstring>
 
 #include "conditional_forward.hpp"
+#include "memory_operations.hpp"
+#include "theta_helpers.hpp"
+#include "theta_radix_sort.hpp"
+#include "thread_joiner.hpp"
 
 namespace datasketches {
 
@@ -58,28 +64,159 @@ void theta_union_base<EN, EK, P, S, CS, A>::update(SS&& sketch) {
   union_theta_ = std::min(union_theta_, table_.theta_);
 }
 
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+template<typename ForwardIt>
+void theta_union_base<EN, EK, P, S, CS, A>::update(ForwardIt first, ForwardIt last, unsigned num_threads) {
+  // no entry at or above the smallest theta of all inputs can make it into the result,
+  // so lower union theta upfront to skip such entries from the very first sketch,
+  // but only once all inputs are known to be compatible
+  const uint16_t seed_hash = compute_seed_hash(table_.seed_);
+  uint64_t min_theta = union_theta_;
+  for (ForwardIt it = first; it != last; ++it) {
+    if ((*it).is_empty()) continue;
+    if ((*it).get_seed_hash() != seed_hash) throw std::invalid_argument("seed hash mismatch");
+    min_theta = std::min(min_theta, (*it).get_theta64());
+  }
+  union_theta_ = min_theta;
+
+  const size_t num_sketches = std::distance(first, last);
+  if (num_threads > num_sketches) num_threads = static_cast<unsigned>(num_sketches);
+  if (num_threads <= 1) {
+    for (ForwardIt it = first; it != last; ++it) update(*it);
+    return;
+  }
+
+  // each thread reduces a contiguous part of the range into its own partial union
+  std::vector<theta_union_base> partials;
+  partials.reserve(num_threads);
+  for (unsigned i = 0; i < num_threads; ++i) partials.push_back(make_empty_copy());
+  std::vector<ForwardIt> part_firsts;
+  part_firsts.reserve(num_threads + 1);
+  part_firsts.push_back(first);
+  for (unsigned i = 0; i < num_threads; ++i) {
+    const size_t part_size = num_sketches / num_threads + (i < num_sketches % num_threads ? 1 : 0);
+    part_firsts.push_back(std::next(part_firsts.back(), part_size));
+  }
+  run_on_threads(num_threads, [&partials, &part_firsts](unsigned i) {
+    for (ForwardIt it = part_firsts[i]; it != part_firsts[i + 1]; ++it) partials[i].update(*it);
+  });
+  for (auto& partial: partials) merge(std::move(partial));
+}
+
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+auto theta_union_base<EN, EK, P, S, CS, A>::make_empty_copy() const -> theta_union_base {
+  const uint8_t lg_cur_size = theta_build_helper<true>::starting_sub_multiple(
+      table_.lg_nom_size_ + 1, theta_constants::MIN_LG_K, static_cast<uint8_t>(table_.rf_));
+  theta_union_base copy(lg_cur_size, table_.lg_nom_size_, table_.rf_, table_.p_,
+      theta_build_helper<true>::starting_theta_from_p(table_.p_), table_.seed_, policy_, table_.allocator_);
+  copy.union_theta_ = union_theta_;
+  return copy;
+}
+
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+void theta_union_base<EN, EK, P, S, CS, A>::merge(theta_union_base&& other) {
+  if (other.table_.is_empty_) return;
+  table_.is_empty_ = false;
+  union_theta_ = std::min(union_theta_, std::min(other.union_theta_, other.table_.theta_));
+  for (auto& entry: other.table_) {
+    const uint64_t hash = EK()(entry);
+    if (hash != 0 && hash < union_theta_ && hash < table_.theta_) {
+      auto result = table_.find(hash);
+      if (!result.second) {
+        table_.insert(result.first, std::move(entry));
+      } else {
+        policy_(*result.first, std::move(entry));
+      }
+    }
+  }
+  union_theta_ = std::min(union_theta_, table_.theta_);
+}
+
 template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
 CS theta_union_base<EN, EK, P, S, CS, A>::get_result(bool ordered) const {
   std::vector<EN, A> entries(table_.allocator_);
   if (table_.is_empty_) return CS(true, true, compute_seed_hash(table_.seed_), union_theta_, std::move(entries));
   entries.reserve(table_.num_entries_);
-  uint64_t theta = std::min(union_theta_, table_.theta_);
-  const uint32_t nominal_num = 1 << table_.lg_nom_size_;
-  if (union_theta_ >= table_.theta_) {
-    std::copy_if(table_.begin(), table_.end(), std::back_inserter(entries), key_not_zero<EN, EK>());
-  } else {
-    std::copy_if(table_.begin(), table_.end(), std::back_inserter(entries), key_not_zero_less_than<uint64_t, EN, EK>(theta));
-  }
-  if (entries.size() > nominal_num) {
-    std::nth_element(entries.begin(), entries.begin() + nominal_num, entries.end(), comparator());
-    theta = EK()(entries[nominal_num]);
-    entries.erase(entries.begin() + nominal_num, entries.end());
+  uint64_t theta;
+  copy_result_entries(std::back_inserter(entries), theta);
+  auto last = trim_result_entries(entries.begin(), entries.end(), theta);
+  if (ordered) sort_by_key<EK>(entries.begin(), last, table_.allocator_);
+  if (last != entries.end()) {
+    entries.erase(last, entries.end());
     entries.shrink_to_fit();
   }
-  if (ordered) std::sort(entries.begin(), entries.end(), comparator());
   return CS(table_.is_empty_, ordered, compute_seed_hash(table_.seed_), theta, std::move(entries));
 }
 
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+void theta_union_base<EN, EK, P, S, CS, A>::get_result(CS& result, bool ordered) const {
+  result.is_empty_ = table_.is_empty_;
+  result.seed_hash_ = compute_seed_hash(table_.seed_);
+  result.theta_ = union_theta_;
+  // resizing within the existing capacity does not allocate
+  result.entries_.resize(table_.num_entries_);
+  if (!table_.is_empty_) {
+    auto last = copy_result_entries(result.entries_.begin(), result.theta_);
+    last = trim_result_entries(result.entries_.begin(), last, result.theta_);
+    // radix sort would allocate a scratch buffer
+    if (ordered) std::sort(result.entries_.begin(), last, comparator());
+    result.entries_.resize(std::distance(result.entries_.begin(), last));
+  }
+  // same rule as the compact sketch constructor used by get_result()
+  result.is_ordered_ = ordered || result.entries_.size() <= 1;
+}
+
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+size_t theta_union_base<EN, EK, P, S, CS, A>::get_max_serialized_result_size_bytes() const {
+  return sizeof(uint64_t) * (3 + table_.num_entries_);
+}
+
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+size_t theta_union_base<EN, EK, P, S, CS, A>::serialize_result(void* bytes, size_t size, bool ordered) const {
+  ensure_minimum_memory(size, get_max_serialized_result_size_bytes());
+  if (reinterpret_cast<uintptr_t>(bytes) % alignof(uint64_t) != 0) {
+    throw std::invalid_argument("buffer must be aligned to 8 bytes");
+  }
+  uint8_t* ptr = static_cast<uint8_t*>(bytes);
+  // entries are selected and sorted past the longest possible preamble and moved down afterwards
+  uint64_t* entries = reinterpret_cast<uint64_t*>(ptr) + 3;
+  uint64_t theta = union_theta_;
+  uint32_t num_entries = 0;
+  if (!table_.is_empty_) {
+    uint64_t* last = copy_result_entries(entries, theta);
+    last = trim_result_entries(entries, last, theta);
+    // radix sort would allocate a scratch buffer
+    if (ordered) std::sort(entries, last, comparator());
+    num_entries = static_cast<uint32_t>(last - entries);
+  }
+  const size_t preamble_size = CS::write_preamble(ptr, table_.is_empty_, ordered || num_entries <= 1,
+      compute_seed_hash(table_.seed_), theta, num_entries);
+  if (num_entries > 0) std::memmove(ptr + preamble_size, entries, num_entries * sizeof(uint64_t));
+  return preamble_size + num_entries * sizeof(uint64_t);
+}
+
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+template<typename OutputIt>
+OutputIt theta_union_base<EN, EK, P, S, CS, A>::copy_result_entries(OutputIt out, uint64_t& theta) const {
+  theta = std::min(union_theta_, table_.theta_);
+  if (union_theta_ >= table_.theta_) {
+    return std::copy_if(table_.begin(), table_.end(), out, key_not_zero<EN, EK>());
+  }
+  return std::copy_if(table_.begin(), table_.end(), out, key_not_zero_less_than<uint64_t, EN, EK>(theta));
+}
+
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+template<typename RandomIt>
+RandomIt theta_union_base<EN, EK, P, S, CS, A>::trim_result_entries(RandomIt first, RandomIt last, uint64_t& theta) const {
+  const uint32_t nominal_num = 1 << table_.lg_nom_size_;
+  if (static_cast<size_t>(std::distance(first, last)) > nominal_num) {
+    std::nth_element(first, first + nominal_num, last, comparator());
+    theta = EK()(*(first + nominal_num));
+    last = first + nominal_num;
+  }
+  return last;
+}
+
 template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
 const P& theta_union_base<EN, EK, P, S, CS, A>::get_policy() const {
   return policy_;
@@ -91,6 +228,201 @@ void theta_union_base<EN, EK, P, S, CS, A>::reset() {
   union_theta_ = table_.theta_;
 }
 
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+template<typename SD>
+void theta_union_base<EN, EK, P, S, CS, A>::serialize(std::ostream& os, const SD& sd) const {
+  const uint8_t preamble_longs = STATE_PREAMBLE_LONGS;
+  write(os, preamble_longs);
+  const uint8_t serial_version = STATE_SERIAL_VERSION;
+  write(os, serial_version);
+  const uint8_t family = SD::FAMILY;
+  write(os, family);
+  write(os, table_.lg_nom_size_);
+  write(os, table_.lg_cur_size_);
+  const uint8_t flags_byte(table_.is_empty_ ? 1 << flags::IS_EMPTY : 0);
+  write(os, flags_byte);
+  const uint16_t seed_hash = compute_seed_hash(table_.seed_);
+  write(os, seed_hash);
+  write(os, table_.num_entries_);
+  const uint8_t rf = static_cast<uint8_t>(table_.rf_);
+  write(os, rf);
+  const uint8_t unused8 = 0;
+  write(os, unused8);
+  const uint16_t unused16 = 0;
+  write(os, unused16);
+  write(os, table_.p_);
+  const uint32_t unused32 = 0;
+  write(os, unused32);
+  write(os, table_.theta_);
+  write(os, union_theta_);
+  for (const auto& entry: table_) {
+    if (EK()(entry) != 0) sd.serialize(os, entry);
+  }
+}
+
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+template<typename SD>
+auto theta_union_base<EN, EK, P, S, CS, A>::serialize(unsigned header_size_bytes, const SD& sd) const -> vector_bytes {
+  size_t size = header_size_bytes + sizeof(uint64_t) * STATE_PREAMBLE_LONGS;
+  for (const auto& entry: table_) {
+    if (EK()(entry) != 0) size += sd.size_of(entry);
+  }
+  vector_bytes bytes(size, 0, table_.allocator_);
+  uint8_t* ptr = bytes.data() + header_size_bytes;
+  const uint8_t* end_ptr = bytes.data() + size;
+  const uint8_t preamble_longs = STATE_PREAMBLE_LONGS;
+  ptr += copy_to_mem(preamble_longs, ptr);
+  const uint8_t serial_version = STATE_SERIAL_VERSION;
+  ptr += copy_to_mem(serial_version, ptr);
+  const uint8_t family = SD::FAMILY;
+  ptr += copy_to_mem(family, ptr);
+  ptr += copy_to_mem(table_.lg_nom_size_, ptr);
+  ptr += copy_to_mem(table_.lg_cur_size_, ptr);
+  const uint8_t flags_byte(table_.is_empty_ ? 1 << flags::IS_EMPTY : 0);
+  ptr += copy_to_mem(flags_byte, ptr);
+  const uint16_t seed_hash = compute_seed_hash(table_.seed_);
+  ptr += copy_to_mem(seed_hash, ptr);
+  ptr += copy_to_mem(table_.num_entries_, ptr);
+  const uint8_t rf = static_cast<uint8_t>(table_.rf_);
+  ptr += copy_to_mem(rf, ptr);
+  ptr += sizeof(uint8_t) + sizeof(uint16_t); // unused
+  ptr += copy_to_mem(table_.p_, ptr);
+  ptr += sizeof(uint32_t); // unused
+  ptr += copy_to_mem(table_.theta_, ptr);
+  ptr += copy_to_mem(union_theta_, ptr);
+  for (const auto& entry: table_) {
+    if (EK()(entry) != 0) ptr += sd.serialize(ptr, end_ptr - ptr, entry);
+  }
+  return bytes;
+}
+
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+template<typename SD>
+auto theta_union_base<EN, EK, P, S, CS, A>::deserialize(std::istream& is, uint64_t seed, const SD& sd,
+    const P& policy, const A& allocator) -> theta_union_base {
+  const auto preamble_longs = read<uint8_t>(is);
+  const auto serial_version = read<uint8_t>(is);
+  const auto family = read<uint8_t>(is);
+  const auto lg_nom_size = read<uint8_t>(is);
+  const auto lg_cur_size = read<uint8_t>(is);
+  const auto flags_byte = read<uint8_t>(is);
+  const auto seed_hash = read<uint16_t>(is);
+  const auto num_entries = read<uint32_t>(is);
+  const auto rf = read<uint8_t>(is);
+  read<uint8_t>(is); // unused
+  read<uint16_t>(is); // unused
+  const auto p = read<float>(is);
+  read<uint32_t>(is); // unused
+  const auto theta = read<uint64_t>(is);
+  const auto union_theta = read<uint64_t>(is);
+  if (!is.good()) throw std::runtime_error("error reading from std::istream");
+  check_value(preamble_longs, STATE_PREAMBLE_LONGS, "preamble longs");
+  checker<true>::check_serial_version(serial_version, STATE_SERIAL_VERSION);
+  checker<true>::check_sketch_family(family, SD::FAMILY);
+  checker<true>::check_seed_hash(seed_hash, compute_seed_hash(seed));
+  check_state(lg_cur_size, lg_nom_size, rf, num_entries, p, theta, union_theta);
+
+  theta_union_base state(lg_cur_size, lg_nom_size, static_cast<resize_factor>(rf), p, theta, seed, policy, allocator);
+  state.table_.is_empty_ = flags_byte & (1 << flags::IS_EMPTY);
+  state.union_theta_ = union_theta;
+  for (uint32_t i = 0; i < num_entries; ++i) state.insert_state_entry(sd.deserialize(is));
+  if (!is.good()) throw std::runtime_error("error reading from std::istream");
+  return state;
+}
+
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+template<typename SD>
+auto theta_union_base<EN, EK, P, S, CS, A>::deserialize(const void* bytes, size_t size, uint64_t seed, const SD& sd,
+    const P& policy, const A& allocator) -> theta_union_base {
+  ensure_minimum_memory(size, sizeof(uint64_t) * STATE_PREAMBLE_LONGS);
+  const uint8_t* ptr = static_cast<const uint8_t*>(bytes);
+  const uint8_t* end_ptr = ptr + size;
+  uint8_t preamble_longs;
+  ptr += copy_from_mem(ptr, preamble_longs);
+  uint8_t serial_version;
+  ptr += copy_from_mem(ptr, serial_version);
+  uint8_t family;
+  ptr += copy_from_mem(ptr, family);
+  uint8_t lg_nom_size;
+  ptr += copy_from_mem(ptr, lg_nom_size);
+  uint8_t lg_cur_size;
+  ptr += copy_from_mem(ptr, lg_cur_size);
+  uint8_t flags_byte;
+  ptr += copy_from_mem(ptr, flags_byte);
+  uint16_t seed_hash;
+  ptr += copy_from_mem(ptr, seed_hash);
+  uint32_t num_entries;
+  ptr += copy_from_mem(ptr, num_entries);
+  uint8_t rf;
+  ptr += copy_from_mem(ptr, rf);
+  ptr += sizeof(uint8_t) + sizeof(uint16_t); // unused
+  float p;
+  ptr += copy_from_mem(ptr, p);
+  ptr += sizeof(uint32_t); // unused
+  uint64_t theta;
+  ptr += copy_from_mem(ptr, theta);
+  uint64_t union_theta;
+  ptr += copy_from_mem(ptr, union_theta);
+  check_value(preamble_longs, STATE_PREAMBLE_LONGS, "preamble longs");
+  checker<true>::check_serial_version(serial_version, STATE_SERIAL_VERSION);
+  checker<true>::check_sketch_family(family, SD::FAMILY);
+  checker<true>::check_seed_hash(seed_hash, compute_seed_hash(seed));
+  check_state(lg_cur_size, lg_nom_size, rf, num_entries, p, theta, union_theta);
+
+  theta_union_base state(lg_cur_size, lg_nom_size, static_cast<resize_factor>(rf), p, theta, seed, policy, allocator);
+  state.table_.is_empty_ = flags_byte & (1 << flags::IS_EMPTY);
+  state.union_theta_ = union_theta;
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    size_t entry_size;
+    state.insert_state_entry(sd.deserialize(ptr, end_ptr - ptr, entry_size));
+    ptr += entry_size;
+  }
+  return state;
+}
+
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+void theta_union_base<EN, EK, P, S, CS, A>::check_state(uint8_t lg_cur_size, uint8_t lg_nom_size, uint8_t rf,
+    uint32_t num_entries, float p, uint64_t theta, uint64_t union_theta) {
+  if (lg_nom_size < theta_constants::MIN_LG_K || lg_nom_size > theta_constants::MAX_LG_K) {
+    throw std::invalid_argument("lg_k out of range: " + std::to_string(lg_nom_size));
+  }
+  if (lg_cur_size < theta_constants::MIN_LG_K) {
+    throw std::invalid_argument("lg_cur_size must not be less than " + std::to_string(theta_constants::MIN_LG_K)
+        + ": " + std::to_string(lg_cur_size));
+  }
+  if (lg_cur_size > lg_nom_size + 1) {
+    throw std::invalid_argument("lg_cur_size must not be greater than lg_k + 1: " + std::to_string(lg_cur_size));
+  }
+  if (rf > static_cast<uint8_t>(resize_factor::X8)) {
+    throw std::invalid_argument("invalid resize factor: " + std::to_string(rf));
+  }
+  // a table that cannot resize starts at its full size
+  if (rf == static_cast<uint8_t>(resize_factor::X1) && lg_cur_size != lg_nom_size + 1) {
+    throw std::invalid_argument("lg_cur_size must be lg_k + 1 with resize factor X1: " + std::to_string(lg_cur_size));
+  }
+  if (!(p > 0 && p <= 1)) {
+    throw std::invalid_argument("sampling probability must be in (0, 1]: " + std::to_string(p));
+  }
+  if (theta == 0 || theta > theta_constants::MAX_THETA) {
+    throw std::invalid_argument("theta out of range: " + std::to_string(theta));
+  }
+  if (union_theta == 0 || union_theta > theta_constants::MAX_THETA) {
+    throw std::invalid_argument("union theta out of range: " + std::to_string(union_theta));
+  }
+  if (num_entries > hash_table::get_capacity(lg_cur_size, lg_nom_size)) {
+    throw std::invalid_argument("too many entries for the table size: " + std::to_string(num_entries));
+  }
+}
+
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+void theta_union_base<EN, EK, P, S, CS, A>::insert_state_entry(EN&& entry) {
+  const uint64_t hash = EK()(entry);
+  if (hash == 0 || hash >= table_.theta_) throw std::invalid_argument("invalid hash in the union state");
+  auto result = table_.find(hash);
+  if (result.second) throw std::invalid_argument("duplicate hash in the union state");
+  table_.insert(result.first, std::move(entry));
+}
+
 } /* namespace datasketches */
 
 #endif
@@ -27,22 +27,82 @@ theta_union_alloc<A>::theta_union_alloc(uint8_t lg_cur_size, uint8_t lg_nom_size
 state_(lg_cur_size, lg_nom_size, rf, p, theta, seed, nop_policy(), allocator)
 {}
 
+template<typename A>
+theta_union_alloc<A>::theta_union_alloc(State&& state):
+state_(std::move(state))
+{}
+
 template<typename A>
 template<typename FwdSketch>
 void theta_union_alloc<A>::update(FwdSketch&& sketch) {
   state_.update(std::forward<FwdSketch>(sketch));
 }
 
+template<typename A>
+template<typename ForwardIt>
+void theta_union_alloc<A>::update(ForwardIt first, ForwardIt last, unsigned num_threads) {
+  state_.update(first, last, num_threads);
+}
+
 template<typename A>
 auto theta_union_alloc<A>::get_result(bool ordered) const -> CompactSketch {
   return state_.get_result(ordered);
 }
 
+template<typename A>
+void theta_union_alloc<A>::get_result(CompactSketch& result, bool ordered) const {
+  state_.get_result(result, ordered);
+}
+
+template<typename A>
+size_t theta_union_alloc<A>::get_max_serialized_result_size_bytes() const {
+  return state_.get_max_serialized_result_size_bytes();
+}
+
+template<typename A>
+size_t theta_union_alloc<A>::serialize_result(void* bytes, size_t size, bool ordered) const {
+  return state_.serialize_result(bytes, size, ordered);
+}
+
 template<typename A>
 void theta_union_alloc<A>::reset() {
   state_.reset();
 }
 
+template<typename A>
+void theta_union_alloc<A>::serialize(std::ostream& os) const {
+  state_.serialize(os, state_serde());
+}
+
+template<typename A>
+auto theta_union_alloc<A>::serialize(unsigned header_size_bytes) const -> vector_bytes {
+  return state_.serialize(header_size_bytes, state_serde());
+}
+
+template<typename A>
+auto theta_union_alloc<A>::deserialize(std::istream& is, uint64_t seed, const A& allocator) -> theta_union_alloc {
+  return theta_union_alloc(State::deserialize(is, seed, state_serde(), nop_policy(), allocator));
+}
+
+template<typename A>
+auto theta_union_alloc<A>::deserialize(const void* bytes, size_t size, uint64_t seed, const A& allocator) -> theta_union_alloc {
+  return theta_union_alloc(State::deserialize(bytes, size, seed, state_serde(), nop_policy(), allocator));
+}
+
+template<typename A>
+size_t theta_union_alloc<A>::state_serde::serialize(void* ptr, size_t capacity, uint64_t entry) const {
+  check_memory_size(sizeof(entry), capacity);
+  return copy_to_mem(entry, ptr);
+}
+
+template<typename A>
+uint64_t theta_union_alloc<A>::state_serde::deserialize(const void* ptr, size_t capacity, size_t& size) const {
+  ensure_minimum_memory(capacity, sizeof(uint64_t));
+  uint64_t entry;
+  size = copy_from_mem(ptr, entry);
+  return entry;
+}
+
 template<typename A>
 theta_union_alloc<A>::builder::builder(const A& allocator): theta_base_builder<builder, A>(allocator) {}
 
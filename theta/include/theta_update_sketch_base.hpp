@@ -55,6 +55,8 @@ struct theta_update_sketch_base {
   inline std::pair<iterator, bool> find(uint64_t key) const;
   static inline std::pair<iterator, bool> find(Entry* entries, uint8_t lg_size, uint64_t key);
 
+  // hint to load the slot where probing for a given key starts
+  inline void prefetch(uint64_t key) const;
 
   template<typename FwdEntry>
   inline void insert(iterator it, FwdEntry&& entry);
@@ -67,6 +69,9 @@ struct theta_update_sketch_base {
   // hash table rebuild threshold = 15/16
   static constexpr double REBUILD_THRESHOLD = 15.0 / 16.0;
 
+  // number of hashes computed and prefetched ahead of insertion in batch updates
+  static constexpr uint8_t BATCH_SIZE = 16;
+
   static constexpr uint8_t STRIDE_HASH_BITS = 7;
   static constexpr uint32_t STRIDE_MASK = (1 << STRIDE_HASH_BITS) - 1;
 
@@ -231,23 +236,6 @@ private:
   uint32_t index_;
 };
 
-// double value canonicalization for compatibility with Java
-static inline int64_t canonical_double(double value) {
-  union {
-    int64_t long_value;
-    double double_value;
-  } long_double_union;
-
-  if (value == 0.0) {
-    long_double_union.double_value = 0.0; // canonicalize -0.0 to 0.0
-  } else if (std::isnan(value)) {
-    long_double_union.long_value = 0x7ff8000000000000L; // canonicalize NaN using value from Java's Double.doubleToLongBits()
-  } else {
-    long_double_union.double_value = value;
-  }
-  return long_double_union.long_value;
-}
-
 } /* namespace datasketches */
 
 #include "theta_update_sketch_base_impl.hpp"
@@ -167,6 +167,12 @@ auto theta_update_sketch_base<EN, EK, A>::find(EN* entries, uint8_t lg_size, uin
   throw std::logic_error("key not found and no empty slots!");
 }
 
+template<typename EN, typename EK, typename A>
+void theta_update_sketch_base<EN, EK, A>::prefetch(uint64_t key) const {
+  const uint32_t mask = (1 << lg_cur_size_) - 1;
+  prefetch_memory(&entries_[static_cast<uint32_t>(key) & mask]);
+}
+
 template<typename EN, typename EK, typename A>
 template<typename Fwd>
 void theta_update_sketch_base<EN, EK, A>::insert(iterator it, Fwd&& entry) {
@@ -0,0 +1,72 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef THETA_UPDATE_SKETCH_DENSE_KEYS_BASE_HPP_
+#define THETA_UPDATE_SKETCH_DENSE_KEYS_BASE_HPP_
+
+#include <vector>
+
+#include "theta_update_sketch_base.hpp"
+
+namespace datasketches {
+
+/**
+ * Hash table with the same interface and behavior as theta_update_sketch_base,
+ * which additionally keeps the keys of all slots in a dense parallel array.
+ * Probing reads the key array only, so the entries with their payloads are touched
+ * only when a key is found or inserted. This helps when entries are large,
+ * for instance with array or string summaries in Tuple sketches,
+ * at the cost of 8 extra bytes per slot.
+ * Entries are still stored in place, so the table can be iterated the same way.
+ */
+template<
+  typename Entry,
+  typename ExtractKey,
+  typename Allocator
+>
+struct theta_update_sketch_dense_keys_base: public theta_update_sketch_base<Entry, ExtractKey, Allocator> {
+  using Base = theta_update_sketch_base<Entry, ExtractKey, Allocator>;
+  using iterator = typename Base::iterator;
+  using resize_factor = typename Base::resize_factor;
+  using AllocU64 = typename std::allocator_traits<Allocator>::template rebind_alloc<uint64_t>;
+
+  theta_update_sketch_dense_keys_base(uint8_t lg_cur_size, uint8_t lg_nom_size, resize_factor rf, float p,
+      uint64_t theta, uint64_t seed, const Allocator& allocator, bool is_empty = true);
+
+  inline std::pair<iterator, bool> find(uint64_t key) const;
+
+  inline void prefetch(uint64_t key) const;
+
+  template<typename FwdEntry>
+  inline void insert(iterator it, FwdEntry&& entry);
+
+  void trim();
+  void reset();
+
+  std::vector<uint64_t, AllocU64> keys_;
+
+  // brings the key array in line with the entries after the table is rebuilt
+  void sync_keys();
+};
+
+} /* namespace datasketches */
+
+#include "theta_update_sketch_dense_keys_base_impl.hpp"
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef THETA_UPDATE_SKETCH_DENSE_KEYS_BASE_IMPL_HPP_
+#define THETA_UPDATE_SKETCH_DENSE_KEYS_BASE_IMPL_HPP_
+
+#include <stdexcept>
+
+namespace datasketches {
+
+template<typename EN, typename EK, typename A>
+theta_update_sketch_dense_keys_base<EN, EK, A>::theta_update_sketch_dense_keys_base(uint8_t lg_cur_size, uint8_t lg_nom_size,
+    resize_factor rf, float p, uint64_t theta, uint64_t seed, const A& allocator, bool is_empty):
+Base(lg_cur_size, lg_nom_size, rf, p, theta, seed, allocator, is_empty),
+keys_(this->entries_ == nullptr ? 0 : 1ULL << lg_cur_size, 0, AllocU64(allocator))
+{}
+
+template<typename EN, typename EK, typename A>
+auto theta_update_sketch_dense_keys_base<EN, EK, A>::find(uint64_t key) const -> std::pair<iterator, bool> {
+  const uint32_t size = 1 << this->lg_cur_size_;
+  const uint32_t mask = size - 1;
+  const uint32_t stride = Base::get_stride(key, this->lg_cur_size_);
+  uint32_t index = static_cast<uint32_t>(key) & mask;
+  // search for duplicate or zero
+  const uint32_t loop_index = index;
+  do {
+    const uint64_t probe = keys_[index];
+    if (probe == 0) {
+      return std::pair<iterator, bool>(&this->entries_[index], false);
+    } else if (probe == key) {
+      return std::pair<iterator, bool>(&this->entries_[index], true);
+    }
+    index = (index + stride) & mask;
+  } while (index != loop_index);
+  throw std::logic_error("key not found and no empty slots!");
+}
+
+template<typename EN, typename EK, typename A>
+void theta_update_sketch_dense_keys_base<EN, EK, A>::prefetch(uint64_t key) const {
+  const uint32_t mask = (1 << this->lg_cur_size_) - 1;
+  prefetch_memory(&keys_[static_cast<uint32_t>(key) & mask]);
+}
+
+template<typename EN, typename EK, typename A>
+template<typename Fwd>
+void theta_update_sketch_dense_keys_base<EN, EK, A>::insert(iterator it, Fwd&& entry) {
+  const size_t index = it - this->entries_;
+  const uint64_t key = EK()(entry);
+  const uint32_t num_entries = this->num_entries_;
+  const uint8_t lg_cur_size = this->lg_cur_size_;
+  Base::insert(it, std::forward<Fwd>(entry));
+  // the table might have been resized or rebuilt
+  if (this->num_entries_ == num_entries + 1 && this->lg_cur_size_ == lg_cur_size) {
+    keys_[index] = key;
+  } else {
+    sync_keys();
+  }
+}
+
+template<typename EN, typename EK, typename A>
+void theta_update_sketch_dense_keys_base<EN, EK, A>::trim() {
+  const uint32_t num_entries = this->num_entries_;
+  Base::trim();
+  if (this->num_entries_ != num_entries) sync_keys();
+}
+
+template<typename EN, typename EK, typename A>
+void theta_update_sketch_dense_keys_base<EN, EK, A>::reset() {
+  Base::reset();
+  sync_keys();
+}
+
+template<typename EN, typename EK, typename A>
+void theta_update_sketch_dense_keys_base<EN, EK, A>::sync_keys() {
+  const size_t size = this->entries_ == nullptr ? 0 : 1ULL << this->lg_cur_size_;
+  keys_.resize(size);
+  for (size_t i = 0; i < size; ++i) keys_[i] = EK()(this->entries_[i]);
+}
+
+} /* namespace datasketches */
+
+#endif
@@ -130,4 +130,36 @@ TEST_CASE("pack blocks unpack bits") {
   }
 }
 
+TEST_CASE("pack deltas unpack deltas multiple blocks") {
+  uint64_t value = 0x5555aaaa5555aaaaULL; // arbitrary starting value
+  const size_t num_blocks = 5;
+  for (int m = 0; m < 1000; ++m) {
+    for (uint8_t bits = 1; bits <= 63; ++bits) {
+      const uint64_t mask = (1ULL << bits) - 1;
+      std::vector<uint64_t> deltas(num_blocks * 8, 0);
+      for (size_t i = 0; i < deltas.size(); ++i) {
+        deltas[i] = value & mask;
+        value += IGOLDEN64;
+      }
+      const uint64_t start = value >> 1;
+      std::vector<uint64_t> expected(deltas.size(), 0);
+      uint64_t previous = start;
+      for (size_t i = 0; i < deltas.size(); ++i) {
+        expected[i] = previous + deltas[i];
+        previous = expected[i];
+      }
+      std::vector<uint8_t> bytes(num_blocks * bits, 0);
+      for (size_t i = 0; i < num_blocks; ++i) {
+        pack_bits_block8(&deltas[i * 8], &bytes[i * bits], bits);
+      }
+      std::vector<uint64_t> output(deltas.size(), 0);
+      const uint64_t last = unpack_deltas_blocks8(output.data(), bytes.data(), bits, num_blocks, start);
+      REQUIRE(last == expected.back());
+      for (size_t i = 0; i < output.size(); ++i) {
+        REQUIRE(expected[i] == output[i]);
+      }
+    }
+  }
+}
+
 } /* namespace datasketches */
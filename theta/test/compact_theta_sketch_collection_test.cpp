@@ -0,0 +1,121 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <sstream>
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+#include <compact_theta_sketch_collection.hpp>
+#include <theta_union.hpp>
+
+namespace datasketches {
+
+TEST_CASE("theta sketch collection: empty", "[theta_sketch_collection]") {
+  compact_theta_sketch_collection::writer writer;
+  auto bytes = writer.serialize();
+  REQUIRE(bytes.size() == writer.get_serialized_size_bytes());
+  auto collection = compact_theta_sketch_collection::wrap(bytes.data(), bytes.size());
+  REQUIRE(collection.get_num_sketches() == 0);
+  REQUIRE_FALSE(collection.contains(1));
+  REQUIRE_THROWS_AS(collection.get(1), std::out_of_range);
+  REQUIRE_THROWS_AS(collection.get_sketch(0), std::out_of_range);
+}
+
+TEST_CASE("theta sketch collection: lookup", "[theta_sketch_collection]") {
+  compact_theta_sketch_collection::writer writer;
+  std::vector<compact_theta_sketch> sketches;
+  // keys are added out of order, every other sketch is compressed
+  for (int i = 0; i < 20; ++i) {
+    auto update_sketch = update_theta_sketch::builder().build();
+    for (int j = 0; j < i * 1000; ++j) update_sketch.update(j);
+    sketches.push_back(update_sketch.compact());
+    writer.add(static_cast<uint64_t>((i * 7) % 20) * 3, sketches.back(), i % 2 == 0);
+  }
+  REQUIRE(writer.get_num_sketches() == 20);
+
+  std::stringstream s(std::ios::in | std::ios::out | std::ios::binary);
+  writer.serialize(s);
+  const std::string stream_bytes = s.str();
+  auto bytes = writer.serialize();
+  REQUIRE(bytes.size() == writer.get_serialized_size_bytes());
+  REQUIRE(stream_bytes == std::string(bytes.begin(), bytes.end()));
+
+  auto collection = compact_theta_sketch_collection::wrap(bytes.data(), bytes.size());
+  REQUIRE(collection.get_num_sketches() == 20);
+  for (uint32_t i = 0; i < collection.get_num_sketches(); ++i) {
+    REQUIRE(collection.get_key(i) == i * 3);
+    auto wrapped = collection.get_sketch(i);
+    REQUIRE(collection.get(i * 3).get_estimate() == wrapped.get_estimate());
+  }
+  for (int i = 0; i < 20; ++i) {
+    const uint64_t key = static_cast<uint64_t>((i * 7) % 20) * 3;
+    REQUIRE(collection.contains(key));
+    REQUIRE_FALSE(collection.contains(key + 1));
+    auto wrapped = collection.get(key);
+    REQUIRE(wrapped.is_empty() == sketches[i].is_empty());
+    REQUIRE(wrapped.get_num_retained() == sketches[i].get_num_retained());
+    REQUIRE(wrapped.get_theta64() == sketches[i].get_theta64());
+    REQUIRE(wrapped.get_estimate() == sketches[i].get_estimate());
+  }
+  REQUIRE_THROWS_AS(collection.get(1), std::out_of_range);
+
+  // wrapped sketches from the collection can be used in set operations directly
+  auto u = theta_union::builder().build();
+  for (uint32_t i = 0; i < collection.get_num_sketches(); ++i) u.update(collection.get_sketch(i));
+  auto u2 = theta_union::builder().build();
+  for (const auto& sketch: sketches) u2.update(sketch);
+  REQUIRE(u.get_result().get_estimate() == u2.get_result().get_estimate());
+}
+
+TEST_CASE("theta sketch collection: serialized images", "[theta_sketch_collection]") {
+  auto update_sketch = update_theta_sketch::builder().build();
+  for (int i = 0; i < 100; ++i) update_sketch.update(i);
+  auto bytes1 = update_sketch.compact().serialize();
+  compact_theta_sketch_collection::writer writer;
+  writer.add(5, bytes1.data(), bytes1.size());
+  REQUIRE_THROWS_AS(writer.add(6, bytes1.data(), 7), std::out_of_range);
+  auto bytes = writer.serialize();
+  auto collection = compact_theta_sketch_collection::wrap(bytes.data(), bytes.size());
+  REQUIRE(collection.get(5).get_estimate() == 100);
+}
+
+TEST_CASE("theta sketch collection: errors", "[theta_sketch_collection]") {
+  auto sketch = update_theta_sketch::builder().build().compact();
+  compact_theta_sketch_collection::writer writer;
+  writer.add(1, sketch);
+  writer.add(1, sketch);
+  REQUIRE_THROWS_AS(writer.serialize(), std::invalid_argument);
+
+  auto other_seed = update_theta_sketch::builder().set_seed(123).build().compact();
+  REQUIRE_THROWS_AS(writer.add(2, other_seed), std::invalid_argument);
+
+  compact_theta_sketch_collection::writer writer2;
+  writer2.add(1, sketch);
+  auto bytes = writer2.serialize();
+  REQUIRE_THROWS_AS(compact_theta_sketch_collection::wrap(bytes.data(), 7), std::out_of_range);
+  REQUIRE_THROWS_AS(compact_theta_sketch_collection::wrap(bytes.data(), 20), std::out_of_range);
+  REQUIRE_THROWS_AS(compact_theta_sketch_collection::wrap(bytes.data(), bytes.size(), 123), std::invalid_argument);
+  // truncated images are detected on access
+  auto truncated = compact_theta_sketch_collection::wrap(bytes.data(), bytes.size() - 1);
+  REQUIRE_THROWS_AS(truncated.get(1), std::out_of_range);
+  bytes[2] = 0;
+  REQUIRE_THROWS_AS(compact_theta_sketch_collection::wrap(bytes.data(), bytes.size()), std::invalid_argument);
+}
+
+} /* namespace datasketches */
@@ -0,0 +1,125 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <thread>
+#include <utility>
+#include <vector>
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+#include <concurrent_theta_sketch.hpp>
+
+namespace datasketches {
+
+TEST_CASE("concurrent theta sketch: empty", "[concurrent_theta_sketch]") {
+  auto sketch = concurrent_theta_sketch::builder().build();
+  {
+    auto buffer = sketch.get_local_buffer();
+  }
+  REQUIRE(sketch.is_empty());
+  REQUIRE(sketch.get_num_retained() == 0);
+  REQUIRE(sketch.get_estimate() == 0.0);
+  REQUIRE(sketch.get_theta() == 1.0);
+  auto compact = sketch.compact();
+  REQUIRE(compact.is_empty());
+  REQUIRE(compact.get_num_retained() == 0);
+}
+
+TEST_CASE("concurrent theta sketch: non empty no retained keys", "[concurrent_theta_sketch]") {
+  auto sketch = concurrent_theta_sketch::builder().set_p(0.001f).build();
+  {
+    auto buffer = sketch.get_local_buffer();
+    buffer.update(1);
+  }
+  REQUIRE_FALSE(sketch.is_empty());
+  REQUIRE(sketch.get_num_retained() == 0);
+  REQUIRE(sketch.get_theta() == Approx(0.001).margin(1e-10));
+  auto compact = sketch.compact();
+  REQUIRE_FALSE(compact.is_empty());
+  REQUIRE(compact.is_estimation_mode());
+}
+
+TEST_CASE("concurrent theta sketch: flush and local buffer size", "[concurrent_theta_sketch]") {
+  auto sketch = concurrent_theta_sketch::builder().set_local_lg_k(3).build();
+  auto buffer = sketch.get_local_buffer();
+  for (int i = 0; i < 7; ++i) buffer.update(i);
+  REQUIRE(sketch.is_empty()); // nothing propagated yet
+  buffer.update(7); // fills the local buffer
+  REQUIRE(sketch.get_num_retained() == 8);
+  buffer.update(8);
+  REQUIRE(sketch.get_num_retained() == 8);
+  buffer.flush();
+  REQUIRE(sketch.get_num_retained() == 9);
+  REQUIRE(sketch.get_estimate() == 9.0);
+  REQUIRE(sketch.compact().get_estimate() == 9.0);
+
+  REQUIRE_THROWS_AS(concurrent_theta_sketch::builder().set_local_lg_k(0), std::invalid_argument);
+}
+
+TEST_CASE("concurrent theta sketch: moved-from local buffer", "[concurrent_theta_sketch]") {
+  auto sketch = concurrent_theta_sketch::builder().build();
+  auto buffer1 = sketch.get_local_buffer();
+  buffer1.update(1);
+  auto buffer2 = std::move(buffer1);
+  REQUIRE_THROWS_AS(buffer1.update(2), std::logic_error);
+  buffer1.flush(); // no-op
+  buffer2.update(2);
+  buffer2.flush();
+  REQUIRE(sketch.get_estimate() == 2.0);
+}
+
+TEST_CASE("concurrent theta sketch: multiple writers exact mode", "[concurrent_theta_sketch]") {
+  auto sketch = concurrent_theta_sketch::builder().build();
+  const int num_threads = 4;
+  const int n = 500;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&sketch, t, n]() {
+      auto buffer = sketch.get_local_buffer();
+      // half overlap with the next thread
+      for (int i = 0; i < n; ++i) buffer.update(t * n / 2 + i);
+    });
+  }
+  for (auto& thread: threads) thread.join();
+  REQUIRE_FALSE(sketch.is_empty());
+  REQUIRE_FALSE(sketch.compact().is_estimation_mode());
+  REQUIRE(sketch.get_estimate() == (num_threads + 1) * n / 2);
+}
+
+TEST_CASE("concurrent theta sketch: multiple writers estimation mode", "[concurrent_theta_sketch]") {
+  auto sketch = concurrent_theta_sketch::builder().set_lg_k(12).build();
+  const int num_threads = 4;
+  const int n = 100000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&sketch, t, n]() {
+      auto buffer = sketch.get_local_buffer();
+      for (int i = 0; i < n; ++i) buffer.update(t * n + i);
+    });
+  }
+  for (auto& thread: threads) thread.join();
+  auto compact = sketch.compact();
+  REQUIRE(compact.is_estimation_mode());
+  REQUIRE(compact.is_ordered());
+  REQUIRE(compact.get_estimate() == Approx(num_threads * n).margin(num_threads * n * 0.05));
+  REQUIRE(sketch.get_estimate() == compact.get_estimate());
+  for (const auto hash: compact) REQUIRE(hash < compact.get_theta64());
+}
+
+} /* namespace datasketches */
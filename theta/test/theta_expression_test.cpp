@@ -0,0 +1,124 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+#include <theta_expression.hpp>
+#include <theta_union.hpp>
+#include <theta_intersection.hpp>
+#include <theta_a_not_b.hpp>
+
+namespace datasketches {
+
+static update_theta_sketch make_sketch(int from, int to, uint8_t lg_k = 12) {
+  auto sketch = update_theta_sketch::builder().set_lg_k(lg_k).build();
+  for (int i = from; i < to; ++i) sketch.update(i);
+  return sketch;
+}
+
+TEST_CASE("theta expression: empty", "[theta_expression]") {
+  theta_expression e;
+  auto empty = update_theta_sketch::builder().build();
+  auto a = e.add_sketch(empty);
+  auto b = e.add_sketch(make_sketch(0, 10));
+  auto result = e.evaluate(e.add_union({a, a}));
+  REQUIRE(result.is_empty());
+  REQUIRE(result.get_num_retained() == 0);
+
+  REQUIRE(e.evaluate(e.add_intersection({a, b})).is_empty());
+  REQUIRE(e.evaluate(e.add_a_not_b(a, b)).is_empty());
+  result = e.evaluate(e.add_a_not_b(b, a));
+  REQUIRE_FALSE(result.is_empty());
+  REQUIRE(result.get_estimate() == 10.0);
+}
+
+TEST_CASE("theta expression: exact mode", "[theta_expression]") {
+  auto a = make_sketch(0, 1000);
+  auto b = make_sketch(500, 1500);
+  auto c = make_sketch(200, 1200).compact(false);
+  auto d = make_sketch(1000, 1100).compact();
+
+  // (A u B) n C \ D
+  theta_expression e;
+  auto na = e.add_sketch(a);
+  auto nb = e.add_sketch(b);
+  auto nc = e.add_sketch(c);
+  auto nd = e.add_sketch(d);
+  auto root = e.add_a_not_b(e.add_intersection({e.add_union({na, nb}), nc}), nd);
+  REQUIRE(e.get_num_nodes() == 7);
+  auto result = e.evaluate(root);
+  REQUIRE_FALSE(result.is_empty());
+  REQUIRE_FALSE(result.is_estimation_mode());
+  REQUIRE(result.is_ordered());
+  REQUIRE(result.get_estimate() == 900.0);
+
+  auto u = theta_union::builder().build();
+  u.update(a);
+  u.update(b);
+  theta_intersection i;
+  i.update(u.get_result());
+  i.update(c);
+  auto expected = theta_a_not_b().compute(i.get_result(), d);
+  REQUIRE(result.serialize() == expected.serialize());
+
+  // subexpressions can be evaluated on their own
+  REQUIRE(e.evaluate(na).get_estimate() == 1000.0);
+  REQUIRE(e.evaluate(e.add_union({na, nb})).get_estimate() == 1500.0);
+}
+
+TEST_CASE("theta expression: estimation mode", "[theta_expression]") {
+  std::vector<compact_theta_sketch> sketches;
+  for (int i = 0; i < 100; ++i) sketches.push_back(make_sketch(i * 1000, i * 1000 + 20000, 10).compact());
+  auto excluded = make_sketch(0, 50000, 10).compact();
+
+  theta_expression e;
+  std::vector<theta_expression::node> nodes;
+  for (const auto& sketch: sketches) nodes.push_back(e.add_sketch(sketch));
+  auto all = e.add_union(nodes.begin(), nodes.end());
+  auto excluded_bytes = excluded.serialize();
+  auto root = e.add_a_not_b(all, e.add_sketch(wrapped_compact_theta_sketch::wrap(excluded_bytes.data(), excluded_bytes.size())));
+  auto result = e.evaluate(root);
+  REQUIRE(result.is_estimation_mode());
+  REQUIRE(result.get_estimate() == Approx(69000).margin(69000 * 0.1));
+
+  // the same hashes as a chain of set operations without trimming the union
+  auto u = theta_union::builder().set_lg_k(16).build();
+  for (const auto& sketch: sketches) u.update(sketch);
+  auto expected = theta_a_not_b().compute(u.get_result(), excluded);
+  REQUIRE(result.get_theta64() == expected.get_theta64());
+  REQUIRE(result.get_num_retained() == expected.get_num_retained());
+}
+
+TEST_CASE("theta expression: invalid input", "[theta_expression]") {
+  theta_expression e;
+  REQUIRE_THROWS_AS(e.evaluate(0), std::invalid_argument);
+  auto a = e.add_sketch(make_sketch(0, 10));
+  REQUIRE_THROWS_AS(e.add_union({a, 5}), std::invalid_argument);
+  REQUIRE_THROWS_AS(e.add_intersection({}), std::invalid_argument);
+  REQUIRE(e.get_num_nodes() == 1);
+  auto other_seed = update_theta_sketch::builder().set_seed(123).build();
+  other_seed.update(1);
+  REQUIRE_THROWS_AS(e.add_sketch(other_seed), std::invalid_argument);
+}
+
+} /* namespace datasketches */
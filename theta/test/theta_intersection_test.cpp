@@ -22,6 +22,7 @@
 #include <theta_intersection.hpp>
 
 #include <stdexcept>
+#include <algorithm>
 
 namespace datasketches {
 
@@ -230,6 +231,60 @@ TEST_CASE("theta intersection: estimation mode disjoint ordered", "[theta_inters
   REQUIRE(result.get_estimate() == 0.0);
 }
 
+TEST_CASE("theta intersection: estimation mode half overlap ordered vs unordered", "[theta_intersection]") {
+  update_theta_sketch sketch1 = update_theta_sketch::builder().build();
+  int value = 0;
+  for (int i = 0; i < 10000; i++) sketch1.update(value++);
+
+  update_theta_sketch sketch2 = update_theta_sketch::builder().build();
+  value = 5000;
+  for (int i = 0; i < 10000; i++) sketch2.update(value++);
+
+  update_theta_sketch sketch3 = update_theta_sketch::builder().build();
+  value = 2500;
+  for (int i = 0; i < 5000; i++) sketch3.update(value++);
+
+  theta_intersection intersection1;
+  intersection1.update(sketch1.compact(false));
+  intersection1.update(sketch2.compact(false));
+  intersection1.update(sketch3.compact(false));
+  compact_theta_sketch result1 = intersection1.get_result();
+
+  // sort-merge path
+  theta_intersection intersection2;
+  intersection2.update(sketch1.compact());
+  intersection2.update(sketch2.compact());
+  intersection2.update(sketch3.compact());
+  compact_theta_sketch result2 = intersection2.get_result(false);
+  REQUIRE(result2.is_ordered());
+  REQUIRE(result2.is_estimation_mode());
+  REQUIRE(result2.get_theta64() == result1.get_theta64());
+  REQUIRE(result2.get_num_retained() == result1.get_num_retained());
+  REQUIRE(std::equal(result1.begin(), result1.end(), result2.begin()));
+  REQUIRE(result2.get_estimate() == Approx(2500).margin(2500 * 0.05));
+
+  // wrapped compressed ordered sketches
+  auto bytes1 = sketch1.compact().serialize_compressed();
+  auto bytes2 = sketch2.compact().serialize_compressed();
+  auto bytes3 = sketch3.compact().serialize();
+  theta_intersection intersection3;
+  intersection3.update(wrapped_compact_theta_sketch::wrap(bytes1.data(), bytes1.size()));
+  intersection3.update(wrapped_compact_theta_sketch::wrap(bytes2.data(), bytes2.size()));
+  intersection3.update(wrapped_compact_theta_sketch::wrap(bytes3.data(), bytes3.size()));
+  compact_theta_sketch result3 = intersection3.get_result();
+  REQUIRE(result3.get_theta64() == result1.get_theta64());
+  REQUIRE(std::equal(result1.begin(), result1.end(), result3.begin()));
+
+  // switch from sort-merge to hash-based in the middle
+  theta_intersection intersection4;
+  intersection4.update(sketch1.compact());
+  intersection4.update(sketch2);
+  intersection4.update(sketch3.compact());
+  compact_theta_sketch result4 = intersection4.get_result();
+  REQUIRE(result4.get_theta64() == result1.get_theta64());
+  REQUIRE(std::equal(result1.begin(), result1.end(), result4.begin()));
+}
+
 TEST_CASE("theta intersection: seed mismatch", "[theta_intersection]") {
   update_theta_sketch sketch = update_theta_sketch::builder().build();
   sketch.update(1); // non-empty should not be ignored
@@ -18,10 +18,14 @@
  */
 
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 
 #include <catch2/catch.hpp>
 
 #include "theta_jaccard_similarity.hpp"
+#include "arena_allocator.hpp"
 
 namespace datasketches {
 
@@ -196,4 +200,149 @@ TEST_CASE("theta jaccard: dissimilarity test custom seed", "[theta_sketch]") {
   REQUIRE_FALSE(theta_jaccard_similarity::dissimilarity_test(actual, actual, threshold, seed));
 }
 
+TEST_CASE("theta jaccard: one to many", "[theta_sketch]") {
+  auto query = update_theta_sketch::builder().set_lg_k(10).build();
+  for (int i = 0; i < 10000; ++i) query.update(i);
+
+  std::vector<compact_theta_sketch> sketches;
+  sketches.push_back(update_theta_sketch::builder().build().compact()); // empty
+  sketches.push_back(query.compact()); // identical
+  sketches.push_back(query.compact(false)); // identical unordered
+  for (int i = 0; i < 20; ++i) {
+    auto sketch = update_theta_sketch::builder().set_lg_k(i % 2 == 0 ? 10 : 12).build();
+    const int n = i * 1000;
+    for (int j = 0; j < n; ++j) sketch.update(5000 + j);
+    sketches.push_back(sketch.compact(i % 3 == 0));
+  }
+  auto exact = update_theta_sketch::builder().build();
+  exact.update(1);
+  sketches.push_back(exact.compact());
+
+  for (unsigned num_threads: {1, 4}) {
+    auto result = theta_jaccard_similarity::jaccard_many(query, sketches.begin(), sketches.end(), DEFAULT_SEED, num_threads);
+    REQUIRE(result.size() == sketches.size());
+    for (size_t i = 0; i < sketches.size(); ++i) {
+      REQUIRE(result[i] == theta_jaccard_similarity::jaccard(query, sketches[i]));
+    }
+  }
+  REQUIRE(theta_jaccard_similarity::jaccard_many(query, sketches.begin(), sketches.begin()).empty());
+
+  auto empty = update_theta_sketch::builder().build();
+  auto result = theta_jaccard_similarity::jaccard_many(empty, sketches.begin(), sketches.begin() + 2);
+  REQUIRE(result[0] == std::array<double, 3>{1, 1, 1});
+  REQUIRE(result[1] == std::array<double, 3>{0, 0, 0});
+
+  REQUIRE_THROWS_AS(theta_jaccard_similarity::jaccard_many(query, sketches.begin(), sketches.end(), 123), std::invalid_argument);
+}
+
+TEST_CASE("theta jaccard: matrix", "[theta_sketch]") {
+  std::vector<compact_theta_sketch> sketches;
+  for (int i = 0; i < 10; ++i) {
+    auto sketch = update_theta_sketch::builder().set_lg_k(10).build();
+    for (int j = 0; j < 2000 * i; ++j) sketch.update(j);
+    sketches.push_back(sketch.compact());
+  }
+  for (unsigned num_threads: {1, 3}) {
+    auto matrix = theta_jaccard_similarity::jaccard_matrix(sketches.begin(), sketches.end(), DEFAULT_SEED, num_threads);
+    REQUIRE(matrix.size() == 100);
+    for (size_t i = 0; i < sketches.size(); ++i) {
+      for (size_t j = 0; j < sketches.size(); ++j) {
+        REQUIRE(matrix[i * 10 + j] == theta_jaccard_similarity::jaccard(sketches[i], sketches[j]));
+      }
+    }
+  }
+}
+
+namespace {
+
+// keeps the net allocated size, the default constructor throws to make sure only given instances are used
+long long tracking_allocator_total_bytes = 0;
+long long tracking_allocator_net_allocations = 0;
+
+template<typename T>
+class tracking_allocator {
+public:
+  using value_type = T;
+  tracking_allocator() { throw std::runtime_error("tracking_allocator: default constructor"); }
+  explicit tracking_allocator(int) {}
+  template<typename U> tracking_allocator(const tracking_allocator<U>&) {}
+  T* allocate(size_t n) {
+    T* p = std::allocator<T>().allocate(n);
+    tracking_allocator_total_bytes += n * sizeof(T);
+    ++tracking_allocator_net_allocations;
+    return p;
+  }
+  void deallocate(T* p, size_t n) {
+    tracking_allocator_total_bytes -= n * sizeof(T);
+    --tracking_allocator_net_allocations;
+    std::allocator<T>().deallocate(p, n);
+  }
+};
+
+template<typename T, typename U>
+bool operator==(const tracking_allocator<T>&, const tracking_allocator<U>&) { return true; }
+template<typename T, typename U>
+bool operator!=(const tracking_allocator<T>&, const tracking_allocator<U>&) { return false; }
+
+} // namespace
+
+TEST_CASE("theta jaccard: one to many and matrix with custom allocator", "[theta_sketch]") {
+  using alloc = tracking_allocator<uint64_t>;
+  using jaccard_alloc = theta_jaccard_similarity_alloc<alloc>;
+  tracking_allocator_total_bytes = 0;
+  tracking_allocator_net_allocations = 0;
+  {
+    std::vector<compact_theta_sketch> sketches;
+    std::vector<compact_theta_sketch_alloc<alloc>> sketches_alloc;
+    for (int i = 0; i < 5; ++i) {
+      auto sketch = update_theta_sketch::builder().set_lg_k(10).build();
+      auto sketch_alloc = update_theta_sketch_alloc<alloc>::builder(alloc(0)).set_lg_k(10).build();
+      for (int j = 0; j < 3000 * i; ++j) {
+        sketch.update(j);
+        sketch_alloc.update(j);
+      }
+      sketches.push_back(sketch.compact());
+      sketches_alloc.push_back(sketch_alloc.compact());
+    }
+
+    // only the given allocator instances are used, its default constructor throws
+    auto result = jaccard_alloc::jaccard_many(sketches_alloc[4], sketches_alloc.begin(), sketches_alloc.end(), DEFAULT_SEED, 2);
+    REQUIRE(tracking_allocator_total_bytes > 0);
+    auto expected = theta_jaccard_similarity::jaccard_many(sketches[4], sketches.begin(), sketches.end(), DEFAULT_SEED, 2);
+    REQUIRE(result.size() == expected.size());
+    for (size_t i = 0; i < result.size(); ++i) REQUIRE(result[i] == expected[i]);
+
+    auto matrix = jaccard_alloc::jaccard_matrix(sketches_alloc.begin(), sketches_alloc.end(), DEFAULT_SEED, 2, alloc(0));
+    auto expected_matrix = theta_jaccard_similarity::jaccard_matrix(sketches.begin(), sketches.end(), DEFAULT_SEED, 2);
+    REQUIRE(matrix.size() == expected_matrix.size());
+    for (size_t i = 0; i < matrix.size(); ++i) REQUIRE(matrix[i] == expected_matrix[i]);
+  }
+  REQUIRE(tracking_allocator_total_bytes == 0);
+  REQUIRE(tracking_allocator_net_allocations == 0);
+}
+
+TEST_CASE("theta jaccard: one to many and matrix with arena allocator", "[theta_sketch]") {
+  using alloc = arena_allocator<uint64_t>;
+  using jaccard_alloc = theta_jaccard_similarity_alloc<alloc>;
+  memory_arena arena;
+  std::vector<compact_theta_sketch_alloc<alloc>> sketches;
+  for (int i = 0; i < 4; ++i) {
+    auto sketch = update_theta_sketch_alloc<alloc>::builder(alloc(arena)).set_lg_k(10).build();
+    for (int j = 0; j < 2000 * i; ++j) sketch.update(j);
+    sketches.push_back(sketch.compact());
+  }
+
+  auto result = jaccard_alloc::jaccard_many(sketches[3], sketches.begin(), sketches.end());
+  auto matrix = jaccard_alloc::jaccard_matrix(sketches.begin(), sketches.end(), DEFAULT_SEED, 2, alloc(arena));
+  REQUIRE(matrix.size() == 16);
+  for (size_t i = 0; i < sketches.size(); ++i) {
+    REQUIRE(matrix[i * 4 + 3] == result[i]);
+    REQUIRE(matrix[3 * 4 + i] == result[i]);
+  }
+  REQUIRE(matrix[0] == std::array<double, 3>{1, 1, 1});
+  REQUIRE(matrix[1] == std::array<double, 3>{0, 0, 0}); // empty and non-empty
+
+  REQUIRE(jaccard_alloc::jaccard_matrix(sketches.begin(), sketches.begin(), DEFAULT_SEED, 1, alloc(arena)).empty());
+}
+
 } /* namespace datasketches */
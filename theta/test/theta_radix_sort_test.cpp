@@ -0,0 +1,93 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <theta_radix_sort.hpp>
+#include <theta_update_sketch_base.hpp>
+
+namespace datasketches {
+
+TEST_CASE("theta radix sort: keys", "[theta_radix_sort]") {
+  std::mt19937_64 rand(1);
+  for (size_t n: {0, 1, 10, 2047, 2048, 10000}) {
+    std::vector<uint64_t> keys(n);
+    for (auto& key: keys) key = rand() >> 1;
+    auto expected = keys;
+    std::sort(expected.begin(), expected.end());
+    sort_by_key<trivial_extract_key>(keys.begin(), keys.end(), std::allocator<uint64_t>());
+    REQUIRE(keys == expected);
+  }
+}
+
+TEST_CASE("theta radix sort: keys below small theta", "[theta_radix_sort]") {
+  // high digits are the same in all keys, so the corresponding passes are skipped
+  std::mt19937_64 rand(2);
+  std::vector<uint64_t> keys(5000);
+  for (auto& key: keys) key = rand() >> 40;
+  keys[0] = 0; // the same key twice
+  keys[1] = 0;
+  auto expected = keys;
+  std::sort(expected.begin(), expected.end());
+  sort_by_key<trivial_extract_key>(keys.begin(), keys.end(), std::allocator<uint64_t>());
+  REQUIRE(keys == expected);
+}
+
+// fails the test if the scratch buffer is allocated
+template<typename T>
+struct no_allocator {
+  using value_type = T;
+  no_allocator() = default;
+  template<typename U> no_allocator(const no_allocator<U>&) {}
+  T* allocate(size_t) { FAIL("unexpected allocation"); return nullptr; }
+  void deallocate(T*, size_t) {}
+};
+
+TEST_CASE("theta radix sort: all keys the same", "[theta_radix_sort]") {
+  // all passes are skipped, so no scratch buffer is needed
+  std::vector<uint64_t> keys(5000, 12345);
+  sort_by_key<trivial_extract_key>(keys.begin(), keys.end(), no_allocator<uint64_t>());
+  REQUIRE(keys == std::vector<uint64_t>(5000, 12345));
+}
+
+struct first_extract_key {
+  uint64_t operator()(const std::pair<uint64_t, std::string>& entry) const { return entry.first; }
+};
+
+TEST_CASE("theta radix sort: entries with payload", "[theta_radix_sort]") {
+  using Entry = std::pair<uint64_t, std::string>;
+  std::mt19937_64 rand(3);
+  std::vector<Entry> entries;
+  for (int i = 0; i < 5000; ++i) {
+    const uint64_t key = rand() >> 1;
+    entries.push_back(Entry(key, std::to_string(key)));
+  }
+  auto expected = entries;
+  std::sort(expected.begin(), expected.end(), compare_by_key<first_extract_key>());
+  sort_by_key<first_extract_key>(entries.begin(), entries.end(), std::allocator<Entry>());
+  REQUIRE(entries == expected);
+}
+
+} /* namespace datasketches */
@@ -19,6 +19,7 @@
 
 #include <sstream>
 #include <stdexcept>
+#include <algorithm>
 
 #include <catch2/catch.hpp>
 #include <theta_union.hpp>
@@ -443,4 +444,55 @@ TEST_CASE("degenerate estimation") {
       expectedUnionTheta, expectedUnionCount, expectedUnionEmpty);
 }
 
+TEST_CASE("setop: wrapped compressed sketches", "[theta_setop]") {
+  auto sketch1 = update_theta_sketch::builder().build();
+  for (int i = 0; i < 10000; ++i) sketch1.update(i);
+  auto sketch2 = update_theta_sketch::builder().set_lg_k(10).build();
+  for (int i = 5000; i < 20000; ++i) sketch2.update(i);
+  const auto compact1 = sketch1.compact();
+  const auto compact2 = sketch2.compact();
+  const auto bytes1 = compact1.serialize_compressed();
+  const auto bytes2 = compact2.serialize_compressed();
+  const auto wrapped1 = wrapped_compact_theta_sketch::wrap(bytes1.data(), bytes1.size());
+  const auto wrapped2 = wrapped_compact_theta_sketch::wrap(bytes2.data(), bytes2.size());
+
+  auto u1 = theta_union::builder().build();
+  u1.update(compact1);
+  u1.update(compact2);
+  auto u2 = theta_union::builder().build();
+  u2.update(wrapped1);
+  u2.update(wrapped2);
+  const auto union1 = u1.get_result();
+  const auto union2 = u2.get_result();
+  REQUIRE(union1.get_theta64() == union2.get_theta64());
+  REQUIRE(union1.get_num_retained() == union2.get_num_retained());
+  REQUIRE(std::equal(union1.begin(), union1.end(), union2.begin()));
+
+  theta_intersection i1;
+  i1.update(compact1);
+  i1.update(compact2);
+  theta_intersection i2;
+  i2.update(wrapped1);
+  i2.update(wrapped2);
+  const auto intersection1 = i1.get_result();
+  const auto intersection2 = i2.get_result();
+  REQUIRE(intersection1.get_theta64() == intersection2.get_theta64());
+  REQUIRE(intersection1.get_num_retained() == intersection2.get_num_retained());
+  REQUIRE(std::equal(intersection1.begin(), intersection1.end(), intersection2.begin()));
+
+  theta_a_not_b a_not_b;
+  for (bool swap: {false, true}) {
+    const auto a_not_b1 = swap ? a_not_b.compute(compact2, compact1) : a_not_b.compute(compact1, compact2);
+    const auto a_not_b2 = swap ? a_not_b.compute(wrapped2, wrapped1) : a_not_b.compute(wrapped1, wrapped2);
+    REQUIRE(a_not_b1.get_theta64() == a_not_b2.get_theta64());
+    REQUIRE(a_not_b1.get_num_retained() == a_not_b2.get_num_retained());
+    REQUIRE(std::equal(a_not_b1.begin(), a_not_b1.end(), a_not_b2.begin()));
+    // hash-based path
+    const auto a_not_b3 = swap ? a_not_b.compute(wrapped2, sketch1) : a_not_b.compute(wrapped1, sketch2);
+    REQUIRE(a_not_b1.get_theta64() == a_not_b3.get_theta64());
+    REQUIRE(std::equal(a_not_b1.begin(), a_not_b1.end(), a_not_b3.begin()));
+  }
+  REQUIRE(a_not_b.compute(wrapped1, wrapped2).get_estimate() == Approx(5000).margin(5000 * 0.1));
+}
+
 } /* namespace datasketches */
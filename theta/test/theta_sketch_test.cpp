@@ -625,4 +625,44 @@ TEST_CASE("max serialized size", "[theta_sketch]") {
   REQUIRE(max_size_bytes == compact_theta_sketch::get_max_serialized_size_bytes(lg_k));
 }
 
+TEST_CASE("theta sketch: batch update", "[theta_sketch]") {
+  const size_t n = 20000;
+  std::vector<uint64_t> u64(n);
+  std::vector<int64_t> i64(n);
+  std::vector<double> dbl(n);
+  std::vector<std::string> str(n);
+  for (size_t i = 0; i < n; ++i) {
+    u64[i] = i % 15000; // some duplicates
+    i64[i] = -static_cast<int64_t>(i);
+    dbl[i] = static_cast<double>(i) / 3;
+    str[i] = i % 100 == 0 ? "" : std::to_string(i);
+  }
+
+  auto sketch1 = update_theta_sketch::builder().set_lg_k(10).build();
+  auto sketch2 = update_theta_sketch::builder().set_lg_k(10).build();
+  for (size_t i = 0; i < n; ++i) sketch1.update(u64[i]);
+  for (size_t i = 0; i < n; ++i) sketch1.update(i64[i]);
+  for (size_t i = 0; i < n; ++i) sketch1.update(dbl[i]);
+  for (size_t i = 0; i < n; ++i) sketch1.update(str[i]);
+  sketch2.update_batch(u64.data(), n);
+  sketch2.update_batch(i64.data(), n);
+  sketch2.update_batch(dbl.data(), n);
+  sketch2.update_batch(str.data(), n);
+  REQUIRE(sketch2.is_estimation_mode());
+  REQUIRE(sketch1.get_theta64() == sketch2.get_theta64());
+  REQUIRE(sketch1.get_num_retained() == sketch2.get_num_retained());
+  auto compact1 = sketch1.compact();
+  auto compact2 = sketch2.compact();
+  REQUIRE(std::equal(compact1.begin(), compact1.end(), compact2.begin()));
+}
+
+TEST_CASE("theta sketch: batch update empty strings", "[theta_sketch]") {
+  std::vector<std::string> items(10);
+  auto sketch = update_theta_sketch::builder().build();
+  sketch.update_batch(items.data(), items.size());
+  REQUIRE(sketch.is_empty());
+  sketch.update_batch(static_cast<const uint64_t*>(nullptr), 0);
+  REQUIRE(sketch.is_empty());
+}
+
 } /* namespace datasketches */
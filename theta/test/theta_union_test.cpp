@@ -21,7 +21,13 @@
 
 #include <theta_union.hpp>
 
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <sstream>
 #include <stdexcept>
+#include <vector>
 
 namespace datasketches {
 
@@ -153,4 +159,325 @@ TEST_CASE("theta union: larger K", "[theta_union]") {
   REQUIRE(result2.get_estimate() == update_sketch3.get_estimate());
 }
 
+TEST_CASE("theta union: range exact mode", "[theta_union]") {
+  std::vector<compact_theta_sketch> sketches;
+  for (int i = 0; i < 50; ++i) {
+    auto update_sketch = update_theta_sketch::builder().build();
+    for (int j = 0; j < 100; ++j) update_sketch.update(i * 50 + j); // half overlap with the next one
+    sketches.push_back(update_sketch.compact());
+  }
+  sketches.push_back(update_theta_sketch::builder().build().compact()); // empty
+
+  for (unsigned num_threads: {1, 3, 8, 100}) {
+    auto u = theta_union::builder().build();
+    u.update(sketches.begin(), sketches.end(), num_threads);
+    auto result = u.get_result();
+    REQUIRE_FALSE(result.is_estimation_mode());
+    REQUIRE(result.get_estimate() == 51 * 50);
+  }
+}
+
+TEST_CASE("theta union: range estimation mode", "[theta_union]") {
+  std::vector<compact_theta_sketch> sketches;
+  for (int i = 0; i < 40; ++i) {
+    auto update_sketch = update_theta_sketch::builder().set_lg_k(10).build();
+    for (int j = 0; j < 10000; ++j) update_sketch.update(i * 5000 + j);
+    sketches.push_back(update_sketch.compact());
+  }
+
+  auto u1 = theta_union::builder().set_lg_k(10).build();
+  for (const auto& sketch: sketches) u1.update(sketch);
+  auto result1 = u1.get_result();
+
+  auto u2 = theta_union::builder().set_lg_k(10).build();
+  u2.update(sketches.begin(), sketches.end(), 4);
+  auto result2 = u2.get_result();
+  REQUIRE(result2.is_estimation_mode());
+  REQUIRE(result2.get_num_retained() == result1.get_num_retained());
+  REQUIRE(result2.get_estimate() == Approx(result1.get_estimate()).epsilon(0.02));
+  REQUIRE(result2.get_estimate() == Approx(205000).epsilon(0.1));
+
+  // the same state after reset
+  u2.reset();
+  REQUIRE(u2.get_result().is_empty());
+  std::vector<update_theta_sketch> empty_range;
+  u2.update(empty_range.begin(), empty_range.end(), 4);
+  REQUIRE(u2.get_result().is_empty());
+}
+
+TEST_CASE("theta union: range seed mismatch", "[theta_union]") {
+  std::vector<update_theta_sketch> sketches;
+  sketches.push_back(update_theta_sketch::builder().build());
+  sketches.push_back(update_theta_sketch::builder().set_seed(123).build());
+  sketches[1].update(1);
+  auto u = theta_union::builder().build();
+  REQUIRE_THROWS_AS(u.update(sketches.begin(), sketches.end(), 2), std::invalid_argument);
+}
+
+TEST_CASE("theta union: range seed mismatch leaves union unchanged", "[theta_union]") {
+  std::vector<update_theta_sketch> sketches;
+  sketches.push_back(update_theta_sketch::builder().build());
+  for (int i = 0; i < 100000; ++i) sketches[0].update(i);
+  sketches.push_back(update_theta_sketch::builder().set_seed(123).build());
+  sketches[1].update(1);
+  auto u = theta_union::builder().build();
+  for (unsigned num_threads: {1, 2}) {
+    REQUIRE_THROWS_AS(u.update(sketches.begin(), sketches.end(), num_threads), std::invalid_argument);
+    auto result = u.get_result();
+    REQUIRE(result.is_empty());
+    REQUIRE(result.get_theta() == 1.0);
+  }
+
+  // theta of the rejected range must not affect later updates
+  auto update_sketch = update_theta_sketch::builder().build();
+  for (int i = 0; i < 1000; ++i) update_sketch.update(i);
+  u.update(update_sketch);
+  auto result = u.get_result();
+  REQUIRE_FALSE(result.is_estimation_mode());
+  REQUIRE(result.get_estimate() == 1000);
+}
+
+TEST_CASE("theta union: get result into existing sketch", "[theta_union]") {
+  auto u = theta_union::builder().set_lg_k(10).build();
+  auto result = u.get_result();
+  u.get_result(result);
+  REQUIRE(result.is_empty());
+  REQUIRE(result.is_ordered());
+  REQUIRE(result.get_theta() == 1.0);
+
+  auto update_sketch = update_theta_sketch::builder().set_lg_k(10).build();
+  for (int i = 0; i < 100; ++i) update_sketch.update(i);
+  u.update(update_sketch);
+  u.get_result(result);
+  REQUIRE_FALSE(result.is_estimation_mode());
+  REQUIRE(result.get_num_retained() == 100);
+  REQUIRE(result.serialize() == u.get_result().serialize());
+
+  for (int i = 0; i < 10000; ++i) update_sketch.update(i);
+  u.update(update_sketch);
+  u.get_result(result, false);
+  auto expected = u.get_result(false);
+  REQUIRE_FALSE(result.is_ordered());
+  REQUIRE(result.is_estimation_mode());
+  REQUIRE(result.get_theta64() == expected.get_theta64());
+  REQUIRE(result.get_num_retained() == expected.get_num_retained());
+  REQUIRE(result.get_estimate() == expected.get_estimate());
+
+  // a smaller result reuses the storage of the larger one
+  u.reset();
+  u.update(update_theta_sketch::builder().build());
+  u.get_result(result);
+  REQUIRE(result.is_empty());
+  REQUIRE(result.get_num_retained() == 0);
+}
+
+TEST_CASE("theta union: serialize result", "[theta_union]") {
+  auto u = theta_union::builder().set_lg_k(10).build();
+  std::vector<uint64_t> buffer(u.get_max_serialized_result_size_bytes() / sizeof(uint64_t), UINT64_MAX);
+  size_t size = u.serialize_result(buffer.data(), buffer.size() * sizeof(uint64_t));
+  auto bytes = u.get_result().serialize();
+  REQUIRE(size == bytes.size());
+  REQUIRE(std::memcmp(buffer.data(), bytes.data(), size) == 0);
+
+  auto update_sketch = update_theta_sketch::builder().set_lg_k(10).build();
+  update_sketch.update(1);
+  u.update(update_sketch);
+  buffer.resize(u.get_max_serialized_result_size_bytes() / sizeof(uint64_t), UINT64_MAX);
+  size = u.serialize_result(buffer.data(), buffer.size() * sizeof(uint64_t));
+  bytes = u.get_result().serialize();
+  REQUIRE(size == bytes.size());
+  REQUIRE(std::memcmp(buffer.data(), bytes.data(), size) == 0);
+
+  for (int i = 0; i < 10000; ++i) update_sketch.update(i);
+  u.update(update_sketch);
+  buffer.resize(u.get_max_serialized_result_size_bytes() / sizeof(uint64_t), UINT64_MAX);
+  size = u.serialize_result(buffer.data(), buffer.size() * sizeof(uint64_t));
+  bytes = u.get_result().serialize();
+  REQUIRE(size == bytes.size());
+  REQUIRE(std::memcmp(buffer.data(), bytes.data(), size) == 0);
+  auto wrapped = wrapped_compact_theta_sketch::wrap(buffer.data(), size);
+  REQUIRE(wrapped.is_estimation_mode());
+  REQUIRE(wrapped.get_estimate() == u.get_result().get_estimate());
+
+  size = u.serialize_result(buffer.data(), buffer.size() * sizeof(uint64_t), false);
+  auto unordered = compact_theta_sketch::deserialize(buffer.data(), size);
+  REQUIRE_FALSE(unordered.is_ordered());
+  REQUIRE(unordered.get_num_retained() == u.get_result().get_num_retained());
+
+  REQUIRE_THROWS_AS(u.serialize_result(buffer.data(), u.get_max_serialized_result_size_bytes() - 1), std::out_of_range);
+  REQUIRE_THROWS_AS(u.serialize_result(reinterpret_cast<uint8_t*>(buffer.data()) + 1, buffer.size() * sizeof(uint64_t)), std::invalid_argument);
+}
+
+// counts allocations, including those freed within the same call
+static long long counting_allocator_num_allocations = 0;
+
+template<typename T>
+class counting_allocator {
+public:
+  using value_type = T;
+  counting_allocator() = default;
+  template<typename U> counting_allocator(const counting_allocator<U>&) {}
+  T* allocate(size_t n) {
+    ++counting_allocator_num_allocations;
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* p, size_t n) { std::allocator<T>().deallocate(p, n); }
+};
+
+template<typename T, typename U>
+bool operator==(const counting_allocator<T>&, const counting_allocator<U>&) { return true; }
+template<typename T, typename U>
+bool operator!=(const counting_allocator<T>&, const counting_allocator<U>&) { return false; }
+
+TEST_CASE("theta union: get and serialize result without allocations", "[theta_union]") {
+  using alloc = counting_allocator<uint64_t>;
+  auto u = theta_union_alloc<alloc>::builder().build();
+  auto update_sketch = update_theta_sketch_alloc<alloc>::builder().build();
+  for (int i = 0; i < 100000; ++i) update_sketch.update(i);
+  u.update(update_sketch);
+  auto result = u.get_result();
+  REQUIRE(result.is_ordered());
+  REQUIRE(result.get_num_retained() > 2048);
+  std::vector<uint64_t> buffer(u.get_max_serialized_result_size_bytes() / sizeof(uint64_t));
+
+  u.get_result(result);
+  const long long num_allocations = counting_allocator_num_allocations;
+  u.get_result(result);
+  const size_t size = u.serialize_result(buffer.data(), buffer.size() * sizeof(uint64_t));
+  REQUIRE(counting_allocator_num_allocations == num_allocations);
+
+  REQUIRE(result.is_ordered());
+  const auto bytes = u.get_result().serialize();
+  REQUIRE(result.serialize() == bytes);
+  REQUIRE(size == bytes.size());
+  REQUIRE(std::memcmp(buffer.data(), bytes.data(), size) == 0);
+}
+
+TEST_CASE("theta union: unordered result with at most one entry", "[theta_union]") {
+  auto check = [](const theta_union& u, uint32_t num_retained) {
+    const auto expected = u.get_result(false);
+    REQUIRE(expected.get_num_retained() == num_retained);
+    REQUIRE(expected.is_ordered());
+    const auto bytes = expected.serialize();
+
+    auto result = u.get_result();
+    u.get_result(result, false);
+    REQUIRE(result.is_ordered());
+    REQUIRE(result.serialize() == bytes);
+
+    std::vector<uint64_t> buffer(u.get_max_serialized_result_size_bytes() / sizeof(uint64_t), UINT64_MAX);
+    const size_t size = u.serialize_result(buffer.data(), buffer.size() * sizeof(uint64_t), false);
+    REQUIRE(size == bytes.size());
+    REQUIRE(std::memcmp(buffer.data(), bytes.data(), size) == 0);
+  };
+
+  // empty
+  auto u = theta_union::builder().build();
+  check(u, 0);
+
+  // not empty, but no retained entries
+  auto update_sketch = update_theta_sketch::builder().set_p(0.001f).build();
+  update_sketch.update(1);
+  REQUIRE(update_sketch.get_num_retained() == 0);
+  u.update(update_sketch);
+  REQUIRE_FALSE(u.get_result().is_empty());
+  check(u, 0);
+
+  // one retained entry
+  u.reset();
+  auto update_sketch1 = update_theta_sketch::builder().build();
+  update_sketch1.update(1);
+  u.update(update_sketch1);
+  check(u, 1);
+}
+
+TEST_CASE("theta union: serialize and deserialize state", "[theta_union]") {
+  auto u1 = theta_union::builder().set_lg_k(10).build();
+  {
+    // empty
+    auto bytes = u1.serialize();
+    auto u2 = theta_union::deserialize(bytes.data(), bytes.size());
+    REQUIRE(u2.get_result().is_empty());
+  }
+
+  auto update_sketch1 = update_theta_sketch::builder().set_lg_k(10).build();
+  for (int i = 0; i < 10000; ++i) update_sketch1.update(i);
+  u1.update(update_sketch1);
+  auto bytes = u1.serialize();
+  std::stringstream s(std::ios::in | std::ios::out | std::ios::binary);
+  u1.serialize(s);
+  REQUIRE(static_cast<size_t>(s.tellp()) == bytes.size());
+
+  auto u2 = theta_union::deserialize(bytes.data(), bytes.size());
+  auto u3 = theta_union::deserialize(s);
+  REQUIRE(u2.get_result().serialize() == u1.get_result().serialize());
+  REQUIRE(u3.get_result().serialize() == u1.get_result().serialize());
+
+  // continue accumulating
+  auto update_sketch2 = update_theta_sketch::builder().set_lg_k(10).build();
+  for (int i = 5000; i < 15000; ++i) update_sketch2.update(i);
+  u1.update(update_sketch2);
+  u2.update(update_sketch2);
+  REQUIRE(u2.get_result().serialize() == u1.get_result().serialize());
+  REQUIRE(u2.get_result().get_estimate() == Approx(15000).margin(15000 * 0.05));
+
+  REQUIRE_THROWS_AS(theta_union::deserialize(bytes.data(), bytes.size(), 123), std::invalid_argument);
+  REQUIRE_THROWS_AS(theta_union::deserialize(bytes.data(), bytes.size() - 1), std::out_of_range);
+  REQUIRE_THROWS_AS(theta_union::deserialize(bytes.data(), 20), std::out_of_range);
+  REQUIRE_THROWS_AS(compact_theta_sketch::deserialize(bytes.data(), bytes.size()), std::invalid_argument);
+  auto compact_bytes = update_sketch1.compact().serialize();
+  REQUIRE_THROWS_AS(theta_union::deserialize(compact_bytes.data(), compact_bytes.size()), std::invalid_argument);
+  bytes[2] = 3; // compact sketch family
+  REQUIRE_THROWS_AS(theta_union::deserialize(bytes.data(), bytes.size()), std::invalid_argument);
+}
+
+TEST_CASE("theta union: deserialize invalid state", "[theta_union]") {
+  auto u = theta_union::builder().set_lg_k(10).build();
+  auto update_sketch = update_theta_sketch::builder().set_lg_k(10).build();
+  for (int i = 0; i < 100; ++i) update_sketch.update(i);
+  u.update(update_sketch);
+  const auto bytes = u.serialize();
+  auto u1 = theta_union::deserialize(bytes.data(), bytes.size());
+  REQUIRE(u1.get_result().get_estimate() == 100);
+
+  auto check_throws = [](const std::vector<uint8_t>& corrupted) {
+    REQUIRE_THROWS_AS(theta_union::deserialize(corrupted.data(), corrupted.size()), std::invalid_argument);
+    std::stringstream s(std::ios::in | std::ios::out | std::ios::binary);
+    s.write(reinterpret_cast<const char*>(corrupted.data()), corrupted.size());
+    REQUIRE_THROWS_AS(theta_union::deserialize(s), std::invalid_argument);
+  };
+
+  { // lg_cur_size below the minimum
+    auto corrupted = bytes;
+    corrupted[4] = 0;
+    check_throws(corrupted);
+    corrupted[4] = theta_constants::MIN_LG_K - 1;
+    check_throws(corrupted);
+  }
+  { // resize factor X1 with a table smaller than lg_k + 1
+    auto corrupted = bytes;
+    corrupted[12] = resize_factor::X1;
+    corrupted[4] = 10;
+    check_throws(corrupted);
+  }
+  { // sampling probability out of (0, 1]
+    auto corrupted = bytes;
+    const float p_values[] = {0.0f, -0.5f, 1.5f, std::numeric_limits<float>::quiet_NaN()};
+    for (float p: p_values) {
+      std::memcpy(corrupted.data() + 16, &p, sizeof(p));
+      check_throws(corrupted);
+    }
+  }
+  { // theta and union theta must be non-zero and not greater than MAX_THETA
+    const uint64_t theta_values[] = {0, theta_constants::MAX_THETA + 1};
+    for (size_t offset: {24, 32}) {
+      for (uint64_t theta: theta_values) {
+        auto corrupted = bytes;
+        std::memcpy(corrupted.data() + offset, &theta, sizeof(theta));
+        check_throws(corrupted);
+      }
+    }
+  }
+}
+
 } /* namespace datasketches */
@@ -30,15 +30,30 @@ namespace datasketches {
 /// convenience alias with default allocator, default policy for update_array_of_doubles_sketch
 using default_array_of_doubles_update_policy = default_array_tuple_update_policy<array<double>>;
 
+/// convenience alias with default allocator, update policy for update_array_of_doubles_sketch keeping minimum values
+using min_array_of_doubles_update_policy = min_array_tuple_update_policy<array<double>>;
+
+/// convenience alias with default allocator, update policy for update_array_of_doubles_sketch keeping maximum values
+using max_array_of_doubles_update_policy = max_array_tuple_update_policy<array<double>>;
+
 /// convenience alias with default allocator, equivalent to ArrayOfDoublesUpdatableSketch in Java
 using update_array_of_doubles_sketch = update_array_tuple_sketch<array<double>>;
 
 /// convenience alias with default allocator, equivalent to ArrayOfDoublesCompactSketch in Java
 using compact_array_of_doubles_sketch = compact_array_tuple_sketch<array<double>>;
 
+/// convenience alias with default allocator, read-only view of a serialized compact_array_of_doubles_sketch
+using wrapped_compact_array_of_doubles_sketch = wrapped_compact_array_tuple_sketch<array<double>>;
+
 /// convenience alias, default policy for array_of_doubles_union
 using default_array_of_doubles_union_policy = default_array_tuple_union_policy<array<double>>;
 
+/// convenience alias, union (or intersection) policy keeping minimum values
+using min_array_of_doubles_union_policy = min_array_tuple_union_policy<array<double>>;
+
+/// convenience alias, union (or intersection) policy keeping maximum values
+using max_array_of_doubles_union_policy = max_array_tuple_union_policy<array<double>>;
+
 /// convenience alias with default allocator, equivalent to ArrayOfDoublesUnion in Java
 using array_of_doubles_union = array_tuple_union<array<double>>;
 
@@ -0,0 +1,159 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#ifndef ARRAY_TUPLE_OPS_HPP_
+#define ARRAY_TUPLE_OPS_HPP_
+
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DATASKETCHES_ARRAY_TUPLE_OPS_SSE2
+#endif
+
+namespace datasketches {
+
+// Element-wise kernels over the values of array tuple summaries.
+// The generic versions work with any arithmetic type, double and float have SSE2 versions.
+// min and max keep the value of dst if either value is NaN, the same as std::min and std::max.
+namespace array_tuple_ops {
+
+template<typename T>
+inline void add(T* dst, const T* src, uint8_t size) {
+  for (uint8_t i = 0; i < size; ++i) dst[i] += src[i];
+}
+
+template<typename T>
+inline void min(T* dst, const T* src, uint8_t size) {
+  for (uint8_t i = 0; i < size; ++i) dst[i] = std::min(dst[i], src[i]);
+}
+
+template<typename T>
+inline void max(T* dst, const T* src, uint8_t size) {
+  for (uint8_t i = 0; i < size; ++i) dst[i] = std::max(dst[i], src[i]);
+}
+
+#ifdef DATASKETCHES_ARRAY_TUPLE_OPS_SSE2
+
+// The update value may be a short array (even a single double) as far as the compiler can tell
+// after inlining, since the size is only known at run time. A 16-byte load of it triggers -Warray-bounds,
+// so it is loaded in two 8-byte halves, which touch the same memory as the scalar loop.
+inline __m128d load_input(const double* src) {
+  return _mm_loadh_pd(_mm_load_sd(src), src + 1);
+}
+
+// _mm_min_pd(a, b) returns b unless a < b, so the arguments are swapped
+// to get the semantics of std::min(dst, src)
+
+inline void add(double* dst, const double* src, uint8_t size) {
+  uint8_t i = 0;
+  for (; i + 2 <= size; i += 2) {
+    _mm_storeu_pd(dst + i, _mm_add_pd(_mm_loadu_pd(dst + i), load_input(src + i)));
+  }
+  if (i < size) dst[i] += src[i];
+}
+
+inline void min(double* dst, const double* src, uint8_t size) {
+  uint8_t i = 0;
+  for (; i + 2 <= size; i += 2) {
+    _mm_storeu_pd(dst + i, _mm_min_pd(load_input(src + i), _mm_loadu_pd(dst + i)));
+  }
+  if (i < size) dst[i] = std::min(dst[i], src[i]);
+}
+
+inline void max(double* dst, const double* src, uint8_t size) {
+  uint8_t i = 0;
+  for (; i + 2 <= size; i += 2) {
+    _mm_storeu_pd(dst + i, _mm_max_pd(load_input(src + i), _mm_loadu_pd(dst + i)));
+  }
+  if (i < size) dst[i] = std::max(dst[i], src[i]);
+}
+
+inline void add(float* dst, const float* src, uint8_t size) {
+  uint8_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+  }
+  for (; i < size; ++i) dst[i] += src[i];
+}
+
+inline void min(float* dst, const float* src, uint8_t size) {
+  uint8_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    _mm_storeu_ps(dst + i, _mm_min_ps(_mm_loadu_ps(src + i), _mm_loadu_ps(dst + i)));
+  }
+  for (; i < size; ++i) dst[i] = std::min(dst[i], src[i]);
+}
+
+inline void max(float* dst, const float* src, uint8_t size) {
+  uint8_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    _mm_storeu_ps(dst + i, _mm_max_ps(_mm_loadu_ps(src + i), _mm_loadu_ps(dst + i)));
+  }
+  for (; i < size; ++i) dst[i] = std::max(dst[i], src[i]);
+}
+
+#endif
+
+// Dispatch for update values of any type with indexed access.
+// Contiguous inputs (anything with data(), raw pointers and built-in arrays of the same type)
+// go to the kernels above, other inputs are processed element by element.
+
+struct add_op {
+  template<typename T> void operator()(T* dst, const T* src, uint8_t size) const { add(dst, src, size); }
+  template<typename T, typename U> void operator()(T& dst, const U& src) const { dst += src; }
+};
+
+struct min_op {
+  template<typename T> void operator()(T* dst, const T* src, uint8_t size) const { min(dst, src, size); }
+  template<typename T, typename U> void operator()(T& dst, const U& src) const { if (src < dst) dst = src; }
+};
+
+struct max_op {
+  template<typename T> void operator()(T* dst, const T* src, uint8_t size) const { max(dst, src, size); }
+  template<typename T, typename U> void operator()(T& dst, const U& src) const { if (dst < src) dst = src; }
+};
+
+template<typename Op, typename T, typename InputArray>
+inline auto apply(T* dst, const InputArray& src, uint8_t size, int)
+-> decltype(static_cast<const T*>(src.data()), void()) {
+  Op()(dst, static_cast<const T*>(src.data()), size);
+}
+
+template<typename Op, typename T, typename U>
+inline auto apply(T* dst, U* src, uint8_t size, int)
+-> typename std::enable_if<std::is_same<typename std::remove_const<U>::type, T>::value>::type {
+  Op()(dst, static_cast<const T*>(src), size);
+}
+
+template<typename Op, typename T, typename InputArray>
+inline void apply(T* dst, const InputArray& src, uint8_t size, long) {
+  for (uint8_t i = 0; i < size; ++i) Op()(dst[i], src[i]);
+}
+
+} /* namespace array_tuple_ops */
+
+} /* namespace datasketches */
+
+#undef DATASKETCHES_ARRAY_TUPLE_OPS_SSE2
+
+#endif
@@ -22,66 +22,82 @@
 
 #include <vector>
 #include <memory>
+#include <limits>
+#include <iterator>
+#include <type_traits>
 
 #include "serde.hpp"
 #include "tuple_sketch.hpp"
+#include "array_tuple_ops.hpp"
 
 namespace datasketches {
 
-// This simple array is faster than std::vector and should be sufficient for this application
+// This simple array is faster than std::vector and should be sufficient for this application.
+// Small arrays (up to 16 bytes of trivial values, such as 2 doubles) are stored inline
+// without allocating memory, which saves an allocation per entry in sketches with few values.
 template<typename T, typename Allocator = std::allocator<T>>
 class array {
 public:
   using value_type = T;
   using allocator_type = Allocator;
 
+  static const uint8_t INLINE_BYTES = 16;
+  static const uint8_t INLINE_CAPACITY = std::is_trivial<T>::value ? INLINE_BYTES / sizeof(T) : 0;
+
   explicit array(uint8_t size, T value, const Allocator& allocator = Allocator()):
-  allocator_(allocator), size_(size), array_(allocator_.allocate(size_)) {
-    std::fill(array_, array_ + size_, value);
+  allocator_(allocator), size_(size) {
+    allocate();
+    std::fill(data(), data() + size_, value);
   }
   array(const array& other):
     allocator_(other.allocator_),
-    size_(other.size_),
-    array_(allocator_.allocate(size_))
+    size_(other.size_)
   {
-    std::copy(other.array_, other.array_ + size_, array_);
+    allocate();
+    std::copy(other.data(), other.data() + size_, data());
   }
   array(array&& other) noexcept:
     allocator_(std::move(other.allocator_)),
     size_(other.size_),
-    array_(other.array_)
+    storage_(other.storage_)
   {
-    other.array_ = nullptr;
+    other.size_ = 0;
   }
   ~array() {
-    if (array_ != nullptr) allocator_.deallocate(array_, size_);
+    if (!is_inline()) allocator_.deallocate(storage_.ptr, size_);
   }
   array& operator=(const array& other) {
     array copy(other);
     std::swap(allocator_, copy.allocator_);
     std::swap(size_, copy.size_);
-    std::swap(array_, copy.array_);
+    std::swap(storage_, copy.storage_);
     return *this;
   }
   array& operator=(array&& other) {
     std::swap(allocator_, other.allocator_);
     std::swap(size_, other.size_);
-    std::swap(array_, other.array_);
+    std::swap(storage_, other.storage_);
     return *this;
   }
-  T& operator[](size_t index) { return array_[index]; }
-  T operator[](size_t index) const { return array_[index]; }
+  T& operator[](size_t index) { return data()[index]; }
+  T operator[](size_t index) const { return data()[index]; }
   uint8_t size() const { return size_; }
-  T* data() { return array_; }
-  const T* data() const { return array_; }
+  T* data() { return is_inline() ? reinterpret_cast<T*>(&storage_.buffer) : storage_.ptr; }
+  const T* data() const { return is_inline() ? reinterpret_cast<const T*>(&storage_.buffer) : storage_.ptr; }
   bool operator==(const array& other) const {
-    for (uint8_t i = 0; i < size_; ++i) if (array_[i] != other.array_[i]) return false;
+    for (uint8_t i = 0; i < size_; ++i) if ((*this)[i] != other[i]) return false;
     return true;
   }
 private:
   Allocator allocator_;
   uint8_t size_;
-  T* array_;
+  union {
+    T* ptr;
+    typename std::aligned_storage<INLINE_BYTES, alignof(T)>::type buffer;
+  } storage_;
+
+  bool is_inline() const { return size_ <= INLINE_CAPACITY; }
+  void allocate() { if (!is_inline()) storage_.ptr = allocator_.allocate(size_); }
 };
 
 /// default array tuple update policy
@@ -95,7 +111,55 @@ public:
   }
   template<typename InputArray> // to allow any type with indexed access (such as double* or std::vector)
   void update(Array& array, const InputArray& update) const {
-    for (uint8_t i = 0; i < num_values_; ++i) array[i] += update[i];
+    array_tuple_ops::apply<array_tuple_ops::add_op>(array.data(), update, num_values_, 0);
+  }
+  uint8_t get_num_values() const {
+    return num_values_;
+  }
+
+private:
+  Allocator allocator_;
+  uint8_t num_values_;
+};
+
+/// array tuple update policy that keeps the minimum of each value
+template<typename Array, typename Allocator = typename Array::allocator_type>
+class min_array_tuple_update_policy {
+public:
+  using value_type = typename Array::value_type;
+  min_array_tuple_update_policy(uint8_t num_values = 1, const Allocator& allocator = Allocator()):
+    allocator_(allocator), num_values_(num_values) {}
+  Array create() const {
+    return Array(num_values_, std::numeric_limits<value_type>::has_infinity ?
+        std::numeric_limits<value_type>::infinity() : std::numeric_limits<value_type>::max(), allocator_);
+  }
+  template<typename InputArray> // to allow any type with indexed access (such as double* or std::vector)
+  void update(Array& array, const InputArray& update) const {
+    array_tuple_ops::apply<array_tuple_ops::min_op>(array.data(), update, num_values_, 0);
+  }
+  uint8_t get_num_values() const {
+    return num_values_;
+  }
+
+private:
+  Allocator allocator_;
+  uint8_t num_values_;
+};
+
+/// array tuple update policy that keeps the maximum of each value
+template<typename Array, typename Allocator = typename Array::allocator_type>
+class max_array_tuple_update_policy {
+public:
+  using value_type = typename Array::value_type;
+  max_array_tuple_update_policy(uint8_t num_values = 1, const Allocator& allocator = Allocator()):
+    allocator_(allocator), num_values_(num_values) {}
+  Array create() const {
+    return Array(num_values_, std::numeric_limits<value_type>::has_infinity ?
+        -std::numeric_limits<value_type>::infinity() : std::numeric_limits<value_type>::lowest(), allocator_);
+  }
+  template<typename InputArray> // to allow any type with indexed access (such as double* or std::vector)
+  void update(Array& array, const InputArray& update) const {
+    array_tuple_ops::apply<array_tuple_ops::max_op>(array.data(), update, num_values_, 0);
   }
   uint8_t get_num_values() const {
     return num_values_;
@@ -115,20 +179,66 @@ template<typename Array, typename Allocator> class compact_array_tuple_sketch;
  * For this the sketch must be configured with array<double> or std::vector<double>.
  * This is a more generic implementation for any arithmetic type (serialization assumes contiguous array size_of(T) * num_values).
  * A set of type definitions for the ArrayOfDoubles* equivalent is provided in a separate file array_of_doubles_sketch.hpp.
+ * The hash table layout can be selected with the Map template parameter (see update_tuple_sketch).
  * There is no constructor. Use builder instead.
  */
 template<
   typename Array,
   typename Policy = default_array_tuple_update_policy<Array>,
-  typename Allocator = typename Array::allocator_type
+  typename Allocator = typename Array::allocator_type,
+  template<typename, typename, typename> class Map = theta_update_sketch_base
 >
-class update_array_tuple_sketch: public update_tuple_sketch<Array, Array, Policy, Allocator> {
+class update_array_tuple_sketch: public update_tuple_sketch<Array, Array, Policy, Allocator, Map> {
 public:
-  using Base = update_tuple_sketch<Array, Array, Policy, Allocator>;
+  using Base = update_tuple_sketch<Array, Array, Policy, Allocator, Map>;
   using resize_factor = typename Base::resize_factor;
+  using value_type = typename Array::value_type;
 
   class builder;
 
+  // batch updates with arrays of update values
+  using Base::update_batch;
+
+  /**
+   * Update this sketch with a batch of unsigned 64-bit integer keys and a matrix of values.
+   * The result is the same as calling update(keys[i], values + i * get_num_values()) for each key,
+   * but the keys are hashed in blocks and the hash table slots are prefetched
+   * before the values are applied to hide memory latency.
+   * @param keys pointer to the array of keys
+   * @param values pointer to the row-major matrix of values (num_keys rows of get_num_values() values)
+   * @param num_keys number of keys
+   */
+  void update_batch(const uint64_t* keys, const value_type* values, size_t num_keys);
+
+  /**
+   * Update this sketch with a batch of signed 64-bit integer keys and a matrix of values.
+   * The result is the same as calling update(keys[i], values + i * get_num_values()) for each key.
+   * @param keys pointer to the array of keys
+   * @param values pointer to the row-major matrix of values (num_keys rows of get_num_values() values)
+   * @param num_keys number of keys
+   */
+  void update_batch(const int64_t* keys, const value_type* values, size_t num_keys);
+
+  /**
+   * Update this sketch with a batch of double keys and a matrix of values.
+   * The result is the same as calling update(keys[i], values + i * get_num_values()) for each key.
+   * The keys are canonicalized in blocks and then updated as unsigned 64-bit integer keys.
+   * @param keys pointer to the array of keys
+   * @param values pointer to the row-major matrix of values (num_keys rows of get_num_values() values)
+   * @param num_keys number of keys
+   */
+  void update_batch(const double* keys, const value_type* values, size_t num_keys);
+
+  /**
+   * Update this sketch with a batch of string keys and a matrix of values.
+   * The result is the same as calling update(keys[i], values + i * get_num_values()) for each key.
+   * Empty strings are ignored.
+   * @param keys pointer to the array of keys
+   * @param values pointer to the row-major matrix of values (num_keys rows of get_num_values() values)
+   * @param num_keys number of keys
+   */
+  void update_batch(const std::string* keys, const value_type* values, size_t num_keys);
+
   compact_array_tuple_sketch<Array, Allocator> compact(bool ordered = true) const;
 
   /// @return number of values in array
@@ -138,11 +248,12 @@ private:
   // for builder
   update_array_tuple_sketch(uint8_t lg_cur_size, uint8_t lg_nom_size, resize_factor rf, float p, uint64_t theta,
       uint64_t seed, const Policy& policy, const Allocator& allocator);
+
 };
 
 /// Update array tuple sketch builder
-template<typename Array, typename Policy, typename Allocator>
-class update_array_tuple_sketch<Array, Policy, Allocator>::builder: public tuple_base_builder<builder, Policy, Allocator> {
+template<typename Array, typename Policy, typename Allocator, template<typename, typename, typename> class Map>
+class update_array_tuple_sketch<Array, Policy, Allocator, Map>::builder: public tuple_base_builder<builder, Policy, Allocator> {
 public:
   /**
    * Constructor
@@ -230,6 +341,153 @@ private:
   compact_array_tuple_sketch(uint8_t num_values, Base&& base);
 };
 
+/**
+ * Wrapped compact array tuple sketch.
+ * This is a read-only view of a serialized compact array tuple sketch.
+ * Keys and values are read directly from the given array of bytes, which must outlive the view.
+ * Iteration yields pairs of a key and a view of the values, which can be used wherever
+ * the values are only read, for instance as input to array_tuple_union, array_tuple_intersection
+ * and array_tuple_a_not_b, or converted to Array.
+ */
+template<
+  typename Array,
+  typename Allocator = typename Array::allocator_type
+>
+class wrapped_compact_array_tuple_sketch {
+public:
+  using value_type = typename Array::value_type;
+  using CompactSketch = compact_array_tuple_sketch<Array, Allocator>;
+
+  class values_view;
+  class const_iterator;
+
+  /// @return allocator
+  Allocator get_allocator() const;
+
+  /// @return true if this sketch represents an empty set (not the same as no retained entries!)
+  bool is_empty() const;
+
+  /// @return true if retained entries are ordered
+  bool is_ordered() const;
+
+  /// @return true if the sketch is in estimation mode (as opposed to exact mode)
+  bool is_estimation_mode() const;
+
+  /// @return theta as a fraction from 0 to 1 (effective sampling rate)
+  double get_theta() const;
+
+  /// @return theta as a positive integer between 0 and LLONG_MAX
+  uint64_t get_theta64() const;
+
+  /// @return the number of retained entries in the sketch
+  uint32_t get_num_retained() const;
+
+  /// @return hash of the seed that was used to hash the input
+  uint16_t get_seed_hash() const;
+
+  /// @return number of values in array
+  uint8_t get_num_values() const;
+
+  /// @return estimate of the distinct count of the input stream
+  double get_estimate() const;
+
+  /**
+   * Returns the approximate lower error bound given a number of standard deviations.
+   * @param num_std_devs number of Standard Deviations (1, 2 or 3)
+   * @return the lower bound
+   */
+  double get_lower_bound(uint8_t num_std_devs) const;
+
+  /**
+   * Returns the approximate upper error bound given a number of standard deviations.
+   * @param num_std_devs number of Standard Deviations (1, 2 or 3)
+   * @return the upper bound
+   */
+  double get_upper_bound(uint8_t num_std_devs) const;
+
+  /**
+   * Const iterator over entries in this sketch.
+   * @return begin iterator
+   */
+  const_iterator begin() const;
+
+  /**
+   * Const iterator pointing past the valid range.
+   * Not to be incremented or dereferenced.
+   * @return end iterator
+   */
+  const_iterator end() const;
+
+  /**
+   * This method wraps a serialized compact array tuple sketch as an array of bytes.
+   * The values are accessed in place, so the bytes must be aligned for value_type.
+   * @param bytes pointer to the array of bytes
+   * @param size the size of the array
+   * @param seed the seed for the hash function that was used to create the sketch
+   * @param allocator instance of an Allocator to use for converting values to Array
+   * @return an instance of the sketch
+   */
+  static wrapped_compact_array_tuple_sketch wrap(const void* bytes, size_t size, uint64_t seed = DEFAULT_SEED,
+      const Allocator& allocator = Allocator());
+
+private:
+  bool is_empty_;
+  bool is_ordered_;
+  uint8_t num_values_;
+  uint16_t seed_hash_;
+  uint32_t num_entries_;
+  uint64_t theta_;
+  const char* keys_;
+  const value_type* values_;
+  Allocator allocator_;
+
+  wrapped_compact_array_tuple_sketch(bool is_empty, bool is_ordered, uint8_t num_values, uint16_t seed_hash,
+      uint32_t num_entries, uint64_t theta, const char* keys, const value_type* values, const Allocator& allocator);
+};
+
+/// Read-only view of the values of one entry in a wrapped sketch
+template<typename Array, typename Allocator>
+class wrapped_compact_array_tuple_sketch<Array, Allocator>::values_view {
+public:
+  values_view(const value_type* data, uint8_t size, const Allocator& allocator):
+    data_(data), size_(size), allocator_(allocator) {}
+  value_type operator[](size_t index) const { return data_[index]; }
+  uint8_t size() const { return size_; }
+  const value_type* data() const { return data_; }
+  /// @return copy of the values
+  operator Array() const {
+    Array array(size_, 0, allocator_);
+    std::copy(data_, data_ + size_, array.data());
+    return array;
+  }
+private:
+  const value_type* data_;
+  uint8_t size_;
+  Allocator allocator_;
+};
+
+/// Const iterator over entries of a wrapped sketch yielding pairs of a key and a view of the values
+template<typename Array, typename Allocator>
+class wrapped_compact_array_tuple_sketch<Array, Allocator>::const_iterator {
+public:
+  using iterator_category = std::input_iterator_tag;
+  using value_type = std::pair<uint64_t, values_view>;
+  using difference_type = void;
+  using pointer = const value_type*;
+  using reference = value_type;
+
+  const_iterator(const wrapped_compact_array_tuple_sketch* sketch, uint32_t index);
+  const_iterator& operator++();
+  const_iterator operator++(int);
+  bool operator==(const const_iterator& other) const;
+  bool operator!=(const const_iterator& other) const;
+  reference operator*() const;
+
+private:
+  const wrapped_compact_array_tuple_sketch* sketch_;
+  uint32_t index_;
+};
+
 } /* namespace datasketches */
 
 #include "array_tuple_sketch_impl.hpp"
@@ -19,29 +19,66 @@
 
 namespace datasketches {
 
-template<typename Array, typename Policy, typename Allocator>
-update_array_tuple_sketch<Array, Policy, Allocator>::update_array_tuple_sketch(uint8_t lg_cur_size, uint8_t lg_nom_size, resize_factor rf,
+template<typename Array, typename Policy, typename Allocator, template<typename, typename, typename> class Map>
+update_array_tuple_sketch<Array, Policy, Allocator, Map>::update_array_tuple_sketch(uint8_t lg_cur_size, uint8_t lg_nom_size, resize_factor rf,
     float p, uint64_t theta, uint64_t seed, const Policy& policy, const Allocator& allocator):
 Base(lg_cur_size, lg_nom_size, rf, p, theta, seed, policy, allocator) {}
 
-template<typename Array, typename Policy, typename Allocator>
-uint8_t update_array_tuple_sketch<Array, Policy, Allocator>::get_num_values() const {
+template<typename Array, typename Policy, typename Allocator, template<typename, typename, typename> class Map>
+uint8_t update_array_tuple_sketch<Array, Policy, Allocator, Map>::get_num_values() const {
   return this->policy_.get_num_values();
 }
 
-template<typename Array, typename Policy, typename Allocator>
-compact_array_tuple_sketch<Array, Allocator> update_array_tuple_sketch<Array, Policy, Allocator>::compact(bool ordered) const {
+template<typename Array, typename Policy, typename Allocator, template<typename, typename, typename> class Map>
+void update_array_tuple_sketch<Array, Policy, Allocator, Map>::update_batch(const uint64_t* keys, const value_type* values, size_t num_keys) {
+  const uint8_t num_values = get_num_values();
+  this->update_batch_keys(keys, num_keys, [values, num_values](size_t i) { return values + i * num_values; });
+}
+
+template<typename Array, typename Policy, typename Allocator, template<typename, typename, typename> class Map>
+void update_array_tuple_sketch<Array, Policy, Allocator, Map>::update_batch(const int64_t* keys, const value_type* values, size_t num_keys) {
+  update_batch(reinterpret_cast<const uint64_t*>(keys), values, num_keys);
+}
+
+template<typename Array, typename Policy, typename Allocator, template<typename, typename, typename> class Map>
+void update_array_tuple_sketch<Array, Policy, Allocator, Map>::update_batch(const double* keys, const value_type* values, size_t num_keys) {
+  const uint8_t num_values = get_num_values();
+  uint64_t canonical_keys[Base::tuple_map::BATCH_SIZE];
+  while (num_keys > 0) {
+    const uint8_t block_size = static_cast<uint8_t>(num_keys < Base::tuple_map::BATCH_SIZE ? num_keys : Base::tuple_map::BATCH_SIZE);
+    for (uint8_t i = 0; i < block_size; ++i) canonical_keys[i] = canonical_double(keys[i]);
+    update_batch(canonical_keys, values, block_size);
+    keys += block_size;
+    values += block_size * num_values;
+    num_keys -= block_size;
+  }
+}
+
+template<typename Array, typename Policy, typename Allocator, template<typename, typename, typename> class Map>
+void update_array_tuple_sketch<Array, Policy, Allocator, Map>::update_batch(const std::string* keys, const value_type* values, size_t num_keys) {
+  const uint8_t num_values = get_num_values();
+  this->update_batch_impl(num_keys,
+    [this, keys](size_t i) -> uint64_t {
+      if (keys[i].empty()) return 0;
+      return this->map_.hash_and_screen(keys[i].c_str(), keys[i].length());
+    },
+    [values, num_values](size_t i) { return values + i * num_values; }
+  );
+}
+
+template<typename Array, typename Policy, typename Allocator, template<typename, typename, typename> class Map>
+compact_array_tuple_sketch<Array, Allocator> update_array_tuple_sketch<Array, Policy, Allocator, Map>::compact(bool ordered) const {
   return compact_array_tuple_sketch<Array, Allocator>(*this, ordered);
 }
 
 // builder
 
-template<typename Array, typename Policy, typename Allocator>
-update_array_tuple_sketch<Array, Policy, Allocator>::builder::builder(const Policy& policy, const Allocator& allocator):
+template<typename Array, typename Policy, typename Allocator, template<typename, typename, typename> class Map>
+update_array_tuple_sketch<Array, Policy, Allocator, Map>::builder::builder(const Policy& policy, const Allocator& allocator):
 tuple_base_builder<builder, Policy, Allocator>(policy, allocator) {}
 
-template<typename Array, typename Policy, typename Allocator>
-auto update_array_tuple_sketch<Array, Policy, Allocator>::builder::build() const -> update_array_tuple_sketch {
+template<typename Array, typename Policy, typename Allocator, template<typename, typename, typename> class Map>
+auto update_array_tuple_sketch<Array, Policy, Allocator, Map>::builder::build() const -> update_array_tuple_sketch {
   return update_array_tuple_sketch(this->starting_lg_size(), this->lg_k_, this->rf_, this->p_, this->starting_theta(), this->seed_, this->policy_, this->allocator_);
 }
 
@@ -221,4 +258,176 @@ compact_array_tuple_sketch<Array, Allocator> compact_array_tuple_sketch<Array, A
   return compact_array_tuple_sketch<Array, Allocator>(is_empty, is_ordered, seed_hash, theta, std::move(entries), num_values);
 }
 
+// wrapped compact sketch
+
+template<typename Array, typename Allocator>
+wrapped_compact_array_tuple_sketch<Array, Allocator>::wrapped_compact_array_tuple_sketch(bool is_empty, bool is_ordered,
+    uint8_t num_values, uint16_t seed_hash, uint32_t num_entries, uint64_t theta, const char* keys, const value_type* values,
+    const Allocator& allocator):
+is_empty_(is_empty),
+is_ordered_(is_ordered),
+num_values_(num_values),
+seed_hash_(seed_hash),
+num_entries_(num_entries),
+theta_(theta),
+keys_(keys),
+values_(values),
+allocator_(allocator)
+{}
+
+template<typename Array, typename Allocator>
+Allocator wrapped_compact_array_tuple_sketch<Array, Allocator>::get_allocator() const {
+  return allocator_;
+}
+
+template<typename Array, typename Allocator>
+bool wrapped_compact_array_tuple_sketch<Array, Allocator>::is_empty() const {
+  return is_empty_;
+}
+
+template<typename Array, typename Allocator>
+bool wrapped_compact_array_tuple_sketch<Array, Allocator>::is_ordered() const {
+  return is_ordered_;
+}
+
+template<typename Array, typename Allocator>
+bool wrapped_compact_array_tuple_sketch<Array, Allocator>::is_estimation_mode() const {
+  return theta_ < theta_constants::MAX_THETA && !is_empty_;
+}
+
+template<typename Array, typename Allocator>
+double wrapped_compact_array_tuple_sketch<Array, Allocator>::get_theta() const {
+  return static_cast<double>(theta_) / static_cast<double>(theta_constants::MAX_THETA);
+}
+
+template<typename Array, typename Allocator>
+uint64_t wrapped_compact_array_tuple_sketch<Array, Allocator>::get_theta64() const {
+  return theta_;
+}
+
+template<typename Array, typename Allocator>
+uint32_t wrapped_compact_array_tuple_sketch<Array, Allocator>::get_num_retained() const {
+  return num_entries_;
+}
+
+template<typename Array, typename Allocator>
+uint16_t wrapped_compact_array_tuple_sketch<Array, Allocator>::get_seed_hash() const {
+  return seed_hash_;
+}
+
+template<typename Array, typename Allocator>
+uint8_t wrapped_compact_array_tuple_sketch<Array, Allocator>::get_num_values() const {
+  return num_values_;
+}
+
+template<typename Array, typename Allocator>
+double wrapped_compact_array_tuple_sketch<Array, Allocator>::get_estimate() const {
+  return num_entries_ / get_theta();
+}
+
+template<typename Array, typename Allocator>
+double wrapped_compact_array_tuple_sketch<Array, Allocator>::get_lower_bound(uint8_t num_std_devs) const {
+  if (!is_estimation_mode()) return num_entries_;
+  return binomial_bounds::get_lower_bound(num_entries_, get_theta(), num_std_devs);
+}
+
+template<typename Array, typename Allocator>
+double wrapped_compact_array_tuple_sketch<Array, Allocator>::get_upper_bound(uint8_t num_std_devs) const {
+  if (!is_estimation_mode()) return num_entries_;
+  return binomial_bounds::get_upper_bound(num_entries_, get_theta(), num_std_devs);
+}
+
+template<typename Array, typename Allocator>
+auto wrapped_compact_array_tuple_sketch<Array, Allocator>::begin() const -> const_iterator {
+  return const_iterator(this, 0);
+}
+
+template<typename Array, typename Allocator>
+auto wrapped_compact_array_tuple_sketch<Array, Allocator>::end() const -> const_iterator {
+  return const_iterator(this, num_entries_);
+}
+
+template<typename Array, typename Allocator>
+wrapped_compact_array_tuple_sketch<Array, Allocator> wrapped_compact_array_tuple_sketch<Array, Allocator>::wrap(
+    const void* bytes, size_t size, uint64_t seed, const Allocator& allocator) {
+  ensure_minimum_memory(size, 16);
+  const char* ptr = static_cast<const char*>(bytes);
+  ptr += sizeof(uint8_t); // unused
+  uint8_t serial_version;
+  ptr += copy_from_mem(ptr, serial_version);
+  uint8_t family;
+  ptr += copy_from_mem(ptr, family);
+  uint8_t type;
+  ptr += copy_from_mem(ptr, type);
+  uint8_t flags_byte;
+  ptr += copy_from_mem(ptr, flags_byte);
+  uint8_t num_values;
+  ptr += copy_from_mem(ptr, num_values);
+  uint16_t seed_hash;
+  ptr += copy_from_mem(ptr, seed_hash);
+  checker<true>::check_serial_version(serial_version, CompactSketch::SERIAL_VERSION);
+  checker<true>::check_sketch_family(family, CompactSketch::SKETCH_FAMILY);
+  checker<true>::check_sketch_type(type, CompactSketch::SKETCH_TYPE);
+  const bool has_entries = flags_byte & (1 << CompactSketch::flags::HAS_ENTRIES);
+  if (has_entries) checker<true>::check_seed_hash(seed_hash, compute_seed_hash(seed));
+  uint64_t theta;
+  ptr += copy_from_mem(ptr, theta);
+  uint32_t num_entries = 0;
+  const char* keys = nullptr;
+  const value_type* values = nullptr;
+  if (has_entries) {
+    ensure_minimum_memory(size, 24);
+    ptr += copy_from_mem(ptr, num_entries);
+    ptr += sizeof(uint32_t); // unused
+    ensure_minimum_memory(size, 24 + (sizeof(uint64_t) + sizeof(value_type) * num_values) * num_entries);
+    keys = ptr;
+    ptr += sizeof(uint64_t) * num_entries;
+    if (reinterpret_cast<uintptr_t>(ptr) % alignof(value_type) != 0) {
+      throw std::invalid_argument("values must be aligned to " + std::to_string(alignof(value_type)) + " bytes");
+    }
+    values = reinterpret_cast<const value_type*>(ptr);
+  }
+  const bool is_empty = flags_byte & (1 << CompactSketch::flags::IS_EMPTY);
+  const bool is_ordered = flags_byte & (1 << CompactSketch::flags::IS_ORDERED);
+  return wrapped_compact_array_tuple_sketch(is_empty, is_ordered, num_values, seed_hash, num_entries, theta, keys, values, allocator);
+}
+
+template<typename Array, typename Allocator>
+wrapped_compact_array_tuple_sketch<Array, Allocator>::const_iterator::const_iterator(const wrapped_compact_array_tuple_sketch* sketch,
+    uint32_t index):
+sketch_(sketch),
+index_(index)
+{}
+
+template<typename Array, typename Allocator>
+auto wrapped_compact_array_tuple_sketch<Array, Allocator>::const_iterator::operator++() -> const_iterator& {
+  ++index_;
+  return *this;
+}
+
+template<typename Array, typename Allocator>
+auto wrapped_compact_array_tuple_sketch<Array, Allocator>::const_iterator::operator++(int) -> const_iterator {
+  const_iterator tmp(*this);
+  operator++();
+  return tmp;
+}
+
+template<typename Array, typename Allocator>
+bool wrapped_compact_array_tuple_sketch<Array, Allocator>::const_iterator::operator==(const const_iterator& other) const {
+  return index_ == other.index_;
+}
+
+template<typename Array, typename Allocator>
+bool wrapped_compact_array_tuple_sketch<Array, Allocator>::const_iterator::operator!=(const const_iterator& other) const {
+  return index_ != other.index_;
+}
+
+template<typename Array, typename Allocator>
+auto wrapped_compact_array_tuple_sketch<Array, Allocator>::const_iterator::operator*() const -> reference {
+  uint64_t key;
+  copy_from_mem(sketch_->keys_ + sizeof(uint64_t) * index_, key);
+  const uint8_t num_values = sketch_->num_values_;
+  return value_type(key, values_view(sketch_->values_ + static_cast<size_t>(index_) * num_values, num_values, sketch_->allocator_));
+}
+
 } /* namespace datasketches */
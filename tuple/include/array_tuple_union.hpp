@@ -33,10 +33,41 @@ template<typename Array>
 struct default_array_tuple_union_policy {
   default_array_tuple_union_policy(uint8_t num_values = 1): num_values_(num_values) {}
 
-  void operator()(Array& array, const Array& other) const {
-    for (uint8_t i = 0; i < num_values_; ++i) {
-      array[i] += other[i];
-    }
+  template<typename OtherArray> // to allow views of serialized arrays
+  void operator()(Array& array, const OtherArray& other) const {
+    array_tuple_ops::apply<array_tuple_ops::add_op>(array.data(), other, num_values_, 0);
+  }
+  uint8_t get_num_values() const {
+    return num_values_;
+  }
+private:
+  uint8_t num_values_;
+};
+
+/// array tuple union policy that keeps the minimum of each value, can be used for intersection as well
+template<typename Array>
+struct min_array_tuple_union_policy {
+  min_array_tuple_union_policy(uint8_t num_values = 1): num_values_(num_values) {}
+
+  template<typename OtherArray> // to allow views of serialized arrays
+  void operator()(Array& array, const OtherArray& other) const {
+    array_tuple_ops::apply<array_tuple_ops::min_op>(array.data(), other, num_values_, 0);
+  }
+  uint8_t get_num_values() const {
+    return num_values_;
+  }
+private:
+  uint8_t num_values_;
+};
+
+/// array tuple union policy that keeps the maximum of each value, can be used for intersection as well
+template<typename Array>
+struct max_array_tuple_union_policy {
+  max_array_tuple_union_policy(uint8_t num_values = 1): num_values_(num_values) {}
+
+  template<typename OtherArray> // to allow views of serialized arrays
+  void operator()(Array& array, const OtherArray& other) const {
+    array_tuple_ops::apply<array_tuple_ops::max_op>(array.data(), other, num_values_, 0);
   }
   uint8_t get_num_values() const {
     return num_values_;
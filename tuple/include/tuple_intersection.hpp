@@ -62,6 +62,11 @@ public:
     void operator()(Entry& internal_entry, Entry&& incoming_entry) const {
       external_policy_(internal_entry.second, std::move(incoming_entry.second));
     }
+    // entries of read-only views, the external policy gets the view of the incoming summary
+    template<typename V>
+    void operator()(Entry& internal_entry, const std::pair<uint64_t, V>& incoming_entry) const {
+      external_policy_(internal_entry.second, incoming_entry.second);
+    }
     const Policy& get_external_policy() const { return external_policy_; }
     Policy external_policy_;
   };
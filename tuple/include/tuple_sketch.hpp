@@ -24,12 +24,13 @@
 
 #include "serde.hpp"
 #include "theta_update_sketch_base.hpp"
+#include "theta_update_sketch_dense_keys_base.hpp"
 
 namespace datasketches {
 
 // forward declarations
 template<typename S, typename A> class tuple_sketch;
-template<typename S, typename U, typename P, typename A> class update_tuple_sketch;
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M> class update_tuple_sketch;
 template<typename S, typename A> class compact_tuple_sketch;
 template<typename A> class theta_sketch_alloc;
 
@@ -41,6 +42,11 @@ struct pair_extract_key {
   const K& operator()(const std::pair<K, V>& entry) const {
     return entry.first;
   }
+  // entries with another representation of the value, such as views of serialized sketches
+  template<typename V2>
+  const K& operator()(const std::pair<K, V2>& entry) const {
+    return entry.first;
+  }
 };
 
 /**
@@ -206,13 +212,17 @@ struct default_tuple_update_policy {
 /**
  * Update Tuple sketch.
  * The purpose of this class is to build a Tuple sketch from input data via the update() methods.
+ * The layout of the internal hash table is selected by the Map template parameter:
+ * theta_update_sketch_base (default) stores entries only, theta_update_sketch_dense_keys_base
+ * also keeps a dense array of keys, which speeds up probing for large summaries.
  * There is no constructor. Use builder instead.
  */
 template<
   typename Summary,
   typename Update = Summary,
   typename Policy = default_tuple_update_policy<Summary, Update>,
-  typename Allocator = std::allocator<Summary>
+  typename Allocator = std::allocator<Summary>,
+  template<typename, typename, typename> class Map = theta_update_sketch_base
 >
 class update_tuple_sketch: public tuple_sketch<Summary, Allocator> {
 public:
@@ -222,7 +232,7 @@ public:
   using iterator = typename Base::iterator;
   using const_iterator = typename Base::const_iterator;
   using AllocEntry = typename std::allocator_traits<Allocator>::template rebind_alloc<Entry>;
-  using tuple_map = theta_update_sketch_base<Entry, ExtractKey, AllocEntry>;
+  using tuple_map = Map<Entry, ExtractKey, AllocEntry>;
   using resize_factor = typename tuple_map::resize_factor;
 
   // No constructor here. Use builder instead.
@@ -364,6 +374,49 @@ public:
   template<typename FwdUpdate>
   void update(const void* key, size_t length, FwdUpdate&& value);
 
+  /**
+   * Update this sketch with a batch of unsigned 64-bit integer keys and parallel update values.
+   * The result is the same as calling update(keys[i], updates[i]) for each key,
+   * but the keys are hashed in blocks by a specialized 8-byte kernel and the hash table slots
+   * are prefetched before the policy is applied to hide memory latency.
+   * @param keys pointer to the array of keys
+   * @param updates pointer to the array of update values
+   * @param num_keys number of keys and update values
+   */
+  template<typename InputUpdate>
+  void update_batch(const uint64_t* keys, const InputUpdate* updates, size_t num_keys);
+
+  /**
+   * Update this sketch with a batch of signed 64-bit integer keys and parallel update values.
+   * The result is the same as calling update(keys[i], updates[i]) for each key.
+   * @param keys pointer to the array of keys
+   * @param updates pointer to the array of update values
+   * @param num_keys number of keys and update values
+   */
+  template<typename InputUpdate>
+  void update_batch(const int64_t* keys, const InputUpdate* updates, size_t num_keys);
+
+  /**
+   * Update this sketch with a batch of double-precision floating point keys and parallel update values.
+   * The result is the same as calling update(keys[i], updates[i]) for each key.
+   * @param keys pointer to the array of keys
+   * @param updates pointer to the array of update values
+   * @param num_keys number of keys and update values
+   */
+  template<typename InputUpdate>
+  void update_batch(const double* keys, const InputUpdate* updates, size_t num_keys);
+
+  /**
+   * Update this sketch with a batch of string keys and parallel update values.
+   * The result is the same as calling update(keys[i], updates[i]) for each key.
+   * Empty strings are ignored.
+   * @param keys pointer to the array of keys
+   * @param updates pointer to the array of update values
+   * @param num_keys number of keys and update values
+   */
+  template<typename InputUpdate>
+  void update_batch(const std::string* keys, const InputUpdate* updates, size_t num_keys);
+
   /**
    * Remove retained entries in excess of the nominal size k (if any)
    */
@@ -402,6 +455,14 @@ protected:
   // for builder
   update_tuple_sketch(uint8_t lg_cur_size, uint8_t lg_nom_size, resize_factor rf, float p, uint64_t theta, uint64_t seed, const Policy& policy, const Allocator& allocator);
 
+  // batch updates, GetUpdate returns the update value for a given index in the batch
+  template<typename HashAndScreen, typename GetUpdate>
+  void update_batch_impl(size_t num_keys, HashAndScreen&& hash_and_screen, GetUpdate&& get_update);
+  template<typename GetUpdate>
+  void update_batch_keys(const uint64_t* keys, size_t num_keys, GetUpdate&& get_update);
+  template<typename GetUpdate>
+  void apply_batch(const uint64_t* hashes, const size_t* indices, uint8_t num_hashes, GetUpdate&& get_update);
+
   virtual void print_specifics(std::ostringstream& os) const;
 };
 
@@ -446,6 +507,16 @@ public:
    */
   compact_tuple_sketch(const Base& other, bool ordered);
 
+  /**
+   * Constructs a compact sketch from a sketch of another type with the same interface,
+   * such as a read-only view of a serialized sketch, with entries convertible to Entry
+   * @param other sketch to be copied
+   * @param ordered if true make the resulting sketch ordered
+   */
+  template<typename Other, typename = typename std::enable_if<!std::is_base_of<Base, Other>::value &&
+      std::is_convertible<decltype(*std::declval<const Other&>().begin()), Entry>::value>::type>
+  compact_tuple_sketch(const Other& other, bool ordered);
+
   /**
    * Copy constructor.
    * @param other sketch to be copied
@@ -620,8 +691,8 @@ protected:
 };
 
 /// Update Tuple sketch builder
-template<typename S, typename U, typename P, typename A>
-class update_tuple_sketch<S, U, P, A>::builder: public tuple_base_builder<builder, P, A> {
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+class update_tuple_sketch<S, U, P, A, M>::builder: public tuple_base_builder<builder, P, A> {
 public:
   /**
    * Constructor
@@ -635,7 +706,7 @@ public:
    * This is to create an instance of the sketch with predefined parameters.
    * @return an instance of the sketch
    */
-  update_tuple_sketch<S, U, P, A> build() const;
+  update_tuple_sketch<S, U, P, A, M> build() const;
 };
 
 } /* namespace datasketches */
@@ -22,6 +22,7 @@
 
 #include "binomial_bounds.hpp"
 #include "theta_helpers.hpp"
+#include "theta_radix_sort.hpp"
 
 namespace datasketches {
 
@@ -95,122 +96,122 @@ string<A> tuple_sketch<S, A>::to_string(bool detail) const {
 
 // update sketch
 
-template<typename S, typename U, typename P, typename A>
-update_tuple_sketch<S, U, P, A>::update_tuple_sketch(uint8_t lg_cur_size, uint8_t lg_nom_size, resize_factor rf, float p, uint64_t theta, uint64_t seed, const P& policy, const A& allocator):
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+update_tuple_sketch<S, U, P, A, M>::update_tuple_sketch(uint8_t lg_cur_size, uint8_t lg_nom_size, resize_factor rf, float p, uint64_t theta, uint64_t seed, const P& policy, const A& allocator):
 policy_(policy),
 map_(lg_cur_size, lg_nom_size, rf, p, theta, seed, allocator)
 {}
 
-template<typename S, typename U, typename P, typename A>
-A update_tuple_sketch<S, U, P, A>::get_allocator() const {
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+A update_tuple_sketch<S, U, P, A, M>::get_allocator() const {
   return map_.allocator_;
 }
 
-template<typename S, typename U, typename P, typename A>
-bool update_tuple_sketch<S, U, P, A>::is_empty() const {
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+bool update_tuple_sketch<S, U, P, A, M>::is_empty() const {
   return map_.is_empty_;
 }
 
-template<typename S, typename U, typename P, typename A>
-bool update_tuple_sketch<S, U, P, A>::is_ordered() const {
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+bool update_tuple_sketch<S, U, P, A, M>::is_ordered() const {
   return map_.num_entries_ > 1 ? false : true;;
 }
 
-template<typename S, typename U, typename P, typename A>
-uint64_t update_tuple_sketch<S, U, P, A>::get_theta64() const {
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+uint64_t update_tuple_sketch<S, U, P, A, M>::get_theta64() const {
   return is_empty() ? theta_constants::MAX_THETA : map_.theta_;
 }
 
-template<typename S, typename U, typename P, typename A>
-uint32_t update_tuple_sketch<S, U, P, A>::get_num_retained() const {
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+uint32_t update_tuple_sketch<S, U, P, A, M>::get_num_retained() const {
   return map_.num_entries_;
 }
 
-template<typename S, typename U, typename P, typename A>
-uint16_t update_tuple_sketch<S, U, P, A>::get_seed_hash() const {
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+uint16_t update_tuple_sketch<S, U, P, A, M>::get_seed_hash() const {
   return compute_seed_hash(map_.seed_);
 }
 
-template<typename S, typename U, typename P, typename A>
-uint8_t update_tuple_sketch<S, U, P, A>::get_lg_k() const {
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+uint8_t update_tuple_sketch<S, U, P, A, M>::get_lg_k() const {
   return map_.lg_nom_size_;
 }
 
-template<typename S, typename U, typename P, typename A>
-auto update_tuple_sketch<S, U, P, A>::get_rf() const -> resize_factor {
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+auto update_tuple_sketch<S, U, P, A, M>::get_rf() const -> resize_factor {
   return map_.rf_;
 }
 
-template<typename S, typename U, typename P, typename A>
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
 template<typename UU>
-void update_tuple_sketch<S, U, P, A>::update(uint64_t key, UU&& value) {
+void update_tuple_sketch<S, U, P, A, M>::update(uint64_t key, UU&& value) {
   update(&key, sizeof(key), std::forward<UU>(value));
 }
 
-template<typename S, typename U, typename P, typename A>
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
 template<typename UU>
-void update_tuple_sketch<S, U, P, A>::update(int64_t key, UU&& value) {
+void update_tuple_sketch<S, U, P, A, M>::update(int64_t key, UU&& value) {
   update(&key, sizeof(key), std::forward<UU>(value));
 }
 
-template<typename S, typename U, typename P, typename A>
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
 template<typename UU>
-void update_tuple_sketch<S, U, P, A>::update(uint32_t key, UU&& value) {
+void update_tuple_sketch<S, U, P, A, M>::update(uint32_t key, UU&& value) {
   update(static_cast<int32_t>(key), std::forward<UU>(value));
 }
 
-template<typename S, typename U, typename P, typename A>
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
 template<typename UU>
-void update_tuple_sketch<S, U, P, A>::update(int32_t key, UU&& value) {
+void update_tuple_sketch<S, U, P, A, M>::update(int32_t key, UU&& value) {
   update(static_cast<int64_t>(key), std::forward<UU>(value));
 }
 
-template<typename S, typename U, typename P, typename A>
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
 template<typename UU>
-void update_tuple_sketch<S, U, P, A>::update(uint16_t key, UU&& value) {
+void update_tuple_sketch<S, U, P, A, M>::update(uint16_t key, UU&& value) {
   update(static_cast<int16_t>(key), std::forward<UU>(value));
 }
 
-template<typename S, typename U, typename P, typename A>
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
 template<typename UU>
-void update_tuple_sketch<S, U, P, A>::update(int16_t key, UU&& value) {
+void update_tuple_sketch<S, U, P, A, M>::update(int16_t key, UU&& value) {
   update(static_cast<int64_t>(key), std::forward<UU>(value));
 }
 
-template<typename S, typename U, typename P, typename A>
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
 template<typename UU>
-void update_tuple_sketch<S, U, P, A>::update(uint8_t key, UU&& value) {
+void update_tuple_sketch<S, U, P, A, M>::update(uint8_t key, UU&& value) {
   update(static_cast<int8_t>(key), std::forward<UU>(value));
 }
 
-template<typename S, typename U, typename P, typename A>
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
 template<typename UU>
-void update_tuple_sketch<S, U, P, A>::update(int8_t key, UU&& value) {
+void update_tuple_sketch<S, U, P, A, M>::update(int8_t key, UU&& value) {
   update(static_cast<int64_t>(key), std::forward<UU>(value));
 }
 
-template<typename S, typename U, typename P, typename A>
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
 template<typename UU>
-void update_tuple_sketch<S, U, P, A>::update(const std::string& key, UU&& value) {
+void update_tuple_sketch<S, U, P, A, M>::update(const std::string& key, UU&& value) {
   if (key.empty()) return;
   update(key.c_str(), key.length(), std::forward<UU>(value));
 }
 
-template<typename S, typename U, typename P, typename A>
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
 template<typename UU>
-void update_tuple_sketch<S, U, P, A>::update(double key, UU&& value) {
+void update_tuple_sketch<S, U, P, A, M>::update(double key, UU&& value) {
   update(canonical_double(key), std::forward<UU>(value));
 }
 
-template<typename S, typename U, typename P, typename A>
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
 template<typename UU>
-void update_tuple_sketch<S, U, P, A>::update(float key, UU&& value) {
+void update_tuple_sketch<S, U, P, A, M>::update(float key, UU&& value) {
   update(static_cast<double>(key), std::forward<UU>(value));
 }
 
-template<typename S, typename U, typename P, typename A>
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
 template<typename UU>
-void update_tuple_sketch<S, U, P, A>::update(const void* key, size_t length, UU&& value) {
+void update_tuple_sketch<S, U, P, A, M>::update(const void* key, size_t length, UU&& value) {
   const uint64_t hash = map_.hash_and_screen(key, length);
   if (hash == 0) return;
   auto result = map_.find(hash);
@@ -223,49 +224,149 @@ void update_tuple_sketch<S, U, P, A>::update(const void* key, size_t length, UU&
   }
 }
 
-template<typename S, typename U, typename P, typename A>
-void update_tuple_sketch<S, U, P, A>::trim() {
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+template<typename InputUpdate>
+void update_tuple_sketch<S, U, P, A, M>::update_batch(const uint64_t* keys, const InputUpdate* updates, size_t num_keys) {
+  update_batch_keys(keys, num_keys, [updates](size_t i) -> const InputUpdate& { return updates[i]; });
+}
+
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+template<typename InputUpdate>
+void update_tuple_sketch<S, U, P, A, M>::update_batch(const int64_t* keys, const InputUpdate* updates, size_t num_keys) {
+  update_batch(reinterpret_cast<const uint64_t*>(keys), updates, num_keys);
+}
+
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+template<typename InputUpdate>
+void update_tuple_sketch<S, U, P, A, M>::update_batch(const double* keys, const InputUpdate* updates, size_t num_keys) {
+  uint64_t canonical_keys[tuple_map::BATCH_SIZE];
+  while (num_keys > 0) {
+    const uint8_t block_size = static_cast<uint8_t>(num_keys < tuple_map::BATCH_SIZE ? num_keys : tuple_map::BATCH_SIZE);
+    for (uint8_t i = 0; i < block_size; ++i) canonical_keys[i] = canonical_double(keys[i]);
+    update_batch(canonical_keys, updates, block_size);
+    keys += block_size;
+    updates += block_size;
+    num_keys -= block_size;
+  }
+}
+
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+template<typename InputUpdate>
+void update_tuple_sketch<S, U, P, A, M>::update_batch(const std::string* keys, const InputUpdate* updates, size_t num_keys) {
+  update_batch_impl(num_keys,
+    [this, keys](size_t i) -> uint64_t {
+      if (keys[i].empty()) return 0;
+      return map_.hash_and_screen(keys[i].c_str(), keys[i].length());
+    },
+    [updates](size_t i) -> const InputUpdate& { return updates[i]; }
+  );
+}
+
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+template<typename HashAndScreen, typename GetUpdate>
+void update_tuple_sketch<S, U, P, A, M>::update_batch_impl(size_t num_keys, HashAndScreen&& hash_and_screen, GetUpdate&& get_update) {
+  uint64_t hashes[tuple_map::BATCH_SIZE];
+  size_t indices[tuple_map::BATCH_SIZE];
+  uint8_t num_hashes = 0;
+  for (size_t i = 0; i < num_keys; ++i) {
+    const uint64_t hash = hash_and_screen(i);
+    if (hash == 0) continue;
+    map_.prefetch(hash);
+    hashes[num_hashes] = hash;
+    indices[num_hashes++] = i;
+    if (num_hashes == tuple_map::BATCH_SIZE) {
+      apply_batch(hashes, indices, num_hashes, get_update);
+      num_hashes = 0;
+    }
+  }
+  apply_batch(hashes, indices, num_hashes, get_update);
+}
+
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+template<typename GetUpdate>
+void update_tuple_sketch<S, U, P, A, M>::update_batch_keys(const uint64_t* keys, size_t num_keys, GetUpdate&& get_update) {
+  if (num_keys == 0) return;
+  map_.is_empty_ = false;
+  HashState hash_states[tuple_map::BATCH_SIZE];
+  uint64_t hashes[tuple_map::BATCH_SIZE];
+  size_t indices[tuple_map::BATCH_SIZE];
+  for (size_t offset = 0; offset < num_keys; offset += tuple_map::BATCH_SIZE) {
+    const size_t remaining = num_keys - offset;
+    const uint8_t block_size = static_cast<uint8_t>(remaining < tuple_map::BATCH_SIZE ? remaining : tuple_map::BATCH_SIZE);
+    MurmurHash3_x64_128_batch(keys + offset, block_size, map_.seed_, hash_states);
+    uint8_t num_hashes = 0;
+    for (uint8_t i = 0; i < block_size; ++i) {
+      const uint64_t hash = hash_states[i].h1 >> 1; // same as compute_hash()
+      if (hash == 0 || hash >= map_.theta_) continue;
+      map_.prefetch(hash);
+      hashes[num_hashes] = hash;
+      indices[num_hashes++] = offset + i;
+    }
+    apply_batch(hashes, indices, num_hashes, get_update);
+  }
+}
+
+// hashes were screened against theta before the preceding ones were applied,
+// which could have reduced theta or resized the table
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+template<typename GetUpdate>
+void update_tuple_sketch<S, U, P, A, M>::apply_batch(const uint64_t* hashes, const size_t* indices, uint8_t num_hashes, GetUpdate&& get_update) {
+  for (uint8_t i = 0; i < num_hashes; ++i) {
+    if (hashes[i] >= map_.theta_) continue;
+    auto result = map_.find(hashes[i]);
+    if (!result.second) {
+      S summary = policy_.create();
+      policy_.update(summary, get_update(indices[i]));
+      map_.insert(result.first, Entry(hashes[i], std::move(summary)));
+    } else {
+      policy_.update((*result.first).second, get_update(indices[i]));
+    }
+  }
+}
+
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+void update_tuple_sketch<S, U, P, A, M>::trim() {
   map_.trim();
 }
 
-template<typename S, typename U, typename P, typename A>
-void update_tuple_sketch<S, U, P, A>::reset() {
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+void update_tuple_sketch<S, U, P, A, M>::reset() {
   map_.reset();
 }
 
-template<typename S, typename U, typename P, typename A>
-auto update_tuple_sketch<S, U, P, A>::begin() -> iterator {
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+auto update_tuple_sketch<S, U, P, A, M>::begin() -> iterator {
   return iterator(map_.entries_, 1 << map_.lg_cur_size_, 0);
 }
 
-template<typename S, typename U, typename P, typename A>
-auto update_tuple_sketch<S, U, P, A>::end() -> iterator {
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+auto update_tuple_sketch<S, U, P, A, M>::end() -> iterator {
   return iterator(nullptr, 0, 1 << map_.lg_cur_size_);
 }
 
-template<typename S, typename U, typename P, typename A>
-auto update_tuple_sketch<S, U, P, A>::begin() const -> const_iterator {
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+auto update_tuple_sketch<S, U, P, A, M>::begin() const -> const_iterator {
   return const_iterator(map_.entries_, 1 << map_.lg_cur_size_, 0);
 }
 
-template<typename S, typename U, typename P, typename A>
-auto update_tuple_sketch<S, U, P, A>::end() const -> const_iterator {
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+auto update_tuple_sketch<S, U, P, A, M>::end() const -> const_iterator {
   return const_iterator(nullptr, 0, 1 << map_.lg_cur_size_);
 }
 
-template<typename S, typename U, typename P, typename A>
-compact_tuple_sketch<S, A> update_tuple_sketch<S, U, P, A>::compact(bool ordered) const {
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+compact_tuple_sketch<S, A> update_tuple_sketch<S, U, P, A, M>::compact(bool ordered) const {
   return compact_tuple_sketch<S, A>(*this, ordered);
 }
 
-template<typename S, typename U, typename P, typename A>
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
 template<typename Predicate>
-compact_tuple_sketch<S, A> update_tuple_sketch<S, U, P, A>::filter(const Predicate& predicate) const {
+compact_tuple_sketch<S, A> update_tuple_sketch<S, U, P, A, M>::filter(const Predicate& predicate) const {
   return compact_tuple_sketch<S, A>::filter(*this, predicate);
 }
 
-template<typename S, typename U, typename P, typename A>
-void update_tuple_sketch<S, U, P, A>::print_specifics(std::ostringstream& os) const {
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+void update_tuple_sketch<S, U, P, A, M>::print_specifics(std::ostringstream& os) const {
   os << "   lg nominal size      : " << (int) map_.lg_nom_size_ << std::endl;
   os << "   lg current size      : " << (int) map_.lg_cur_size_ << std::endl;
   os << "   resize factor        : " << (1 << map_.rf_) << std::endl;
@@ -293,7 +394,21 @@ entries_(other.get_allocator())
 {
   entries_.reserve(other.get_num_retained());
   std::copy(other.begin(), other.end(), std::back_inserter(entries_));
-  if (ordered && !other.is_ordered()) std::sort(entries_.begin(), entries_.end(), comparator());
+  if (ordered && !other.is_ordered()) sort_by_key<ExtractKey>(entries_.begin(), entries_.end(), entries_.get_allocator());
+}
+
+template<typename S, typename A>
+template<typename Other, typename>
+compact_tuple_sketch<S, A>::compact_tuple_sketch(const Other& other, bool ordered):
+is_empty_(other.is_empty()),
+is_ordered_(other.is_ordered() || ordered),
+seed_hash_(other.get_seed_hash()),
+theta_(other.get_theta64()),
+entries_(other.get_allocator())
+{
+  entries_.reserve(other.get_num_retained());
+  std::copy(other.begin(), other.end(), std::back_inserter(entries_));
+  if (ordered && !other.is_ordered()) sort_by_key<ExtractKey>(entries_.begin(), entries_.end(), entries_.get_allocator());
 }
 
 template<typename S, typename A>
@@ -317,7 +432,7 @@ entries_(other.get_allocator())
   for (uint64_t hash: other) {
     entries_.push_back(Entry(hash, summary));
   }
-  if (ordered && !other.is_ordered()) std::sort(entries_.begin(), entries_.end(), comparator());
+  if (ordered && !other.is_ordered()) sort_by_key<ExtractKey>(entries_.begin(), entries_.end(), entries_.get_allocator());
 }
 
 template<typename S, typename A>
@@ -622,12 +737,12 @@ template<typename D, typename P, typename A>
 tuple_base_builder<D, P, A>::tuple_base_builder(const P& policy, const A& allocator):
 theta_base_builder<D, A>(allocator), policy_(policy) {}
 
-template<typename S, typename U, typename P, typename A>
-update_tuple_sketch<S, U, P, A>::builder::builder(const P& policy, const A& allocator):
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+update_tuple_sketch<S, U, P, A, M>::builder::builder(const P& policy, const A& allocator):
 tuple_base_builder<builder, P, A>(policy, allocator) {}
 
-template<typename S, typename U, typename P, typename A>
-auto update_tuple_sketch<S, U, P, A>::builder::build() const -> update_tuple_sketch {
+template<typename S, typename U, typename P, typename A, template<typename, typename, typename> class M>
+auto update_tuple_sketch<S, U, P, A, M>::builder::build() const -> update_tuple_sketch {
   return update_tuple_sketch(this->starting_lg_size(), this->lg_k_, this->rf_, this->p_, this->starting_theta(), this->seed_, this->policy_, this->allocator_);
 }
 
@@ -61,11 +61,20 @@ public:
     void operator()(Entry& internal_entry, Entry&& incoming_entry) const {
       external_policy_(internal_entry.second, std::move(incoming_entry.second));
     }
+    // entries of read-only views, the external policy gets the view of the incoming summary
+    template<typename V>
+    void operator()(Entry& internal_entry, const std::pair<uint64_t, V>& incoming_entry) const {
+      external_policy_(internal_entry.second, incoming_entry.second);
+    }
     const Policy& get_external_policy() const { return external_policy_; }
     Policy external_policy_;
   };
 
   using State = theta_union_base<Entry, ExtractKey, internal_policy, Sketch, CompactSketch, AllocEntry>;
+  using vector_bytes = typename State::vector_bytes;
+
+  /// family ID of the serialized state
+  static const uint8_t STATE_FAMILY = 9;
 
   // No constructor here. Use builder instead.
   class builder;
@@ -89,9 +98,75 @@ public:
    */
   void reset();
 
+  /**
+   * Serializes the internal state of the union including the hash table into a given stream.
+   * Unlike the result, the state can be deserialized to continue the union.
+   * @param os output stream
+   * @param sd instance of a SerDe
+   */
+  template<typename SerDe = serde<Summary>>
+  void serialize(std::ostream& os, const SerDe& sd = SerDe()) const;
+
+  /**
+   * Serializes the internal state of the union including the hash table as a vector of bytes.
+   * An optional header can be reserved in front of the state.
+   * It is a blank space of a given size.
+   * @param header_size_bytes space to reserve in front of the state
+   * @param sd instance of a SerDe
+   * @return serialized state as a vector of bytes
+   */
+  template<typename SerDe = serde<Summary>>
+  vector_bytes serialize(unsigned header_size_bytes = 0, const SerDe& sd = SerDe()) const;
+
+  /**
+   * Deserializes the state of a union from a given stream to continue the union.
+   * @param is input stream
+   * @param seed the seed for the hash function that was used to create the union
+   * @param sd instance of a SerDe
+   * @param policy instance of a union policy
+   * @param allocator instance of an Allocator
+   * @return an instance of the union
+   */
+  template<typename SerDe = serde<Summary>>
+  static tuple_union deserialize(std::istream& is, uint64_t seed = DEFAULT_SEED, const SerDe& sd = SerDe(),
+      const Policy& policy = Policy(), const Allocator& allocator = Allocator());
+
+  /**
+   * Deserializes the state of a union from a given array of bytes to continue the union.
+   * @param bytes pointer to the array of bytes
+   * @param size the size of the array
+   * @param seed the seed for the hash function that was used to create the union
+   * @param sd instance of a SerDe
+   * @param policy instance of a union policy
+   * @param allocator instance of an Allocator
+   * @return an instance of the union
+   */
+  template<typename SerDe = serde<Summary>>
+  static tuple_union deserialize(const void* bytes, size_t size, uint64_t seed = DEFAULT_SEED, const SerDe& sd = SerDe(),
+      const Policy& policy = Policy(), const Allocator& allocator = Allocator());
+
 protected:
   State state_;
 
+  // serialization of the hash table entries in the state: key followed by summary
+  template<typename SerDe>
+  struct state_serde {
+    static const uint8_t FAMILY = STATE_FAMILY;
+    const SerDe& sd_;
+    explicit state_serde(const SerDe& sd): sd_(sd) {}
+    void serialize(std::ostream& os, const Entry& entry) const;
+    size_t serialize(void* ptr, size_t capacity, const Entry& entry) const;
+    size_t size_of(const Entry& entry) const;
+    Entry deserialize(std::istream& is) const;
+    Entry deserialize(const void* ptr, size_t capacity, size_t& size) const;
+    // destroys a summary constructed in local storage
+    struct summary_destroyer {
+      void operator()(Summary* ptr) const { ptr->~Summary(); }
+    };
+  };
+
+  explicit tuple_union(State&& state);
+
   // for builder
   tuple_union(uint8_t lg_cur_size, uint8_t lg_nom_size, resize_factor rf, float p, uint64_t theta, uint64_t seed, const Policy& policy, const Allocator& allocator);
 };
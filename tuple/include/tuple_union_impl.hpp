@@ -17,6 +17,11 @@
  * under the License.
  */
 
+#include <memory>
+#include <type_traits>
+
+#include "memory_operations.hpp"
+
 namespace datasketches {
 
 template<typename S, typename P, typename A>
@@ -24,6 +29,11 @@ tuple_union<S, P, A>::tuple_union(uint8_t lg_cur_size, uint8_t lg_nom_size, resi
 state_(lg_cur_size, lg_nom_size, rf, p, theta, seed, internal_policy(policy), allocator)
 {}
 
+template<typename S, typename P, typename A>
+tuple_union<S, P, A>::tuple_union(State&& state):
+state_(std::move(state))
+{}
+
 template<typename S, typename P, typename A>
 template<typename SS>
 void tuple_union<S, P, A>::update(SS&& sketch) {
@@ -40,6 +50,80 @@ void tuple_union<S, P, A>::reset() {
   return state_.reset();
 }
 
+template<typename S, typename P, typename A>
+template<typename SerDe>
+void tuple_union<S, P, A>::serialize(std::ostream& os, const SerDe& sd) const {
+  state_.serialize(os, state_serde<SerDe>(sd));
+}
+
+template<typename S, typename P, typename A>
+template<typename SerDe>
+auto tuple_union<S, P, A>::serialize(unsigned header_size_bytes, const SerDe& sd) const -> vector_bytes {
+  return state_.serialize(header_size_bytes, state_serde<SerDe>(sd));
+}
+
+template<typename S, typename P, typename A>
+template<typename SerDe>
+auto tuple_union<S, P, A>::deserialize(std::istream& is, uint64_t seed, const SerDe& sd, const P& policy,
+    const A& allocator) -> tuple_union {
+  return tuple_union(State::deserialize(is, seed, state_serde<SerDe>(sd), internal_policy(policy), AllocEntry(allocator)));
+}
+
+template<typename S, typename P, typename A>
+template<typename SerDe>
+auto tuple_union<S, P, A>::deserialize(const void* bytes, size_t size, uint64_t seed, const SerDe& sd, const P& policy,
+    const A& allocator) -> tuple_union {
+  return tuple_union(State::deserialize(bytes, size, seed, state_serde<SerDe>(sd), internal_policy(policy), AllocEntry(allocator)));
+}
+
+template<typename S, typename P, typename A>
+template<typename SerDe>
+void tuple_union<S, P, A>::state_serde<SerDe>::serialize(std::ostream& os, const Entry& entry) const {
+  write(os, entry.first);
+  sd_.serialize(os, &entry.second, 1);
+}
+
+template<typename S, typename P, typename A>
+template<typename SerDe>
+size_t tuple_union<S, P, A>::state_serde<SerDe>::serialize(void* ptr, size_t capacity, const Entry& entry) const {
+  check_memory_size(sizeof(uint64_t), capacity);
+  uint8_t* ptr8 = static_cast<uint8_t*>(ptr);
+  const size_t key_size = copy_to_mem(entry.first, ptr8);
+  return key_size + sd_.serialize(ptr8 + key_size, capacity - key_size, &entry.second, 1);
+}
+
+template<typename S, typename P, typename A>
+template<typename SerDe>
+size_t tuple_union<S, P, A>::state_serde<SerDe>::size_of(const Entry& entry) const {
+  return sizeof(uint64_t) + sd_.size_of_item(entry.second);
+}
+
+template<typename S, typename P, typename A>
+template<typename SerDe>
+auto tuple_union<S, P, A>::state_serde<SerDe>::deserialize(std::istream& is) const -> Entry {
+  const auto key = read<uint64_t>(is);
+  // SerDe constructs the summary in place and destroys it if deserialization fails
+  typename std::aligned_storage<sizeof(S), alignof(S)>::type storage;
+  S* summary = reinterpret_cast<S*>(&storage);
+  sd_.deserialize(is, summary, 1);
+  std::unique_ptr<S, summary_destroyer> guard(summary);
+  return Entry(key, std::move(*summary));
+}
+
+template<typename S, typename P, typename A>
+template<typename SerDe>
+auto tuple_union<S, P, A>::state_serde<SerDe>::deserialize(const void* ptr, size_t capacity, size_t& size) const -> Entry {
+  ensure_minimum_memory(capacity, sizeof(uint64_t));
+  const uint8_t* ptr8 = static_cast<const uint8_t*>(ptr);
+  uint64_t key;
+  const size_t key_size = copy_from_mem(ptr8, key);
+  typename std::aligned_storage<sizeof(S), alignof(S)>::type storage;
+  S* summary = reinterpret_cast<S*>(&storage);
+  size = key_size + sd_.deserialize(ptr8 + key_size, capacity - key_size, summary, 1);
+  std::unique_ptr<S, summary_destroyer> guard(summary);
+  return Entry(key, std::move(*summary));
+}
+
 template<typename S, typename P, typename A>
 tuple_union<S, P, A>::builder::builder(const P& policy, const A& allocator):
 tuple_base_builder<builder, P, A>(policy, allocator) {}
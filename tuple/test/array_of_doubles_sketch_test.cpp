@@ -21,6 +21,10 @@
 #include <fstream>
 #include <sstream>
 #include <array>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <memory>
 
 #include <catch2/catch.hpp>
 
@@ -134,6 +138,341 @@ TEST_CASE("aod sketch: bytes serialize deserialize - estimation mode", "[tuple_s
   }
 }
 
+TEST_CASE("aod sketch: dense keys layout", "[tuple_sketch]") {
+  using dense_sketch = update_array_tuple_sketch<array<double>, default_array_tuple_update_policy<array<double>>,
+      std::allocator<double>, theta_update_sketch_dense_keys_base>;
+  auto update_sketch1 = update_array_of_doubles_sketch::builder(3).build();
+  auto update_sketch2 = dense_sketch::builder(3).build();
+  std::vector<double> a = {1, 2, 3};
+  for (int i = 0; i < 20000; ++i) {
+    update_sketch1.update(i % 10000, a);
+    update_sketch2.update(i % 10000, a);
+  }
+  REQUIRE(update_sketch2.get_num_values() == 3);
+  REQUIRE(update_sketch2.is_estimation_mode());
+  REQUIRE(update_sketch1.compact().serialize() == update_sketch2.compact().serialize());
+}
+
+TEST_CASE("aod sketch: update batch", "[tuple_sketch]") {
+  const uint8_t num_values = 5;
+  const size_t n = 20000;
+  std::vector<uint64_t> keys(n);
+  std::vector<std::string> str_keys(n);
+  std::vector<double> values(n * num_values);
+  for (size_t i = 0; i < n; ++i) {
+    keys[i] = i % 15000; // some duplicates
+    str_keys[i] = std::to_string(keys[i]);
+    for (uint8_t j = 0; j < num_values; ++j) values[i * num_values + j] = static_cast<double>(i + j);
+  }
+  str_keys[0] = ""; // ignored
+  std::vector<double> double_keys(n);
+  for (size_t i = 0; i < n; ++i) double_keys[i] = static_cast<double>(keys[i]) + 0.5;
+  double_keys[1] = -0.0; // same as 0.0
+  double_keys[2] = 0.0;
+
+  auto sketch1 = update_array_of_doubles_sketch::builder(num_values).build();
+  auto sketch2 = update_array_of_doubles_sketch::builder(num_values).build();
+  auto sketch3 = update_array_of_doubles_sketch::builder(num_values).build();
+  auto sketch4 = update_array_of_doubles_sketch::builder(num_values).build();
+  auto sketch5 = update_array_of_doubles_sketch::builder(num_values).build();
+  auto sketch7 = update_array_of_doubles_sketch::builder(num_values).build();
+  auto sketch8 = update_array_of_doubles_sketch::builder(num_values).build();
+  for (size_t i = 0; i < n; ++i) {
+    sketch1.update(keys[i], values.data() + i * num_values);
+    sketch3.update(str_keys[i], values.data() + i * num_values);
+    sketch7.update(double_keys[i], values.data() + i * num_values);
+  }
+  sketch2.update_batch(keys.data(), values.data(), n);
+  sketch4.update_batch(str_keys.data(), values.data(), n);
+  sketch5.update_batch(reinterpret_cast<const int64_t*>(keys.data()), values.data(), n);
+  sketch8.update_batch(double_keys.data(), values.data(), n);
+  REQUIRE(sketch2.is_estimation_mode());
+  REQUIRE(sketch1.compact().serialize() == sketch2.compact().serialize());
+  REQUIRE(sketch1.compact().serialize() == sketch5.compact().serialize());
+  REQUIRE(sketch3.compact().serialize() == sketch4.compact().serialize());
+  REQUIRE(sketch7.compact().serialize() == sketch8.compact().serialize());
+
+  auto sketch6 = update_array_of_doubles_sketch::builder(num_values).build();
+  sketch6.update_batch(keys.data(), values.data(), 0);
+  REQUIRE(sketch6.is_empty());
+}
+
+TEST_CASE("aod sketch: min and max policies", "[tuple_sketch]") {
+  const uint8_t num_values = 3;
+  auto min_sketch = update_array_tuple_sketch<array<double>, min_array_of_doubles_update_policy>::builder(
+      min_array_of_doubles_update_policy(num_values)).build();
+  auto max_sketch = update_array_tuple_sketch<array<double>, max_array_of_doubles_update_policy>::builder(
+      max_array_of_doubles_update_policy(num_values)).build();
+  std::vector<double> a = {1, -2, 3};
+  double b[3] = {-1, 2, -3};
+  min_sketch.update(1, a);
+  min_sketch.update(1, b);
+  max_sketch.update(1, a);
+  max_sketch.update(1, b);
+  REQUIRE(min_sketch.get_num_retained() == 1);
+  for (const auto& entry: min_sketch) {
+    REQUIRE(entry.second[0] == -1);
+    REQUIRE(entry.second[1] == -2);
+    REQUIRE(entry.second[2] == -3);
+  }
+  for (const auto& entry: max_sketch) {
+    REQUIRE(entry.second[0] == 1);
+    REQUIRE(entry.second[1] == 2);
+    REQUIRE(entry.second[2] == 3);
+  }
+
+  auto sketch1 = update_array_of_doubles_sketch::builder(num_values).build();
+  sketch1.update(1, a);
+  sketch1.update(2, a);
+  auto sketch2 = update_array_of_doubles_sketch::builder(num_values).build();
+  sketch2.update(1, b);
+
+  auto min_union = array_tuple_union<array<double>, min_array_of_doubles_union_policy>::builder(
+      min_array_of_doubles_union_policy(num_values)).build();
+  min_union.update(sketch1);
+  min_union.update(sketch2);
+  auto min_result = min_union.get_result();
+  REQUIRE(min_result.get_num_retained() == 2);
+  REQUIRE(min_result.get_num_values() == num_values);
+
+  array_of_doubles_intersection<max_array_of_doubles_union_policy> max_intersection(DEFAULT_SEED,
+      max_array_of_doubles_union_policy(num_values));
+  max_intersection.update(sketch1);
+  max_intersection.update(sketch2);
+  auto max_result = max_intersection.get_result();
+  REQUIRE(max_result.get_num_retained() == 1);
+  for (const auto& entry: max_result) {
+    REQUIRE(entry.second[0] == 1);
+    REQUIRE(entry.second[1] == 2);
+    REQUIRE(entry.second[2] == 3);
+  }
+
+  const uint64_t hash1 = sketch2.begin()->first;
+  for (const auto& entry: min_result) {
+    if (entry.first == hash1) {
+      REQUIRE(entry.second[0] == -1);
+      REQUIRE(entry.second[1] == -2);
+      REQUIRE(entry.second[2] == -3);
+    } else {
+      REQUIRE(entry.second[0] == 1);
+      REQUIRE(entry.second[1] == -2);
+      REQUIRE(entry.second[2] == 3);
+    }
+  }
+}
+
+TEST_CASE("aod sketch: array ops", "[tuple_sketch]") {
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  // odd size to cover the tail
+  double dst[5] = {1, 2, nan, 4, 5};
+  const double src[5] = {2, 1, 3, nan, 0};
+
+  double sum[5];
+  std::copy(dst, dst + 5, sum);
+  array_tuple_ops::add(sum, src, 5);
+  REQUIRE(sum[0] == 3);
+  REQUIRE(sum[4] == 5);
+
+  double min[5];
+  std::copy(dst, dst + 5, min);
+  array_tuple_ops::min(min, src, 5);
+  double max[5];
+  std::copy(dst, dst + 5, max);
+  array_tuple_ops::max(max, src, 5);
+  for (int i = 0; i < 5; ++i) {
+    const double expected_min = std::min(dst[i], src[i]);
+    const double expected_max = std::max(dst[i], src[i]);
+    if (std::isnan(expected_min)) REQUIRE(std::isnan(min[i])); else REQUIRE(min[i] == expected_min);
+    if (std::isnan(expected_max)) REQUIRE(std::isnan(max[i])); else REQUIRE(max[i] == expected_max);
+  }
+
+  float fdst[7] = {1, 2, 3, 4, 5, 6, 7};
+  const float fsrc[7] = {7, 6, 5, 4, 3, 2, 1};
+  array_tuple_ops::max(fdst, fsrc, 7);
+  for (int i = 0; i < 7; ++i) REQUIRE(fdst[i] == std::max(7 - i, i + 1));
+}
+
+TEST_CASE("aod sketch: wrap", "[tuple_sketch]") {
+  { // empty
+    auto bytes = update_array_of_doubles_sketch::builder().build().compact().serialize();
+    auto wrapped = wrapped_compact_array_of_doubles_sketch::wrap(bytes.data(), bytes.size());
+    REQUIRE(wrapped.is_empty());
+    REQUIRE_FALSE(wrapped.is_estimation_mode());
+    REQUIRE(wrapped.get_num_retained() == 0);
+    REQUIRE(wrapped.get_estimate() == 0.0);
+    REQUIRE(wrapped.begin() == wrapped.end());
+  }
+
+  auto update_sketch = update_array_of_doubles_sketch::builder(3).build();
+  std::vector<double> a = {1, 2, 3};
+  for (int i = 0; i < 8192; ++i) update_sketch.update(i, a);
+  auto compact_sketch = update_sketch.compact();
+  auto bytes = compact_sketch.serialize();
+  auto wrapped = wrapped_compact_array_of_doubles_sketch::wrap(bytes.data(), bytes.size());
+  REQUIRE_FALSE(wrapped.is_empty());
+  REQUIRE(wrapped.is_ordered());
+  REQUIRE(wrapped.is_estimation_mode());
+  REQUIRE(wrapped.get_num_values() == 3);
+  REQUIRE(wrapped.get_num_retained() == compact_sketch.get_num_retained());
+  REQUIRE(wrapped.get_seed_hash() == compact_sketch.get_seed_hash());
+  REQUIRE(wrapped.get_theta64() == compact_sketch.get_theta64());
+  REQUIRE(wrapped.get_estimate() == compact_sketch.get_estimate());
+  REQUIRE(wrapped.get_lower_bound(1) == compact_sketch.get_lower_bound(1));
+  REQUIRE(wrapped.get_upper_bound(2) == compact_sketch.get_upper_bound(2));
+  auto it = compact_sketch.begin();
+  for (const auto& entry: wrapped) {
+    REQUIRE(entry.first == it->first);
+    REQUIRE(entry.second.size() == 3);
+    for (uint8_t i = 0; i < 3; ++i) REQUIRE(entry.second[i] == it->second[i]);
+    // values are not copied
+    REQUIRE(reinterpret_cast<const uint8_t*>(entry.second.data()) >= bytes.data());
+    REQUIRE(reinterpret_cast<const uint8_t*>(entry.second.data()) < bytes.data() + bytes.size());
+    ++it;
+  }
+  REQUIRE(it == compact_sketch.end());
+
+  // conversion to compact sketch
+  compact_array_of_doubles_sketch copy(wrapped);
+  REQUIRE(copy.get_num_values() == 3);
+  REQUIRE(copy.serialize() == bytes);
+
+  REQUIRE_THROWS_AS(wrapped_compact_array_of_doubles_sketch::wrap(bytes.data(), bytes.size() - 1), std::out_of_range);
+  REQUIRE_THROWS_AS(wrapped_compact_array_of_doubles_sketch::wrap(bytes.data(), bytes.size(), 1), std::invalid_argument);
+  std::vector<uint8_t> misaligned(bytes.size() + 1);
+  std::copy(bytes.begin(), bytes.end(), misaligned.begin() + 1);
+  REQUIRE_THROWS_AS(wrapped_compact_array_of_doubles_sketch::wrap(misaligned.data() + 1, bytes.size()), std::invalid_argument);
+}
+
+TEST_CASE("aod sketch: set operations with wrapped sketches", "[tuple_sketch]") {
+  std::vector<double> a = {1, 2};
+  auto update_sketch1 = update_array_of_doubles_sketch::builder(2).build();
+  for (int i = 0; i < 10000; ++i) update_sketch1.update(i, a);
+  auto update_sketch2 = update_array_of_doubles_sketch::builder(2).build();
+  for (int i = 5000; i < 15000; ++i) update_sketch2.update(i, a);
+  auto bytes1 = update_sketch1.compact().serialize();
+  auto bytes2 = update_sketch2.compact(false).serialize();
+  auto compact1 = compact_array_of_doubles_sketch::deserialize(bytes1.data(), bytes1.size());
+  auto compact2 = compact_array_of_doubles_sketch::deserialize(bytes2.data(), bytes2.size());
+  auto wrapped1 = wrapped_compact_array_of_doubles_sketch::wrap(bytes1.data(), bytes1.size());
+  auto wrapped2 = wrapped_compact_array_of_doubles_sketch::wrap(bytes2.data(), bytes2.size());
+  REQUIRE_FALSE(wrapped2.is_ordered());
+
+  { // union
+    auto u1 = array_of_doubles_union::builder(default_array_of_doubles_union_policy(2)).build();
+    u1.update(compact1);
+    u1.update(compact2);
+    auto u2 = array_of_doubles_union::builder(default_array_of_doubles_union_policy(2)).build();
+    u2.update(wrapped1);
+    u2.update(wrapped2);
+    REQUIRE(u1.get_result().serialize() == u2.get_result().serialize());
+  }
+
+  { // intersection
+    array_of_doubles_intersection<default_array_of_doubles_union_policy> i1(DEFAULT_SEED, default_array_of_doubles_union_policy(2));
+    i1.update(compact1);
+    i1.update(compact2);
+    array_of_doubles_intersection<default_array_of_doubles_union_policy> i2(DEFAULT_SEED, default_array_of_doubles_union_policy(2));
+    i2.update(wrapped1);
+    i2.update(wrapped2);
+    REQUIRE(i1.get_result().serialize() == i2.get_result().serialize());
+    // unordered first
+    array_of_doubles_intersection<default_array_of_doubles_union_policy> i3(DEFAULT_SEED, default_array_of_doubles_union_policy(2));
+    i3.update(wrapped2);
+    i3.update(wrapped1);
+    REQUIRE(i1.get_result().serialize() == i3.get_result().serialize());
+  }
+
+  { // a-not-b
+    array_of_doubles_a_not_b a_not_b;
+    REQUIRE(a_not_b.compute(compact1, compact2).serialize() == a_not_b.compute(wrapped1, wrapped2).serialize());
+    REQUIRE(a_not_b.compute(compact2, compact1).serialize() == a_not_b.compute(wrapped2, wrapped1).serialize());
+    auto empty_bytes = update_array_of_doubles_sketch::builder(2).build().compact().serialize();
+    auto empty = wrapped_compact_array_of_doubles_sketch::wrap(empty_bytes.data(), empty_bytes.size());
+    REQUIRE(a_not_b.compute(wrapped1, empty).serialize() == bytes1);
+  }
+}
+
+namespace {
+
+// keeps the net allocated size
+long long tracking_allocator_total_bytes = 0;
+long long tracking_allocator_net_allocations = 0;
+
+template<typename T>
+class tracking_allocator {
+public:
+  using value_type = T;
+  tracking_allocator() = default;
+  template<typename U> tracking_allocator(const tracking_allocator<U>&) {}
+  T* allocate(size_t n) {
+    T* p = std::allocator<T>().allocate(n);
+    tracking_allocator_total_bytes += n * sizeof(T);
+    ++tracking_allocator_net_allocations;
+    return p;
+  }
+  void deallocate(T* p, size_t n) {
+    tracking_allocator_total_bytes -= n * sizeof(T);
+    --tracking_allocator_net_allocations;
+    std::allocator<T>().deallocate(p, n);
+  }
+};
+
+template<typename T, typename U>
+bool operator==(const tracking_allocator<T>&, const tracking_allocator<U>&) { return true; }
+template<typename T, typename U>
+bool operator!=(const tracking_allocator<T>&, const tracking_allocator<U>&) { return false; }
+
+} // namespace
+
+TEST_CASE("aod sketch: inline array storage", "[tuple_sketch]") {
+  using array_type = array<double, tracking_allocator<double>>;
+  tracking_allocator_total_bytes = 0;
+  tracking_allocator_net_allocations = 0;
+  {
+    array_type small(2, 1.0, tracking_allocator<double>());
+    array_type small_copy(small);
+    small_copy[1] = 2;
+    array_type small_moved(std::move(small_copy));
+    small = small_moved;
+    REQUIRE(small.size() == 2);
+    REQUIRE(small[0] == 1);
+    REQUIRE(small[1] == 2);
+    REQUIRE(tracking_allocator_total_bytes == 0);
+
+    array_type large(3, 1.0, tracking_allocator<double>());
+    REQUIRE(tracking_allocator_net_allocations == 1);
+    array_type large_copy(large);
+    large_copy[2] = 3;
+    REQUIRE(tracking_allocator_net_allocations == 2);
+    small = std::move(large_copy);
+    large_copy = large;
+    REQUIRE(small.size() == 3);
+    REQUIRE(small[2] == 3);
+    REQUIRE(large_copy.size() == 3);
+    REQUIRE(large_copy == large);
+  }
+  REQUIRE(tracking_allocator_total_bytes == 0);
+  REQUIRE(tracking_allocator_net_allocations == 0);
+
+  // only the hash table is allocated with 2 values
+  {
+    using policy_type = default_array_tuple_update_policy<array_type>;
+    auto sketch = update_array_tuple_sketch<array_type>::builder(policy_type(2, tracking_allocator<double>()), tracking_allocator<double>()).build();
+    double values[2] = {1, 2};
+    for (int i = 0; i < 10000; ++i) sketch.update(i, values);
+    REQUIRE(sketch.is_estimation_mode());
+    REQUIRE(tracking_allocator_net_allocations == 1);
+    auto compact = sketch.compact();
+    REQUIRE(tracking_allocator_net_allocations == 2);
+    auto bytes = compact.serialize();
+    auto deserialized = compact_array_tuple_sketch<array_type>::deserialize(bytes.data(), bytes.size(), DEFAULT_SEED, tracking_allocator<double>());
+    REQUIRE(tracking_allocator_net_allocations == 4); // bytes and entries, keys were freed
+    REQUIRE(deserialized.serialize() == bytes);
+  }
+  REQUIRE(tracking_allocator_total_bytes == 0);
+  REQUIRE(tracking_allocator_net_allocations == 0);
+}
+
 TEST_CASE("aod union: half overlap", "[tuple_sketch]") {
   std::vector<double> a = {1};
 
@@ -18,6 +18,7 @@
  */
 
 #include <iostream>
+#include <vector>
 
 #include <catch2/catch.hpp>
 
@@ -98,4 +99,19 @@ TEST_CASE("tuple jaccard: disjoint exact mode", "[tuple_sketch]") {
   REQUIRE(jc == std::array<double, 3>{0, 0, 0});
 }
 
+TEST_CASE("tuple jaccard: one to many", "[tuple_sketch]") {
+  auto query = update_tuple_sketch<float>::builder().set_lg_k(10).build();
+  for (int i = 0; i < 5000; ++i) query.update(i, 1.0f);
+  std::vector<compact_tuple_sketch<float>> sketches;
+  for (int i = 0; i < 10; ++i) {
+    auto sketch = update_tuple_sketch<float>::builder().set_lg_k(10).build();
+    for (int j = 0; j < 1000 * i; ++j) sketch.update(2500 + j, 1.0f);
+    sketches.push_back(sketch.compact(i % 2 == 0));
+  }
+  auto result = tuple_jaccard_similarity_float::jaccard_many(query, sketches.begin(), sketches.end(), DEFAULT_SEED, 2);
+  for (size_t i = 0; i < sketches.size(); ++i) {
+    REQUIRE(result[i] == tuple_jaccard_similarity_float::jaccard(query, sketches[i]));
+  }
+}
+
 } /* namespace datasketches */
@@ -371,4 +371,118 @@ TEST_CASE("filter", "[tuple_sketch]") {
   }
 }
 
+TEST_CASE("tuple sketch: update batch", "[tuple_sketch]") {
+  const size_t n = 50000;
+  std::vector<uint64_t> keys(n);
+  std::vector<double> double_keys(n);
+  std::vector<std::string> string_keys(n);
+  std::vector<float> updates(n);
+  for (size_t i = 0; i < n; ++i) {
+    keys[i] = i % 30000; // some duplicates
+    double_keys[i] = static_cast<double>(keys[i]);
+    string_keys[i] = std::to_string(keys[i]);
+    updates[i] = static_cast<float>(i);
+  }
+  double_keys[1] = -0.0; // same as 0.0
+  string_keys[0] = ""; // ignored
+
+  auto check_batch = [](update_tuple_sketch<float>& expected, update_tuple_sketch<float>& actual) {
+    REQUIRE(actual.is_estimation_mode());
+    REQUIRE(expected.get_theta64() == actual.get_theta64());
+    auto compact_expected = expected.compact();
+    auto compact_actual = actual.compact();
+    REQUIRE(compact_expected.get_num_retained() == compact_actual.get_num_retained());
+    auto it = compact_actual.begin();
+    for (const auto& entry: compact_expected) {
+      REQUIRE(entry.first == it->first);
+      REQUIRE(entry.second == it->second);
+      ++it;
+    }
+  };
+
+  {
+    auto sketch1 = update_tuple_sketch<float>::builder().build();
+    auto sketch2 = update_tuple_sketch<float>::builder().build();
+    auto sketch3 = update_tuple_sketch<float>::builder().build();
+    for (size_t i = 0; i < n; ++i) sketch1.update(keys[i], updates[i]);
+    sketch2.update_batch(keys.data(), updates.data(), n);
+    sketch3.update_batch(reinterpret_cast<const int64_t*>(keys.data()), updates.data(), n);
+    check_batch(sketch1, sketch2);
+    check_batch(sketch1, sketch3);
+  }
+  {
+    auto sketch1 = update_tuple_sketch<float>::builder().build();
+    auto sketch2 = update_tuple_sketch<float>::builder().build();
+    for (size_t i = 0; i < n; ++i) sketch1.update(double_keys[i], updates[i]);
+    sketch2.update_batch(double_keys.data(), updates.data(), n);
+    check_batch(sketch1, sketch2);
+  }
+  {
+    auto sketch1 = update_tuple_sketch<float>::builder().build();
+    auto sketch2 = update_tuple_sketch<float>::builder().build();
+    for (size_t i = 0; i < n; ++i) sketch1.update(string_keys[i], updates[i]);
+    sketch2.update_batch(string_keys.data(), updates.data(), n);
+    check_batch(sketch1, sketch2);
+  }
+  {
+    auto sketch = update_tuple_sketch<float>::builder().build();
+    sketch.update_batch(keys.data(), updates.data(), 0);
+    REQUIRE(sketch.is_empty());
+  }
+}
+
+TEST_CASE("tuple sketch: dense keys layout", "[tuple_sketch]") {
+  using sketch_type = update_tuple_sketch<float, float, default_tuple_update_policy<float, float>, std::allocator<float>,
+      theta_update_sketch_dense_keys_base>;
+  auto sketch1 = update_tuple_sketch<float>::builder().set_lg_k(10).build();
+  auto sketch2 = sketch_type::builder().set_lg_k(10).build();
+
+  auto check_same = [&sketch1, &sketch2]() {
+    REQUIRE(sketch1.is_empty() == sketch2.is_empty());
+    REQUIRE(sketch1.get_theta64() == sketch2.get_theta64());
+    REQUIRE(sketch1.get_num_retained() == sketch2.get_num_retained());
+    auto compact1 = sketch1.compact();
+    auto compact2 = sketch2.compact();
+    auto it = compact2.begin();
+    for (const auto& entry: compact1) {
+      REQUIRE(entry.first == it->first);
+      REQUIRE(entry.second == it->second);
+      ++it;
+    }
+    REQUIRE(it == compact2.end());
+  };
+
+  // exact mode with resizing, every key updated twice
+  for (int i = 0; i < 1000; ++i) {
+    sketch1.update(i, 1.0f);
+    sketch2.update(i, 1.0f);
+  }
+  for (int i = 0; i < 1000; ++i) {
+    sketch1.update(i, static_cast<float>(i));
+    sketch2.update(i, static_cast<float>(i));
+  }
+  REQUIRE_FALSE(sketch2.is_estimation_mode());
+  check_same();
+
+  // estimation mode with rebuilds
+  for (int i = 0; i < 100000; ++i) {
+    sketch1.update(i, 1.0f);
+    sketch2.update(i, 1.0f);
+  }
+  REQUIRE(sketch2.is_estimation_mode());
+  check_same();
+
+  sketch1.trim();
+  sketch2.trim();
+  check_same();
+
+  sketch1.reset();
+  sketch2.reset();
+  REQUIRE(sketch2.is_empty());
+  check_same();
+  sketch1.update(1, 1.0f);
+  sketch2.update(1, 1.0f);
+  check_same();
+}
+
 } /* namespace datasketches */
@@ -17,7 +17,9 @@
  * under the License.
  */
 
+#include <cstring>
 #include <iostream>
+#include <sstream>
 #include <stdexcept>
 
 #include <catch2/catch.hpp>
@@ -189,4 +191,66 @@ TEST_CASE("tuple_union float: full overlap with theta sketch", "[tuple union]")
   }
 }
 
+TEST_CASE("tuple_union float: serialize and deserialize state", "[tuple union]") {
+  auto u1 = tuple_union<float>::builder().set_lg_k(10).build();
+  auto update_sketch1 = update_tuple_sketch<float>::builder().set_lg_k(10).build();
+  for (int i = 0; i < 10000; ++i) update_sketch1.update(i, 1.0f);
+  u1.update(update_sketch1);
+  auto bytes = u1.serialize();
+  std::stringstream s(std::ios::in | std::ios::out | std::ios::binary);
+  u1.serialize(s);
+  REQUIRE(static_cast<size_t>(s.tellp()) == bytes.size());
+
+  auto u2 = tuple_union<float>::deserialize(bytes.data(), bytes.size());
+  auto u3 = tuple_union<float>::deserialize(s);
+  REQUIRE(u2.get_result().serialize() == u1.get_result().serialize());
+  REQUIRE(u3.get_result().serialize() == u1.get_result().serialize());
+
+  // continue accumulating, summaries of overlapping keys are combined
+  auto update_sketch2 = update_tuple_sketch<float>::builder().set_lg_k(10).build();
+  for (int i = 0; i < 10000; ++i) update_sketch2.update(i, 2.0f);
+  u1.update(update_sketch2);
+  u2.update(update_sketch2);
+  auto result = u2.get_result();
+  REQUIRE(result.serialize() == u1.get_result().serialize());
+  for (const auto& entry: result) REQUIRE(entry.second == 3.0f);
+
+  REQUIRE_THROWS_AS(tuple_union<float>::deserialize(bytes.data(), bytes.size(), 123), std::invalid_argument);
+  REQUIRE_THROWS_AS(tuple_union<float>::deserialize(bytes.data(), bytes.size() - 1), std::out_of_range);
+
+  // the state and compact sketches share the family ID, but must not be confused
+  REQUIRE_THROWS_AS(compact_tuple_sketch<float>::deserialize(bytes.data(), bytes.size()), std::invalid_argument);
+  auto compact_bytes = update_sketch1.compact().serialize();
+  REQUIRE_THROWS_AS(tuple_union<float>::deserialize(compact_bytes.data(), compact_bytes.size()), std::invalid_argument);
+}
+
+TEST_CASE("tuple_union float: deserialize invalid state", "[tuple union]") {
+  auto u = tuple_union<float>::builder().set_lg_k(10).build();
+  auto update_sketch = update_tuple_sketch<float>::builder().set_lg_k(10).build();
+  for (int i = 0; i < 100; ++i) update_sketch.update(i, 1.0f);
+  u.update(update_sketch);
+  const auto bytes = u.serialize();
+
+  auto check_throws = [&bytes](size_t offset, const void* value, size_t size) {
+    auto corrupted = bytes;
+    std::memcpy(corrupted.data() + offset, value, size);
+    REQUIRE_THROWS_AS(tuple_union<float>::deserialize(corrupted.data(), corrupted.size()), std::invalid_argument);
+  };
+
+  const uint8_t lg_cur_size = 0;
+  check_throws(4, &lg_cur_size, sizeof(lg_cur_size));
+  auto corrupted = bytes;
+  corrupted[4] = 10;
+  corrupted[12] = resize_factor::X1; // requires lg_cur_size == lg_k + 1
+  REQUIRE_THROWS_AS(tuple_union<float>::deserialize(corrupted.data(), corrupted.size()), std::invalid_argument);
+  const float p = 0;
+  check_throws(16, &p, sizeof(p));
+  const uint64_t zero_theta = 0;
+  check_throws(24, &zero_theta, sizeof(zero_theta));
+  check_throws(32, &zero_theta, sizeof(zero_theta));
+  const uint64_t big_theta = theta_constants::MAX_THETA + 1;
+  check_throws(24, &big_theta, sizeof(big_theta));
+  check_throws(32, &big_theta, sizeof(big_theta));
+}
+
 } /* namespace datasketches */